@@ -0,0 +1,301 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define MAX_RESULTS	4096
+#define MAX_NAME	64
+
+typedef struct
+{
+    char	name[MAX_NAME];
+    char	param[MAX_NAME];
+    char	metric[MAX_NAME];
+    double	value;
+} result_t;
+
+volatile uint32 bench_sink;
+
+static const char* suite = "";
+static int quick = 0;
+static int json = 0;
+static const char* baseline = NULL;
+static const char* baseline_suite = NULL;
+static double threshold = 10.0;
+
+static result_t results[MAX_RESULTS];
+static int result_count = 0;
+
+void benchInit( int argc, char** argv, const char* name )
+{
+    int i;
+
+    suite = name;
+    baseline_suite = name;
+
+    for ( i = 1; i < argc; i++ )
+    {
+        if ( strcmp( argv[i], "--quick" ) == 0 )
+            quick = 1;
+        else if ( strcmp( argv[i], "--json" ) == 0 )
+            json = 1;
+        else if ( strcmp( argv[i], "--baseline" ) == 0 && i + 1 < argc )
+            baseline = argv[++i];
+        else if ( strcmp( argv[i], "--baseline-suite" ) == 0 && i + 1 < argc )
+            baseline_suite = argv[++i];
+        else if ( strcmp( argv[i], "--threshold" ) == 0 && i + 1 < argc )
+            threshold = atof( argv[++i] );
+        else
+        {
+            fprintf( stderr, "usage: %s [--quick] [--json] [--baseline FILE] [--baseline-suite NAME] [--threshold PCT]\n", argv[0] );
+            exit( 2 );
+        }
+    }
+}
+
+int benchQuick( void )
+{
+    return quick;
+}
+
+uint64 benchNow( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (uint64)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+void benchRecord( const char* name, const char* param, const char* metric, double value )
+{
+    result_t* r;
+
+    if ( result_count == MAX_RESULTS )
+    {
+        fprintf( stderr, "%s: too many results\n", suite );
+        exit( 2 );
+    }
+
+    r = &results[result_count++];
+    snprintf( r->name, MAX_NAME, "%s", name );
+    snprintf( r->param, MAX_NAME, "%s", param );
+    snprintf( r->metric, MAX_NAME, "%s", metric );
+    r->value = value;
+}
+
+double benchRun( const char* name, const char* param, benchfn_t fn, void* arg, uint32 ops_per_iteration )
+{
+    const uint64 min_time = ( quick ? 1000000u : 20000000u );
+    const int runs = ( quick ? 1 : 5 );
+    uint32 iterations = 1;
+    uint64 best = 0, start, t;
+    double ns;
+    int i;
+
+    // Find an iteration count that takes long enough to time reliably
+    for ( ;; )
+    {
+        start = benchNow();
+        (*fn)( arg, iterations );
+        t = benchNow() - start;
+
+        if ( t >= min_time || iterations >= 0x40000000u )
+            break;
+        iterations *= 2;
+    }
+
+    best = t;
+    for ( i = 1; i < runs; i++ )
+    {
+        start = benchNow();
+        (*fn)( arg, iterations );
+        t = benchNow() - start;
+
+        if ( t < best )
+            best = t;
+    }
+
+    ns = (double)best / ( (double)iterations * ops_per_iteration );
+
+    benchRecord( name, param, "ns_per_op", ns );
+    benchRecord( name, param, "ops_per_sec", ( ns > 0.0 ? 1e9 / ns : 0.0 ) );
+    return ns;
+}
+
+#ifdef __linux__
+// Opens a counter for this thread, user space only. Returns -1 if the kernel
+// or the container doesn't allow it.
+static int open_counter( uint32 type, uint64 config )
+{
+    struct perf_event_attr attr;
+
+    memset( &attr, 0, sizeof(attr) );
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall( SYS_perf_event_open, &attr, 0, -1, -1, 0 );
+}
+#endif
+
+int benchCacheMisses( const char* name, const char* param, benchfn_t fn, void* arg, uint32 iterations, uint32 ops_per_iteration )
+{
+#ifdef __linux__
+    static const struct
+    {
+        const char*	metric;
+        uint32		type;
+        uint64		config;
+    } counters[] =
+    {
+        { "l1d_misses_per_op", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ) },
+        { "llc_misses_per_op", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    };
+    int recorded = 0;
+    uint32 i;
+
+    for ( i = 0; i < sizeof(counters) / sizeof(counters[0]); i++ )
+    {
+        const int fd = open_counter( counters[i].type, counters[i].config );
+        uint64 count;
+
+        if ( fd < 0 )
+            continue;
+
+        // Once untimed so the data is in the state a timed run would see
+        (*fn)( arg, 1 );
+
+        ioctl( fd, PERF_EVENT_IOC_RESET, 0 );
+        ioctl( fd, PERF_EVENT_IOC_ENABLE, 0 );
+        (*fn)( arg, iterations );
+        ioctl( fd, PERF_EVENT_IOC_DISABLE, 0 );
+
+        if ( read( fd, &count, sizeof(count) ) == sizeof(count) )
+        {
+            benchRecord( name, param, counters[i].metric, (double)count / ( (double)iterations * ops_per_iteration ) );
+            recorded = 1;
+        }
+
+        close( fd );
+    }
+
+    return recorded;
+#else
+    (void)name; (void)param; (void)fn; (void)arg; (void)iterations; (void)ops_per_iteration;
+    return 0;
+#endif
+}
+
+// Finds a ns_per_op row in the baseline. Returns 0 if it's not there.
+static int baseline_value( FILE* f, const result_t* r, double* value )
+{
+    char line[4 * MAX_NAME + 64];
+    char s[MAX_NAME], n[MAX_NAME], p[MAX_NAME], m[MAX_NAME];
+    double v;
+
+    rewind( f );
+    while ( fgets( line, sizeof(line), f ) != NULL )
+    {
+        if ( sscanf( line, "%63[^,],%63[^,],%63[^,],%63[^,],%lf", s, n, p, m, &v ) != 5 )
+            continue;
+
+        if ( strcmp( s, baseline_suite ) == 0 && strcmp( n, r->name ) == 0 &&
+                strcmp( p, r->param ) == 0 && strcmp( m, r->metric ) == 0 )
+        {
+            *value = v;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int compare_baseline( void )
+{
+    FILE* f = fopen( baseline, "r" );
+    const int count = result_count;
+    int regressions = 0;
+    double base;
+    int i;
+
+    if ( f == NULL )
+    {
+        fprintf( stderr, "%s: can't open baseline %s\n", suite, baseline );
+        return 2;
+    }
+
+    // Only the rows measured by the benchmark, not the ones added here
+    for ( i = 0; i < count; i++ )
+    {
+        const result_t* r = &results[i];
+
+        if ( strcmp( r->metric, "ns_per_op" ) != 0 || !baseline_value( f, r, &base ) )
+            continue;
+
+        benchRecord( r->name, r->param, "baseline_pct", ( r->value / base - 1.0 ) * 100.0 );
+
+        if ( r->value > base * ( 1.0 + threshold / 100.0 ) )
+        {
+            fprintf( stderr, "%s: %s %s: %.2f ns/op, baseline %.2f ns/op (+%.1f%%)\n",
+                suite, r->name, r->param, r->value, base, ( r->value / base - 1.0 ) * 100.0 );
+            regressions++;
+        }
+    }
+
+    fclose( f );
+    return ( regressions != 0 );
+}
+
+int benchFinish( void )
+{
+    // Compared first, so the baseline_pct rows are part of the output
+    const int status = ( baseline != NULL ? compare_baseline() : 0 );
+    int i;
+
+    if ( json )
+    {
+        printf( "[\n" );
+        for ( i = 0; i < result_count; i++ )
+        {
+            printf( "  { \"suite\": \"%s\", \"name\": \"%s\", \"param\": \"%s\", \"metric\": \"%s\", \"value\": %.6g }%s\n",
+                suite, results[i].name, results[i].param, results[i].metric, results[i].value,
+                ( i + 1 < result_count ? "," : "" ) );
+        }
+        printf( "]\n" );
+    }
+    else
+    {
+        printf( "suite,name,param,metric,value\n" );
+        for ( i = 0; i < result_count; i++ )
+            printf( "%s,%s,%s,%s,%.6g\n", suite, results[i].name, results[i].param, results[i].metric, results[i].value );
+    }
+
+    return status;
+}
@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Host benchmark harness.
+
+ Every benchmark program measures a set of operations and reports one row
+ per measurement:
+
+    suite,name,param,metric,value
+
+ as CSV (the default) or JSON (--json). Timed operations report ns_per_op
+ and ops_per_sec, and benchmarks can add metrics of their own.
+
+ Options:
+    --quick             Short runs, for checking that everything still works
+    --json              JSON output instead of CSV
+    --baseline FILE     CSV output of an earlier run to compare against
+    --baseline-suite S  Compare against the rows of suite S instead of our own
+    --threshold PCT     Allowed ns_per_op increase over the baseline (default 10)
+
+ With --baseline, every ns_per_op that's more than PCT percent slower than
+ the same row of the baseline is listed on stderr and the program exits
+ with 1, so a build can fail on slowdowns. Every compared row also gets a
+ baseline_pct metric, the change in ns_per_op in percent (negative is
+ faster).
+*/
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <kos.h>
+
+// Runs iterations operations
+typedef void (*benchfn_t)( void* arg, uint32 iterations );
+
+// Written by benchmarks so the compiler can't drop the work
+extern volatile uint32 bench_sink;
+
+// Parses the options above. suite names the program in the output.
+void benchInit( int argc, char** argv, const char* suite );
+
+// Returns 1 if --quick was given
+int benchQuick( void );
+
+// Monotonic time in nanoseconds
+uint64 benchNow( void );
+
+// Times fn, taking the fastest of a few runs, and records ns_per_op and
+// ops_per_sec. Each iteration counts as ops_per_iteration operations.
+// Returns ns per operation.
+double benchRun( const char* name, const char* param, benchfn_t fn, void* arg, uint32 ops_per_iteration );
+
+// Runs fn for the given number of iterations under the CPU's cache miss
+// counters and records l1d_misses_per_op and llc_misses_per_op. Returns 0,
+// recording nothing, where the counters aren't available (not Linux, or
+// perf events not allowed).
+int benchCacheMisses( const char* name, const char* param, benchfn_t fn, void* arg, uint32 iterations, uint32 ops_per_iteration );
+
+// Records a measurement made by the benchmark itself
+void benchRecord( const char* name, const char* param, const char* metric, double value );
+
+// Writes the results, compares them to the baseline and returns the exit code.
+int benchFinish( void );
+
+#endif // __BENCH_H__
@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Sprite batch benchmark: sprites/sec through shSpriteBatch with 1, 8 and
+// 64 textures. "sorted" draws each texture's sprites together, so only the
+// texture changes send headers. "mixed" changes texture on every sprite.
+
+#include <stdio.h>
+#include "bench.h"
+#include "shbatch.h"
+
+#define SPRITES		4096
+#define MAX_TEXTURES	64
+
+typedef struct
+{
+    shemitter_t		em;
+    shspritebatch_t	batch;
+    uint32		textures;
+    int			mixed;
+    uint32		headers;	// Headers sent in the last pass
+} bench_arg_t;
+
+static uint8 vram[1 << 20] __attribute__((aligned(32)));
+static texture_t textures[MAX_TEXTURES];
+static shtexturedesc_t descs[MAX_TEXTURES];
+static shsprite_t sprites[SPRITES];
+
+// Header and sprite words for a pass, with room for a header per sprite
+static uint32 out[SPRITES * 24] __attribute__((aligned(32)));
+
+static void setup( void )
+{
+    int i;
+
+    for ( i = 0; i < MAX_TEXTURES; i++ )
+    {
+        textures[i] = (texture_t){ 64, 64, TEXFMT_ARGB4444, TEXFLAG_TWIDDLED, vram + i * 8192 };
+        shTextureDesc( &descs[i], &textures[i] );
+    }
+
+    for ( i = 0; i < SPRITES; i++ )
+    {
+        const float x = (float)( ( i * 16 ) % 640 ), y = (float)( ( i / 40 ) % 480 ), z = 1.0f;
+
+        sprites[i] = (shsprite_t){ x, y, z, x + 16, y, z, x + 16, y + 16, z, x, y + 16, 0, 0, 1, 0, 1, 1 };
+    }
+}
+
+// Draws every sprite once, as one batch
+static void run_batch( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    const uint32 per_texture = SPRITES / a->textures;
+    uint32 i, s;
+
+    for ( i = 0; i < iterations; i++ )
+    {
+        shSpriteBatchBegin( &a->batch, &a->em, out, 16, PVR_LIST_TR_POLY, &textures[0] );
+
+        for ( s = 0; s < SPRITES; s++ )
+        {
+            const uint32 t = ( a->mixed ? s % a->textures : s / per_texture );
+
+            shSpriteBatchTexture( &a->batch, &descs[t] );
+            shSpriteBatchDraw( &a->batch, &sprites[s], 1 );
+        }
+
+        bench_sink += shSpriteBatchEnd( &a->batch ) - out;
+        a->headers = a->batch.headers;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    static const uint32 counts[] = { 1, 8, 64 };
+    static bench_arg_t a;
+    char param[32];
+    uint32 c;
+
+    benchInit( argc, argv, "batch" );
+    setup();
+    shEmitterInit( &a.em );
+
+    for ( c = 0; c < sizeof(counts) / sizeof(counts[0]); c++ )
+    for ( a.mixed = 0; a.mixed <= 1; a.mixed++ )
+    {
+        // Mixing a single texture is the same as sorting it
+        if ( a.mixed && counts[c] == 1 )
+            continue;
+
+        a.textures = counts[c];
+        snprintf( param, sizeof(param), "%s_tex%u", ( a.mixed ? "mixed" : "sorted" ), (unsigned)counts[c] );
+
+        benchRun( "sprites", param, run_batch, &a, SPRITES );
+        benchRecord( "sprites", param, "headers_per_pass", a.headers );
+    }
+
+    return benchFinish();
+}
@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Material storage benchmark: the same materials kept as stripheader_t,
+// shcompact_t and in a material pool. Measures committing every material
+// and changing the state of all of them, with cache misses where the CPU
+// counters can be read.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "stripheader.h"
+#include "shmatpool.h"
+
+typedef struct
+{
+    stripheader_t*	hdrs;
+    shcompact_t*	compact;
+    shmatpool_t		pool;
+    void*		pool_mem;
+    uint32		count;
+    uint32		out[16] __attribute__((aligned(32)));
+} bench_arg_t;
+
+static uint8 vram[1 << 16] __attribute__((aligned(32)));
+static texture_t tex = { 256, 256, TEXFMT_RGB565, TEXFLAG_TWIDDLED, vram };
+
+// Types a compact header can hold, used in turn
+static const uint32 types[] = { 0, 1, 3, 4, 5, 6, 9, 11, 12, 15, 16 };
+
+#define TYPE_COUNT	( sizeof(types) / sizeof(types[0]) )
+
+static void setup( bench_arg_t* a, uint32 count )
+{
+    uint32 i;
+
+    a->count = count;
+    a->hdrs = (stripheader_t*)aligned_alloc( 32, count * sizeof(stripheader_t) );
+    a->compact = (shcompact_t*)aligned_alloc( 32, count * sizeof(shcompact_t) );
+    a->pool_mem = malloc( shMatPoolSize( count ) );
+
+    if ( a->hdrs == NULL || a->compact == NULL || a->pool_mem == NULL )
+    {
+        fprintf( stderr, "compact: out of memory\n" );
+        exit( 2 );
+    }
+
+    shMatPoolInit( &a->pool, a->pool_mem, count );
+
+    for ( i = 0; i < count; i++ )
+    {
+        const uint32 type = types[i % TYPE_COUNT];
+
+        shInit( &a->hdrs[i], type, PVR_LIST_OP_POLY, &tex, &tex );
+        shCompactFromHeader( &a->compact[i], &a->hdrs[i] );
+        shMatPoolAdd( &a->pool, &a->compact[i] );
+    }
+}
+
+static void teardown( bench_arg_t* a )
+{
+    free( a->hdrs );
+    free( a->compact );
+    free( a->pool_mem );
+}
+
+static SHSTATE cull_state( uint32 i )
+{
+    SHSTATE s = { 0 };
+
+    s.flags = SH_STATE_CULL;
+    s.cull = ( i & 1 ) ? SH_CULL_CW : SH_CULL_NONE;
+    return s;
+}
+
+/***** Benchmarks ************************************************************/
+
+static void run_commit_struct( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i, j;
+
+    for ( i = 0; i < iterations; i++ )
+    for ( j = 0; j < a->count; j++ )
+        bench_sink += shCommit( &a->hdrs[j], a->out );
+}
+
+static void run_commit_compact( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i, j;
+
+    for ( i = 0; i < iterations; i++ )
+    for ( j = 0; j < a->count; j++ )
+        bench_sink += shCompactCommit( &a->compact[j], a->out );
+}
+
+static void run_commit_pool( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i, j;
+
+    for ( i = 0; i < iterations; i++ )
+    for ( j = 0; j < a->count; j++ )
+        bench_sink += shMatPoolCommit( &a->pool, j, a->out );
+}
+
+static void run_state_struct( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i, j;
+
+    for ( i = 0; i < iterations; i++ )
+    {
+        const SHSTATE s = cull_state( i );
+
+        for ( j = 0; j < a->count; j++ )
+            bench_sink += shSetState( &a->hdrs[j], &s );
+    }
+}
+
+static void run_state_compact( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i, j;
+
+    for ( i = 0; i < iterations; i++ )
+    {
+        const SHSTATE s = cull_state( i );
+
+        for ( j = 0; j < a->count; j++ )
+            bench_sink += shCompactSetState( &a->compact[j], &s );
+    }
+}
+
+static void run_state_pool( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i;
+
+    for ( i = 0; i < iterations; i++ )
+    {
+        const SHSTATE s = cull_state( i );
+
+        bench_sink += shMatPoolSetState( &a->pool, 0, a->count, &s );
+    }
+}
+
+static const struct
+{
+    const char*	name;
+    benchfn_t	fn;
+} runs[] =
+{
+    { "commit_struct",	run_commit_struct },
+    { "commit_compact",	run_commit_compact },
+    { "commit_pool",	run_commit_pool },
+    { "state_struct",	run_state_struct },
+    { "state_compact",	run_state_compact },
+    { "state_pool",	run_state_pool },
+};
+
+int main( int argc, char** argv )
+{
+    static const uint32 counts[] = { 1024, 16384, 262144 };
+    static bench_arg_t a;
+    char param[32];
+    uint32 c, r;
+
+    benchInit( argc, argv, "compact" );
+
+    benchRecord( "struct", "", "bytes_per_material", sizeof(stripheader_t) );
+    benchRecord( "compact", "", "bytes_per_material", sizeof(shcompact_t) );
+    benchRecord( "pool", "", "bytes_per_material", shMatPoolSize( 1 ) );
+
+    for ( c = 0; c < sizeof(counts) / sizeof(counts[0]); c++ )
+    {
+        setup( &a, counts[c] );
+        snprintf( param, sizeof(param), "%u", (unsigned)counts[c] );
+
+        for ( r = 0; r < sizeof(runs) / sizeof(runs[0]); r++ )
+        {
+            benchRun( runs[r].name, param, runs[r].fn, &a, a.count );
+            benchCacheMisses( runs[r].name, param, runs[r].fn, &a, benchQuick() ? 1 : 8, a.count );
+        }
+
+        teardown( &a );
+    }
+
+    return benchFinish();
+}
@@ -0,0 +1,256 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Header path benchmark: shInit, every setter and shCommit for each type.
+//
+// Also built against a SH_NO_VALIDATION library as bench_header_novalidation.
+// The setter savings of that mode are the baseline_pct rows of
+//
+//   ./bench_header > header.csv
+//   ./bench_header_novalidation --baseline header.csv --baseline-suite header
+
+#include <stdio.h>
+#include "bench.h"
+#include "stripheader.h"
+#include "shdefs.h"
+
+typedef struct
+{
+    stripheader_t	hdr;
+    shblock_t		block;
+    uint32		type;
+    pvr_list_t		list;
+    const texture_t*	tex;
+    int			offset;		// Offset color enabled
+    uint32		out[16] __attribute__((aligned(32)));
+} bench_arg_t;
+
+static uint8 vram[1 << 20] __attribute__((aligned(32)));
+
+static texture_t tex_rgb = { 256, 256, TEXFMT_RGB565, TEXFLAG_TWIDDLED, vram };
+static texture_t tex_small = { 64, 32, TEXFMT_ARGB4444, TEXFLAG_TWIDDLED, vram + 65536 };
+static texture_t tex_pal = { 128, 128, TEXFMT_PAL8BPP, TEXFLAG_TWIDDLED, vram + 131072 };
+static shtexturedesc_t desc_rgb, desc_small;
+
+/***** Setters ***************************************************************/
+
+// Calls a setter with a value picked from i, so consecutive calls differ
+typedef int (*setter_t)( stripheader_t* hdr, uint32 i );
+
+static int set_enable( stripheader_t* hdr, uint32 i )		{ return ( i & 1 ) ? shEnable( hdr, SH_ALPHA ) : shDisable( hdr, SH_ALPHA ); }
+static int set_enable_2( stripheader_t* hdr, uint32 i )		{ return ( i & 1 ) ? shEnable( hdr, SH_ALPHA_2 ) : shDisable( hdr, SH_ALPHA_2 ); }
+static int set_modifier( stripheader_t* hdr, uint32 i )		{ return ( i & 1 ) ? shEnable( hdr, SH_AFFECTED_BY_MODIFIER ) : shDisable( hdr, SH_AFFECTED_BY_MODIFIER ); }
+static int set_cull( stripheader_t* hdr, uint32 i )		{ return shCullMode( hdr, ( i & 1 ) ? SH_CULL_CW : SH_CULL_NONE ); }
+static int set_depth( stripheader_t* hdr, uint32 i )		{ return shDepthFunc( hdr, ( i & 1 ) ? SH_DEPTH_ALWAYS : SH_DEPTH_GREATER_OR_EQUAL ); }
+static int set_clip( stripheader_t* hdr, uint32 i )		{ return shUserClip( hdr, ( i & 1 ) ? SH_CLIP_INSIDE : SH_CLIP_DISABLE ); }
+static int set_strip( stripheader_t* hdr, uint32 i )		{ return shStripLength( hdr, (SHSTRIPLENGTH)( i & 3 ) ); }
+static int set_fog( stripheader_t* hdr, uint32 i )		{ return shFogMode( hdr, ( i & 1 ) ? SH_FOG_LOOKUP_TABLE : SH_FOG_DISABLE ); }
+static int set_fog_2( stripheader_t* hdr, uint32 i )		{ return shFogMode2( hdr, ( i & 1 ) ? SH_FOG_LOOKUP_TABLE : SH_FOG_DISABLE ); }
+static int set_mipmap( stripheader_t* hdr, uint32 i )		{ return shMipmapAdjust( hdr, (SHMIPMAPADJUST)( 1 + ( i & 7 ) ) ); }
+static int set_mipmap_2( stripheader_t* hdr, uint32 i )		{ return shMipmapAdjust2( hdr, (SHMIPMAPADJUST)( 1 + ( i & 7 ) ) ); }
+static int set_blend( stripheader_t* hdr, uint32 i )		{ return shBlendFunc( hdr, ( i & 1 ) ? SH_BLEND_ONE : SH_BLEND_SRC_ALPHA, SH_BLEND_INVERSE_SRC_ALPHA ); }
+static int set_blend_2( stripheader_t* hdr, uint32 i )		{ return shBlendFunc2( hdr, ( i & 1 ) ? SH_BLEND_ONE : SH_BLEND_SRC_ALPHA, SH_BLEND_INVERSE_SRC_ALPHA ); }
+static int set_filter( stripheader_t* hdr, uint32 i )		{ return shTextureFilter( hdr, ( i & 1 ) ? SH_FILTER_BILINEAR : SH_FILTER_POINT ); }
+static int set_filter_2( stripheader_t* hdr, uint32 i )		{ return shTextureFilter2( hdr, ( i & 1 ) ? SH_FILTER_BILINEAR : SH_FILTER_POINT ); }
+static int set_palette( stripheader_t* hdr, uint32 i )		{ return shPalette( hdr, i & 3 ); }
+static int set_palette_2( stripheader_t* hdr, uint32 i )	{ return shPalette2( hdr, i & 3 ); }
+static int set_texture( stripheader_t* hdr, uint32 i )		{ return shTexture( hdr, ( i & 1 ) ? &tex_rgb : &tex_small ); }
+static int set_texture_2( stripheader_t* hdr, uint32 i )	{ return shTexture2( hdr, ( i & 1 ) ? &tex_rgb : &tex_small ); }
+static int set_desc( stripheader_t* hdr, uint32 i )		{ return shTextureFromDesc( hdr, ( i & 1 ) ? &desc_rgb : &desc_small ); }
+static int set_desc_2( stripheader_t* hdr, uint32 i )		{ return shTextureFromDesc2( hdr, ( i & 1 ) ? &desc_rgb : &desc_small ); }
+static int set_base( stripheader_t* hdr, uint32 i )		{ return shBaseColor( hdr, 1.0f, ( i & 1 ) ? 0.5f : 1.0f, 0.25f, 0.75f ); }
+static int set_base_2( stripheader_t* hdr, uint32 i )		{ return shBaseColor2( hdr, 1.0f, ( i & 1 ) ? 0.5f : 1.0f, 0.25f, 0.75f ); }
+static int set_offset( stripheader_t* hdr, uint32 i )		{ return shOffsetColor( hdr, 1.0f, ( i & 1 ) ? 0.5f : 1.0f, 0.25f, 0.75f ); }
+static int set_sprite( stripheader_t* hdr, uint32 i )		{ uint8 c[4] = { 255, (uint8)i, 128, 64 }; return shSpriteColor( hdr, c ); }
+static int set_sprite_f( stripheader_t* hdr, uint32 i )		{ return shSpriteColorf( hdr, 1.0f, ( i & 1 ) ? 0.5f : 1.0f, 0.25f, 0.75f ); }
+static int set_instr( stripheader_t* hdr, uint32 i )		{ return shModifierInstruction( hdr, ( i & 1 ) ? SH_MODIFIER_INSIDE_LAST : SH_MODIFIER_NORMAL ); }
+
+static int set_state( stripheader_t* hdr, uint32 i )
+{
+    SHSTATE s;
+
+    s.flags = SH_STATE_BLEND | SH_STATE_CULL | SH_STATE_DEPTH_FUNC;
+    s.src = ( i & 1 ) ? SH_BLEND_ONE : SH_BLEND_SRC_ALPHA;
+    s.dst = SH_BLEND_INVERSE_SRC_ALPHA;
+    s.cull = ( i & 1 ) ? SH_CULL_CW : SH_CULL_NONE;
+    s.depth = SH_DEPTH_GREATER_OR_EQUAL;
+    s.enable = 0;
+    s.disable = 0;
+    return shSetState( hdr, &s );
+}
+
+static const struct
+{
+    const char*	name;
+    setter_t	fn;
+    int		paletted;	// Needs a paletted texture
+    uint32	types;		// Types the setter is valid for
+} setters[] =
+{
+    { "shEnable",		set_enable,	0,	TYPES_POLYSPRITE },
+    { "shEnable2",		set_enable_2,	0,	TYPES_POLYGON_2 },
+    { "shEnableModifier",	set_modifier,	0,	TYPES_SHADOW },
+    { "shCullMode",		set_cull,	0,	TYPES_ALL },
+    { "shDepthFunc",		set_depth,	0,	TYPES_POLYSPRITE },
+    { "shUserClip",		set_clip,	0,	TYPES_ALL },
+    { "shStripLength",		set_strip,	0,	TYPES_POLYSPRITE },
+    { "shFogMode",		set_fog,	0,	TYPES_POLYSPRITE },
+    { "shFogMode2",		set_fog_2,	0,	TYPES_POLYGON_2 },
+    { "shMipmapAdjust",		set_mipmap,	0,	TYPES_TEXTURED },
+    { "shMipmapAdjust2",	set_mipmap_2,	0,	TYPES_TEXTURED_2 },
+    { "shBlendFunc",		set_blend,	0,	TYPES_POLYSPRITE },
+    { "shBlendFunc2",		set_blend_2,	0,	TYPES_POLYGON_2 },
+    { "shTextureFilter",	set_filter,	0,	TYPES_TEXTURED },
+    { "shTextureFilter2",	set_filter_2,	0,	TYPES_TEXTURED_2 },
+    { "shPalette",		set_palette,	1,	TYPES_TEXTURED },
+    { "shPalette2",		set_palette_2,	1,	TYPES_TEXTURED_2 },
+    { "shTexture",		set_texture,	0,	TYPES_TEXTURED },
+    { "shTexture2",		set_texture_2,	0,	TYPES_TEXTURED_2 },
+    { "shTextureFromDesc",	set_desc,	0,	TYPES_TEXTURED },
+    { "shTextureFromDesc2",	set_desc_2,	0,	TYPES_TEXTURED_2 },
+    { "shBaseColor",		set_base,	0,	TYPES_INTENSITY | TYPES_SPRITE },
+    { "shBaseColor2",		set_base_2,	0,	TYPES_INTENSITY & TYPES_POLYGON_2 },
+    { "shOffsetColor",		set_offset,	0,	( TYPES_INTENSITY | TYPES_SPRITE ) & TYPES_TEXTURED & ~TYPES_POLYGON_2 },
+    { "shSpriteColor",		set_sprite,	0,	TYPES_SPRITE },
+    { "shSpriteColorf",		set_sprite_f,	0,	TYPES_SPRITE },
+    { "shModifierInstruction",	set_instr,	0,	TYPES_MODIFIER },
+    { "shSetState",		set_state,	0,	TYPES_POLYSPRITE },
+};
+
+#define SETTER_COUNT	( sizeof(setters) / sizeof(setters[0]) )
+
+/***** Benchmarks ************************************************************/
+
+// Sets up the header being measured
+static void init_header( bench_arg_t* a )
+{
+    shInit( &a->hdr, a->type, a->list, a->tex, a->tex );
+    if ( a->offset )
+        shEnable( &a->hdr, SH_OFFSET_COLOR );
+}
+
+static void run_init( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i;
+
+    for ( i = 0; i < iterations; i++ )
+        bench_sink += shInit( &a->hdr, a->type, a->list, a->tex, a->tex );
+}
+
+static setter_t current_setter;
+
+static void run_setter( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    const setter_t fn = current_setter;
+    uint32 i;
+
+    for ( i = 0; i < iterations; i++ )
+        bench_sink += (*fn)( &a->hdr, i );
+}
+
+static void run_commit( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i;
+
+    for ( i = 0; i < iterations; i++ )
+        bench_sink += shCommit( &a->hdr, a->out );
+}
+
+// Commits a header that doesn't change, from its baked block
+static void run_commit_cached( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i;
+
+    for ( i = 0; i < iterations; i++ )
+        bench_sink += shCommitCached( &a->hdr, &a->block, a->out );
+}
+
+// A setter followed by a commit, for a header that changes every time
+static void run_commit_changed( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i;
+
+    for ( i = 0; i < iterations; i++ )
+    {
+        shCullMode( &a->hdr, ( i & 1 ) ? SH_CULL_CW : SH_CULL_NONE );
+        bench_sink += shCommit( &a->hdr, a->out );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    static bench_arg_t a;
+    char param[32];
+    uint32 type, s;
+    int size, offset;
+
+#ifdef SH_NO_VALIDATION
+    benchInit( argc, argv, "header_novalidation" );
+#else
+    benchInit( argc, argv, "header" );
+#endif
+
+    shTextureDesc( &desc_rgb, &tex_rgb );
+    shTextureDesc( &desc_small, &tex_small );
+
+    for ( type = 0; type <= 17; type++ )
+    for ( offset = 0; offset <= 1; offset++ )
+    {
+        // Types 10, 13 and 14 send 16 words, and so do 7 and 8 with offset color
+        if ( offset && type != 7 && type != 8 )
+            continue;
+
+        a.type = type;
+        a.list = ( type == 17 ? PVR_LIST_OP_MOD : PVR_LIST_TR_POLY );
+        a.tex = &tex_rgb;
+        a.offset = offset;
+
+        init_header( &a );
+        size = shCommit( &a.hdr, a.out );
+        snprintf( param, sizeof(param), "type%02u_%dw", (unsigned)type, size );
+
+        benchRun( "shInit", param, run_init, &a, 1 );
+
+        for ( s = 0; s < SETTER_COUNT; s++ )
+        {
+            // Setters that aren't valid for this type are skipped. This can't
+            // be left to the setters, SH_NO_VALIDATION builds don't check.
+            if ( !( setters[s].types & BIT( type ) ) )
+                continue;
+
+            a.tex = ( setters[s].paletted ? &tex_pal : &tex_rgb );
+            init_header( &a );
+
+            current_setter = setters[s].fn;
+            benchRun( setters[s].name, param, run_setter, &a, 1 );
+        }
+
+        a.tex = &tex_rgb;
+        init_header( &a );
+        benchRun( "shCommit", param, run_commit, &a, 1 );
+        benchRun( "shCommitChanged", param, run_commit_changed, &a, 1 );
+
+        a.block.size = 0;
+        benchRun( "shCommitCached", param, run_commit_cached, &a, 1 );
+    }
+
+    return benchFinish();
+}
@@ -0,0 +1,260 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Parallel command building: one frame of objects, each a header and a
+// four vertex strip, built by 1 to N threads and merged. Times are per
+// object, and speedup is against one thread. N is the number of online
+// CPUs, but at least 2 so the merge always sees more than one buffer.
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+#include "shdefs.h"
+#include "shparallel.h"
+
+#define OBJECTS		16384
+#define CHUNK_SIZE	64
+#define MATERIALS	64
+#define OBJECT_WORDS	( 16 + 4 * 8 )	// Largest header and four vertices
+#define MAX_THREADS	64
+
+typedef struct
+{
+    shworker_t		w;
+    shcmdbuf_t		cb;
+    uint32*		mem;
+    pthread_t		thread;
+} worker_t;
+
+typedef struct
+{
+    shparallel_t	par;
+    shchunk_t		chunks[OBJECTS / CHUNK_SIZE];
+    stripheader_t	materials[MATERIALS];
+    worker_t		workers[MAX_THREADS];
+    int			threads;
+    int			quit;
+    pthread_barrier_t	start, done;
+    uint32*		merged;
+    int			merged_words;
+} bench_arg_t;
+
+static bench_arg_t a;
+
+static void* alloc( size_t size )
+{
+    void* p = aligned_alloc( 32, ( size + 31 ) & ~(size_t)31 );
+
+    if ( p == NULL )
+    {
+        fprintf( stderr, "parallel: out of memory\n" );
+        exit( 2 );
+    }
+
+    return p;
+}
+
+// A strip header and a quad facing the camera, placed by object index
+static void build_object( shcmdbuf_t* cb, uint32 index )
+{
+    const float x = (float)( index & 127 ) * 5.0f, y = (float)( index >> 7 ) * 3.75f;
+    const float z = 1.0f / ( 1.0f + index * 0.001f );
+    uint32* v;
+    int i;
+
+    shCmdBufCommit( cb, &a.materials[index % MATERIALS] );
+
+    v = shCmdBufAlloc( cb, PVR_LIST_OP_POLY, 4 * 8 );
+    if ( v == NULL )
+        return;
+
+    for ( i = 0; i < 4; i++, v += 8 )
+    {
+        const float vx = x + ( i & 1 ) * 4.0f, vy = y + ( i >> 1 ) * 3.0f;
+
+        v[0] = PCW_TYPE_VERTEX | ( i == 3 ? PCW_END_OF_STRIP : 0 );
+        memcpy( &v[1], &vx, 4 );
+        memcpy( &v[2], &vy, 4 );
+        memcpy( &v[3], &z, 4 );
+        v[4] = 0;
+        v[5] = 0;
+        v[6] = 0xFF000000 | index;
+        v[7] = 0;
+    }
+}
+
+static void work( worker_t* t )
+{
+    uint32 first, count, i;
+
+    while ( shParallelNext( &t->w, &first, &count ) )
+    {
+        for ( i = 0; i < count; i++ )
+            build_object( &t->cb, first + i );
+    }
+}
+
+static void* run_thread( void* p )
+{
+    worker_t* t = (worker_t*)p;
+
+    for ( ;; )
+    {
+        pthread_barrier_wait( &a.start );
+        if ( a.quit )
+            return NULL;
+
+        work( t );
+        pthread_barrier_wait( &a.done );
+    }
+}
+
+static void start_threads( int threads )
+{
+    const uint32 list_size[SH_CMDBUF_LISTS] = { OBJECTS * OBJECT_WORDS * 4 };
+    int i;
+
+    a.threads = threads;
+    a.quit = 0;
+    pthread_barrier_init( &a.start, NULL, threads );
+    pthread_barrier_init( &a.done, NULL, threads );
+
+    for ( i = 0; i < threads; i++ )
+    {
+        worker_t* t = &a.workers[i];
+
+        // Room for the whole frame, since one thread may end up with it
+        t->mem = (uint32*)alloc( list_size[0] );
+        shCmdBufInit( &t->cb, t->mem, list_size[0] );
+        shCmdBufBeginFrame( &t->cb, list_size );
+
+        // The calling thread is worker 0
+        if ( i > 0 )
+            pthread_create( &t->thread, NULL, run_thread, t );
+    }
+}
+
+static void stop_threads( void )
+{
+    int i;
+
+    a.quit = 1;
+    pthread_barrier_wait( &a.start );
+
+    for ( i = 0; i < a.threads; i++ )
+    {
+        if ( i > 0 )
+            pthread_join( a.workers[i].thread, NULL );
+        free( a.workers[i].mem );
+    }
+
+    pthread_barrier_destroy( &a.start );
+    pthread_barrier_destroy( &a.done );
+}
+
+// One frame: build on every thread, then merge the opaque list
+static void run_frame( void* p, uint32 iterations )
+{
+    const uint32 list_size[SH_CMDBUF_LISTS] = { OBJECTS * OBJECT_WORDS * 4 };
+    shcmdframe_t frame;
+    uint32 n;
+    int i;
+
+    (void)p;
+
+    for ( n = 0; n < iterations; n++ )
+    {
+        shParallelInit( &a.par, a.chunks, OBJECTS, CHUNK_SIZE );
+        for ( i = 0; i < a.threads; i++ )
+            shParallelWorkerInit( &a.workers[i].w, &a.par, &a.workers[i].cb, NULL );
+
+        pthread_barrier_wait( &a.start );
+        work( &a.workers[0] );
+        pthread_barrier_wait( &a.done );
+
+        a.merged_words = shParallelMerge( &a.par, PVR_LIST_OP_POLY, a.merged );
+        bench_sink += a.merged_words;
+
+        for ( i = 0; i < a.threads; i++ )
+        {
+            shCmdBufEndFrame( &a.workers[i].cb, &frame );
+            shCmdBufRelease( &a.workers[i].cb, &frame );
+            shCmdBufBeginFrame( &a.workers[i].cb, list_size );
+        }
+    }
+}
+
+int main( int argc, char** argv )
+{
+    long cpus = sysconf( _SC_NPROCESSORS_ONLN );
+    uint32* reference;
+    int reference_words = 0;
+    double single = 0.0;
+    char param[32];
+    int threads, i;
+
+    benchInit( argc, argv, "parallel" );
+
+    if ( cpus < 2 )
+        cpus = 2;
+    if ( cpus > MAX_THREADS )
+        cpus = MAX_THREADS;
+
+    for ( i = 0; i < MATERIALS; i++ )
+    {
+        shInit( &a.materials[i], 0, PVR_LIST_OP_POLY, NULL, NULL );
+        shDepthFunc( &a.materials[i], (SHDEPTHFUNC)( i & 7 ) );
+        shCullMode( &a.materials[i], ( i & 8 ) ? SH_CULL_CW : SH_CULL_NONE );
+    }
+
+    a.merged = (uint32*)alloc( OBJECTS * OBJECT_WORDS * 4 );
+    reference = (uint32*)alloc( OBJECTS * OBJECT_WORDS * 4 );
+
+    for ( threads = 1; threads <= cpus; threads++ )
+    {
+        double ns;
+
+        snprintf( param, sizeof(param), "threads%d", threads );
+
+        start_threads( threads );
+        ns = benchRun( "frame", param, run_frame, NULL, OBJECTS );
+        stop_threads();
+
+        if ( threads == 1 )
+        {
+            single = ns;
+            reference_words = a.merged_words;
+            memcpy( reference, a.merged, a.merged_words * 4 );
+        }
+
+        // The merged list mustn't depend on the thread count
+        if ( a.merged_words != reference_words || memcmp( reference, a.merged, a.merged_words * 4 ) != 0 )
+        {
+            fprintf( stderr, "parallel: merged list differs with %d threads\n", threads );
+            return 1;
+        }
+
+        benchRecord( "frame", param, "speedup", single / ns );
+        benchRecord( "frame", param, "merged_words", a.merged_words );
+    }
+
+    free( a.merged );
+    free( reference );
+    return benchFinish();
+}
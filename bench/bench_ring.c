@@ -0,0 +1,184 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Block ring benchmark: a producer pushing blocks while a consumer thread
+// drains them, like the game and submit threads. The consumer can spend
+// a fixed time per block to stand in for the TA taking the data.
+//
+// Throughput is ns per block pushed, including waiting for room. Latency
+// is the time from a push to its block being drained, in percentiles,
+// with the producer pushing as fast as it can.
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "shring.h"
+
+#define CAPACITY	1024
+#define DRAIN_WORDS	( 64 * 8 )	// Most the consumer takes at once
+#define LATENCY_SAMPLES	65536
+
+typedef struct
+{
+    shring_t		ring;
+    uint32*		mem;
+    uint32		piece_blocks;	// Blocks per push
+    uint32		ta_ns;		// Simulated time per block drained
+    uint32		expected;	// Blocks the consumer waits for
+    uint64*		latency;	// One sample per piece, or NULL
+    uint32		samples;
+} bench_arg_t;
+
+static void spin_until( uint64 t )
+{
+    while ( benchNow() < t )
+        ;
+}
+
+static void* consume( void* p )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    static uint32 out[DRAIN_WORDS] __attribute__((aligned(32)));
+    uint32 blocks = 0;
+    int words, i;
+
+    while ( blocks < a->expected )
+    {
+        words = shRingDrain( &a->ring, out, DRAIN_WORDS );
+        if ( words == 0 )
+        {
+            sched_yield();
+            continue;
+        }
+
+        // The first block of every piece carries the time it was pushed
+        if ( a->latency != NULL )
+        {
+            const uint64 now = benchNow();
+
+            for ( i = 0; i < words; i += 8 )
+            {
+                uint64 stamp;
+
+                if ( out[i + 1] != 0 || a->samples >= LATENCY_SAMPLES )
+                    continue;
+
+                memcpy( &stamp, &out[i + 2], 8 );
+                a->latency[a->samples++] = now - stamp;
+            }
+        }
+
+        if ( a->ta_ns != 0 )
+            spin_until( benchNow() + (uint64)a->ta_ns * ( words / 8 ) );
+
+        blocks += words / 8;
+        bench_sink += out[0];
+    }
+
+    return NULL;
+}
+
+static void run_pipeline( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 words[4 * 8] __attribute__((aligned(32)));
+    pthread_t consumer;
+    uint32 n, i;
+
+    memset( words, 0, sizeof(words) );
+    shRingInit( &a->ring, a->mem, CAPACITY );
+    a->expected = iterations * a->piece_blocks;
+    a->samples = 0;
+
+    pthread_create( &consumer, NULL, consume, a );
+
+    for ( n = 0; n < iterations; n++ )
+    {
+        for ( i = 0; i < a->piece_blocks; i++ )
+        {
+            words[i * 8] = n;
+            words[i * 8 + 1] = i;
+        }
+
+        if ( a->latency != NULL )
+        {
+            const uint64 now = benchNow();
+            memcpy( &words[2], &now, 8 );
+        }
+
+        // Wait for room, giving the consumer the CPU if it shares one
+        while ( shRingPush( &a->ring, words, a->piece_blocks * 8 ) == 0 )
+            sched_yield();
+    }
+
+    pthread_join( consumer, NULL );
+}
+
+static int compare_u64( const void* a, const void* b )
+{
+    const uint64 x = *(const uint64*)a, y = *(const uint64*)b;
+    return ( x > y ) - ( x < y );
+}
+
+static void record_latency( bench_arg_t* a, const char* param )
+{
+    const uint32 pieces = benchQuick() ? 4096 : LATENCY_SAMPLES;
+
+    run_pipeline( a, pieces );
+    if ( a->samples == 0 )
+        return;
+
+    qsort( a->latency, a->samples, sizeof(uint64), compare_u64 );
+    benchRecord( "latency", param, "p50_ns", (double)a->latency[a->samples / 2] );
+    benchRecord( "latency", param, "p99_ns", (double)a->latency[a->samples * 99 / 100] );
+    benchRecord( "latency", param, "max_ns", (double)a->latency[a->samples - 1] );
+}
+
+int main( int argc, char** argv )
+{
+    static const uint32 piece_blocks[] = { 1, 2, 4 };
+    static const uint32 ta_ns[] = { 0, 20 };
+    bench_arg_t a;
+    char param[32];
+    uint32 i, j;
+
+    benchInit( argc, argv, "ring" );
+
+    a.mem = (uint32*)aligned_alloc( 32, CAPACITY * 32 );
+    a.latency = NULL;
+
+    for ( i = 0; i < sizeof(ta_ns) / sizeof(ta_ns[0]); i++ )
+    for ( j = 0; j < sizeof(piece_blocks) / sizeof(piece_blocks[0]); j++ )
+    {
+        a.ta_ns = ta_ns[i];
+        a.piece_blocks = piece_blocks[j];
+        snprintf( param, sizeof(param), "blocks%u_ta%uns", (unsigned)piece_blocks[j], (unsigned)ta_ns[i] );
+
+        a.latency = NULL;
+        benchRun( "throughput", param, run_pipeline, &a, a.piece_blocks );
+        benchRecord( "throughput", param, "full_per_push", (double)a.ring.full * a.piece_blocks / a.expected );
+
+        a.latency = (uint64*)malloc( LATENCY_SAMPLES * sizeof(uint64) );
+        record_latency( &a, param );
+        free( a.latency );
+    }
+
+    free( a.mem );
+    return benchFinish();
+}
@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Shadow volume benchmark: classifying and extruding closed meshes of 1k to
+// 20k triangles, and writing the volumes out. Times are per mesh triangle.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "shshadow.h"
+
+typedef struct
+{
+    shshadowmesh_t	mesh;
+    void*		mem;
+    float*		xyz;
+    uint16*		indices;
+    uint32		tri_count;
+    shmodtriangle_t*	tris;		// Room for shShadowMaxTriangles
+    int			capacity;
+    uint32*		out;		// Words written by shShadowEmit
+    int			volume;		// Triangles in the last volume
+} bench_arg_t;
+
+static void* alloc( size_t size )
+{
+    void* p = aligned_alloc( 32, ( size + 31 ) & ~(size_t)31 );
+
+    if ( p == NULL )
+    {
+        fprintf( stderr, "shadow: out of memory\n" );
+        exit( 2 );
+    }
+
+    return p;
+}
+
+// A closed torus of 2 * u * v triangles, so every edge has a neighbour
+static void setup( bench_arg_t* a, uint32 u, uint32 v )
+{
+    const float pi2 = 6.2831853f;
+    void* scratch;
+    uint32 i, j, n = 0;
+
+    a->tri_count = 2 * u * v;
+    a->xyz = (float*)alloc( u * v * 3 * sizeof(float) );
+    a->indices = (uint16*)alloc( a->tri_count * 3 * sizeof(uint16) );
+
+    for ( i = 0; i < u; i++ )
+    for ( j = 0; j < v; j++ )
+    {
+        const float s = pi2 * i / u, t = pi2 * j / v;
+        float* p = &a->xyz[( i * v + j ) * 3];
+
+        p[0] = ( 2.0f + cosf( t ) ) * cosf( s );
+        p[1] = ( 2.0f + cosf( t ) ) * sinf( s );
+        p[2] = sinf( t );
+    }
+
+    for ( i = 0; i < u; i++ )
+    for ( j = 0; j < v; j++ )
+    {
+        const uint16 p00 = i * v + j, p01 = i * v + ( j + 1 ) % v;
+        const uint16 p10 = ( ( i + 1 ) % u ) * v + j, p11 = ( ( i + 1 ) % u ) * v + ( j + 1 ) % v;
+
+        a->indices[n++] = p00; a->indices[n++] = p10; a->indices[n++] = p11;
+        a->indices[n++] = p00; a->indices[n++] = p11; a->indices[n++] = p01;
+    }
+
+    a->mem = alloc( shShadowMeshSize( a->tri_count ) );
+    scratch = alloc( shShadowScratchSize( a->tri_count ) );
+    shShadowMeshInit( &a->mesh, a->mem, scratch, a->xyz, a->indices, a->tri_count );
+    free( scratch );
+
+    a->capacity = shShadowMaxTriangles( &a->mesh );
+    a->tris = (shmodtriangle_t*)alloc( a->capacity * sizeof(shmodtriangle_t) );
+
+    // Two blocks per triangle, plus the headers
+    a->out = (uint32*)alloc( ( a->capacity + 4 ) * 16 * sizeof(uint32) );
+}
+
+static void teardown( bench_arg_t* a )
+{
+    free( a->xyz );
+    free( a->indices );
+    free( a->mem );
+    free( a->tris );
+    free( a->out );
+}
+
+// The light turns a little every iteration so the silhouette changes
+static void light_dir( float light[3], uint32 i )
+{
+    const float angle = 0.01f * ( i & 1023 );
+
+    light[0] = cosf( angle ) * 0.6f;
+    light[1] = sinf( angle ) * 0.6f;
+    light[2] = -0.8f;
+}
+
+static void run_update( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i;
+
+    for ( i = 0; i < iterations; i++ )
+        shShadowMeshUpdate( &a->mesh, a->xyz );
+
+    bench_sink += a->mesh.lit[0];
+}
+
+static void run_extrude( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    float light[3];
+    uint32 i;
+
+    for ( i = 0; i < iterations; i++ )
+    {
+        light_dir( light, i );
+        a->volume = shShadowExtrude( &a->mesh, light, 10.0f, a->tris, a->capacity );
+        bench_sink += a->volume;
+    }
+}
+
+static void run_emit( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    shvolumebuilder_t vb;
+    float light[3];
+    uint32 i;
+
+    for ( i = 0; i < iterations; i++ )
+    {
+        light_dir( light, i );
+        shVolumeBegin( &vb, a->out, PVR_LIST_OP_MOD, SH_MODIFIER_INSIDE_LAST );
+        bench_sink += shShadowEmit( &a->mesh, &vb, light, 10.0f, a->tris, a->capacity, NULL, NULL );
+        shVolumeEnd( &vb );
+    }
+}
+
+int main( int argc, char** argv )
+{
+    // Torus grids of 1k, 5k, 10k and 20k triangles
+    static const uint32 grids[][2] = { { 25, 20 }, { 50, 50 }, { 100, 50 }, { 100, 100 } };
+    static bench_arg_t a;
+    char param[32];
+    uint32 g;
+
+    benchInit( argc, argv, "shadow" );
+
+    for ( g = 0; g < sizeof(grids) / sizeof(grids[0]); g++ )
+    {
+        setup( &a, grids[g][0], grids[g][1] );
+        snprintf( param, sizeof(param), "tris%u", (unsigned)a.tri_count );
+
+        benchRun( "shShadowMeshUpdate", param, run_update, &a, a.tri_count );
+        benchRun( "shShadowExtrude", param, run_extrude, &a, a.tri_count );
+        benchRecord( "shShadowExtrude", param, "volume_triangles", a.volume );
+        benchRun( "shShadowEmit", param, run_emit, &a, a.tri_count );
+
+        teardown( &a );
+    }
+
+    return benchFinish();
+}
@@ -0,0 +1,202 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Vertex path benchmark: vertices/sec for each of the 18 header types, one
+// vertex per call and as whole strips. Sprites count as 4 vertices and
+// modifier triangles as 3.
+
+#include <stdio.h>
+#include "bench.h"
+#include "shvertex.h"
+
+#define MAX_VERTICES	64
+
+// Writes count vertices of a type, one call per vertex or as one strip
+typedef int (*writefn_t)( uint32* ptr, uint32 type, const void* v, int count );
+
+typedef struct
+{
+    uint32		type;
+    int			count;		// Vertices, sprites or triangles per iteration
+    writefn_t		fn;
+    const void*		src;
+    uint32		out[MAX_VERTICES * 16] __attribute__((aligned(32)));
+} bench_arg_t;
+
+static shvertexpacked_t		packed[MAX_VERTICES];
+static shvertexfloat_t		floats[MAX_VERTICES];
+static shvertexintensity_t	intensity[MAX_VERTICES];
+static shvertexpacked2_t	packed2[MAX_VERTICES];
+static shvertexintensity2_t	intensity2[MAX_VERTICES];
+static shsprite_t		sprites[MAX_VERTICES];
+static shmodtriangle_t		triangles[MAX_VERTICES];
+
+/***** Writers ***************************************************************/
+
+#define SINGLE( name, fn, vtype ) \
+    static int name( uint32* ptr, uint32 type, const void* v, int count ) \
+    { \
+        const vtype* src = (const vtype*)v; \
+        uint32* const start = ptr; \
+        int i; \
+        for ( i = 0; i < count; i++ ) \
+            ptr += fn( ptr, type, &src[i], i == count - 1 ); \
+        return ptr - start; \
+    }
+
+#define STRIP( name, fn, vtype ) \
+    static int name( uint32* ptr, uint32 type, const void* v, int count ) \
+    { \
+        return fn( ptr, type, (const vtype*)v, count ); \
+    }
+
+SINGLE( single_packed,		shVertexPacked,		shvertexpacked_t )
+SINGLE( single_float,		shVertexFloat,		shvertexfloat_t )
+SINGLE( single_intensity,	shVertexIntensity,	shvertexintensity_t )
+SINGLE( single_packed2,		shVertexPacked2,	shvertexpacked2_t )
+SINGLE( single_intensity2,	shVertexIntensity2,	shvertexintensity2_t )
+
+STRIP( strip_packed,		shStripPacked,		shvertexpacked_t )
+STRIP( strip_float,		shStripFloat,		shvertexfloat_t )
+STRIP( strip_intensity,		shStripIntensity,	shvertexintensity_t )
+STRIP( strip_packed2,		shStripPacked2,		shvertexpacked2_t )
+STRIP( strip_intensity2,	shStripIntensity2,	shvertexintensity2_t )
+STRIP( strip_sprites,		shSprites,		shsprite_t )
+
+static int single_sprite( uint32* ptr, uint32 type, const void* v, int count )
+{
+    const shsprite_t* src = (const shsprite_t*)v;
+    uint32* const start = ptr;
+    int i;
+
+    for ( i = 0; i < count; i++ )
+        ptr += shSprite( ptr, type, &src[i] );
+
+    return ptr - start;
+}
+
+static int single_triangle( uint32* ptr, uint32 type, const void* v, int count )
+{
+    const shmodtriangle_t* src = (const shmodtriangle_t*)v;
+    uint32* const start = ptr;
+    int i;
+
+    (void)type;
+    for ( i = 0; i < count; i++ )
+        ptr += shModifierTriangle( ptr, &src[i] );
+
+    return ptr - start;
+}
+
+static int strip_triangles( uint32* ptr, uint32 type, const void* v, int count )
+{
+    (void)type;
+    return shModifierTriangles( ptr, (const shmodtriangle_t*)v, count );
+}
+
+// The writers and vertex data for each type, see the table in shvertex.h
+static const struct
+{
+    writefn_t	single;
+    writefn_t	strip;
+    const void*	src;
+    int		vertices;	// Vertices per element of src
+} classes[18] =
+{
+    /* 0*/ { single_packed,	strip_packed,		packed,		1 },
+    /* 1*/ { single_float,	strip_float,		floats,		1 },
+    /* 2*/ { single_intensity,	strip_intensity,	intensity,	1 },
+    /* 3*/ { single_packed,	strip_packed,		packed,		1 },
+    /* 4*/ { single_packed,	strip_packed,		packed,		1 },
+    /* 5*/ { single_float,	strip_float,		floats,		1 },
+    /* 6*/ { single_float,	strip_float,		floats,		1 },
+    /* 7*/ { single_intensity,	strip_intensity,	intensity,	1 },
+    /* 8*/ { single_intensity,	strip_intensity,	intensity,	1 },
+    /* 9*/ { single_packed2,	strip_packed2,		packed2,	1 },
+    /*10*/ { single_intensity2,	strip_intensity2,	intensity2,	1 },
+    /*11*/ { single_packed2,	strip_packed2,		packed2,	1 },
+    /*12*/ { single_packed2,	strip_packed2,		packed2,	1 },
+    /*13*/ { single_intensity2,	strip_intensity2,	intensity2,	1 },
+    /*14*/ { single_intensity2,	strip_intensity2,	intensity2,	1 },
+    /*15*/ { single_sprite,	strip_sprites,		sprites,	4 },
+    /*16*/ { single_sprite,	strip_sprites,		sprites,	4 },
+    /*17*/ { single_triangle,	strip_triangles,	triangles,	3 },
+};
+
+/***** Benchmarks ************************************************************/
+
+static void fill_vertices( void )
+{
+    int i;
+
+    for ( i = 0; i < MAX_VERTICES; i++ )
+    {
+        const float x = (float)( i * 8 ), y = (float)( ( i & 1 ) * 8 ), z = 1.0f / ( 1 + i );
+        const float u = ( i & 1 ) ? 1.0f : 0.0f, v = (float)i / MAX_VERTICES;
+        const uint32 argb = 0xFF000000 | ( i * 0x010305 );
+
+        packed[i] = (shvertexpacked_t){ x, y, z, u, v, argb, argb >> 1 };
+        floats[i] = (shvertexfloat_t){ x, y, z, u, v, { 1.0f, v, 0.5f, 0.25f }, { 0.0f, 0.1f, v, 0.2f } };
+        intensity[i] = (shvertexintensity_t){ x, y, z, u, v, v, 0.25f };
+        packed2[i] = (shvertexpacked2_t){ x, y, z, u, v, argb, argb >> 1, v, u, argb >> 2, argb >> 3 };
+        intensity2[i] = (shvertexintensity2_t){ x, y, z, u, v, v, 0.25f, v, u, 0.5f, v };
+        sprites[i] = (shsprite_t){ x, 0, z, x + 8, 0, z, x + 8, 8, z, x, 8, 0, 0, 1, 0, 1, 1 };
+        triangles[i] = (shmodtriangle_t){ x, y, z, x + 8, y, z, x, y + 8, z };
+    }
+}
+
+static void run_writer( void* p, uint32 iterations )
+{
+    bench_arg_t* a = (bench_arg_t*)p;
+    uint32 i;
+
+    for ( i = 0; i < iterations; i++ )
+        bench_sink += (*a->fn)( a->out, a->type, a->src, a->count );
+}
+
+int main( int argc, char** argv )
+{
+    static const int lengths[] = { 4, 64 };
+    static bench_arg_t a;
+    char param[32];
+    uint32 type;
+    int l, words;
+
+    benchInit( argc, argv, "vertex" );
+    fill_vertices();
+
+    for ( type = 0; type <= 17; type++ )
+    for ( l = 0; l < (int)( sizeof(lengths) / sizeof(lengths[0]) ); l++ )
+    {
+        const int vertices = classes[type].vertices;
+
+        // Strip length in vertices, so sprites and triangles send fewer elements
+        a.type = type;
+        a.src = classes[type].src;
+        a.count = ( lengths[l] + vertices - 1 ) / vertices;
+        snprintf( param, sizeof(param), "type%02u_len%d", (unsigned)type, lengths[l] );
+
+        a.fn = classes[type].single;
+        words = (*a.fn)( a.out, a.type, a.src, a.count );
+        benchRun( "single", param, run_writer, &a, a.count * vertices );
+        benchRecord( "single", param, "words_per_vertex", (double)words / ( a.count * vertices ) );
+
+        a.fn = classes[type].strip;
+        benchRun( "strip", param, run_writer, &a, a.count * vertices );
+    }
+
+    return benchFinish();
+}
@@ -0,0 +1,50 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Stand-in for KallistiOS' kos.h, for building the library on a host.
+
+ Only what the library uses is defined here: the fixed size integer types
+ and the PVR list numbers. The values match KOS so blocks built on a host
+ are the same as the ones built on the Dreamcast.
+*/
+
+#ifndef __KOS_H
+#define __KOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t		uint8;
+typedef uint16_t	uint16;
+typedef uint32_t	uint32;
+typedef uint64_t	uint64;
+typedef int8_t		int8;
+typedef int16_t		int16;
+typedef int32_t		int32;
+typedef int64_t		int64;
+
+// PVR lists
+typedef uint32		pvr_list_t;
+
+#define PVR_LIST_OP_POLY	0
+#define PVR_LIST_OP_MOD		1
+#define PVR_LIST_TR_POLY	2
+#define PVR_LIST_TR_MOD		3
+#define PVR_LIST_PT_POLY	4
+
+#endif // __KOS_H
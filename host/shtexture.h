@@ -0,0 +1,53 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Stand-in for shtexture.h, for building the library on a host.
+
+ texture_t has the fields the library reads. vram_ptr can point anywhere,
+ only its low bits end up in the texture control word.
+*/
+
+#ifndef __SHTEXTURE_H__
+#define __SHTEXTURE_H__
+
+#include <kos.h>
+
+// Texture flags
+#define TEXFLAG_MIPMAPPED	(1<<0)
+#define TEXFLAG_COMPRESSED	(1<<1)
+#define TEXFLAG_TWIDDLED	(1<<2)
+
+// Texture formats
+typedef enum
+{
+    TEXFMT_RGB565,
+    TEXFMT_ARGB1555,
+    TEXFMT_ARGB4444,
+    TEXFMT_PAL4BPP,
+    TEXFMT_PAL8BPP
+} TEXFMT;
+
+typedef struct texture
+{
+    uint32	width;
+    uint32	height;
+    uint32	format;
+    uint32	flags;
+    void*	vram_ptr;
+} texture_t;
+
+#endif // __SHTEXTURE_H__
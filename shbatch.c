@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shbatch.h"
+#include "shdefs.h"
+
+int shSpriteBatchBegin( shspritebatch_t* b, shemitter_t* em, uint32* ptr, uint32 type, pvr_list_t list, const texture_t* tex )
+{
+    if ( type != 15 && type != 16 )
+        return 0;
+
+    if ( !shInit( &b->hdr, type, list, tex, NULL ) )
+        return 0;
+
+    b->em = em;
+    b->ptr = ptr;
+    b->pending = 1;
+    b->sprites = 0;
+    b->headers = 0;
+    return 1;
+}
+
+// The parts of the header that decide whether it has to be sent again
+typedef struct
+{
+    uint32	words[6];
+    uint32	color;
+} snapshot_t;
+
+static inline uint32 sprite_color( const shspritebatch_t* b )
+{
+    const uint8* c = b->hdr.sprColor;
+
+    return ( (uint32)c[0] << 24 ) | ( c[1] << 16 ) | ( c[2] << 8 ) | c[3];
+}
+
+static inline void take_snapshot( const shspritebatch_t* b, snapshot_t* s )
+{
+    int i;
+
+    for ( i = 0; i < 6; i++ )
+        s->words[i] = b->hdr.words[i];
+    s->color = sprite_color( b );
+}
+
+// Marks the batch as changed if the header differs from the snapshot
+static inline void check_changed( shspritebatch_t* b, const snapshot_t* before )
+{
+    int i;
+
+    if ( sprite_color( b ) != before->color )
+    {
+        b->pending = 1;
+        return;
+    }
+
+    for ( i = 0; i < 6; i++ )
+    {
+        if ( b->hdr.words[i] != before->words[i] )
+        {
+            b->pending = 1;
+            return;
+        }
+    }
+}
+
+int shSpriteBatchTexture( shspritebatch_t* b, const shtexturedesc_t* desc )
+{
+    snapshot_t before;
+    int ok;
+
+    take_snapshot( b, &before );
+    ok = shTextureFromDesc( &b->hdr, desc );
+    check_changed( b, &before );
+    return ok;
+}
+
+int shSpriteBatchBlendFunc( shspritebatch_t* b, SHBLENDFUNC src, SHBLENDFUNC dst )
+{
+    snapshot_t before;
+    int ok;
+
+    take_snapshot( b, &before );
+    ok = shBlendFunc( &b->hdr, src, dst );
+    check_changed( b, &before );
+    return ok;
+}
+
+int shSpriteBatchColor( shspritebatch_t* b, uint32 argb )
+{
+    // shSpriteColor takes the components in RGBA order
+    uint8 rgba[4] = { (uint8)( argb >> 16 ), (uint8)( argb >> 8 ), (uint8)argb, (uint8)( argb >> 24 ) };
+    snapshot_t before;
+    int ok;
+
+    take_snapshot( b, &before );
+    ok = shSpriteColor( &b->hdr, rgba );
+    check_changed( b, &before );
+    return ok;
+}
+
+int shSpriteBatchState( shspritebatch_t* b, const SHSTATE* state )
+{
+    snapshot_t before;
+    int ok;
+
+    take_snapshot( b, &before );
+    ok = shSetState( &b->hdr, state );
+    check_changed( b, &before );
+    return ok;
+}
+
+int shSpriteBatchDraw( shspritebatch_t* b, const shsprite_t* s, int count )
+{
+    uint32* const start = b->ptr;
+
+    if ( count <= 0 )
+        return 0;
+
+    if ( b->pending )
+    {
+        const int size = shEmit( b->em, &b->hdr, b->ptr );
+
+        b->ptr += size;
+        b->headers += ( size != 0 );
+        b->pending = 0;
+    }
+
+    b->ptr += shSprites( b->ptr, b->hdr.type, s, count );
+    b->sprites += count;
+
+    return b->ptr - start;
+}
+
+uint32* shSpriteBatchEnd( shspritebatch_t* b )
+{
+    // Whatever is drawn next has its own header. The emitter has to forget
+    // this one too, or it would drop the next batch's identical header.
+    b->pending = 1;
+    shEmitterResetList( b->em, (pvr_list_t)( ( b->hdr.words[PCW] & PCW_LIST_MASK ) >> PCW_LIST_SHIFT ) );
+    return b->ptr;
+}
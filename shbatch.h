@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Sprite batching.
+
+ Draws large numbers of sprites (types 15 and 16) without a header per
+ sprite. The batch keeps the current sprite state in a header and only
+ sends it before the next sprites after something has actually changed,
+ so runs of sprites with the same texture, blend mode and color share one
+ header. Headers go through an emitter, so switching back and forth
+ between batches that end up with identical state is free as well.
+
+ All writes go forward from the pointer given to shSpriteBatchBegin.
+*/
+
+#ifndef __SHBATCH_H__
+#define __SHBATCH_H__
+
+#include "stripheader.h"
+#include "shemitter.h"
+#include "shvertex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct shspritebatch
+{
+    stripheader_t	hdr;		// Current sprite state
+    shemitter_t*	em;
+    uint32*		ptr;		// Where the next words are written
+    uint32		pending;	// The state has changed since the header was last sent
+
+    // Statistics
+    uint32		sprites;	// Sprites drawn
+    uint32		headers;	// Headers sent (not counting elided ones)
+} shspritebatch_t;
+
+// Starts a batch of type 15 or 16 sprites in the given list.
+// tex can be NULL for type 15.
+// Returns 0 if the header couldn't be initialized.
+int shSpriteBatchBegin( shspritebatch_t* b, shemitter_t* em, uint32* ptr, uint32 type, pvr_list_t list, const texture_t* tex );
+
+// Changes the state for the following sprites. Nothing is sent until the
+// next call to shSpriteBatchDraw, and only if the state really changed.
+int shSpriteBatchTexture( shspritebatch_t* b, const shtexturedesc_t* desc );
+int shSpriteBatchBlendFunc( shspritebatch_t* b, SHBLENDFUNC src, SHBLENDFUNC dst );
+int shSpriteBatchColor( shspritebatch_t* b, uint32 argb );
+int shSpriteBatchState( shspritebatch_t* b, const SHSTATE* state );
+
+// Draws sprites with the current state.
+// Returns the number of 32-bit words written, including any header.
+int shSpriteBatchDraw( shspritebatch_t* b, const shsprite_t* s, int count );
+
+// Returns the pointer following the last word written, so other things
+// can be drawn after the batch. The next header sent to the batch's list
+// is always written, even if it's the same as the batch's last one.
+uint32* shSpriteBatchEnd( shspritebatch_t* b );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHBATCH_H__
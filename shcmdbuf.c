@@ -0,0 +1,186 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shcmdbuf.h"
+#include "shdefs.h"
+
+void shCmdBufInit( shcmdbuf_t* cb, uint32* mem, uint32 size_in_bytes )
+{
+    int i;
+
+    cb->base = mem;
+    cb->size = ( size_in_bytes / 32 ) * 8;
+    cb->head = 0;
+    cb->tail = 0;
+    cb->in_flight = 0;
+    cb->frame_begin = 0;
+    cb->frame_end = 0;
+    cb->high_water = 0;
+
+    for ( i = 0; i < SH_CMDBUF_LISTS; i++ )
+    {
+        cb->lists[i].start = cb->lists[i].ptr = cb->lists[i].end = NULL;
+        cb->lists[i].overflow = 0;
+        cb->lists[i].high_water = 0;
+    }
+}
+
+// Finds room for a frame of the given size in the ring.
+// Returns the ring position, or ~0 if there's no room.
+static uint32 ring_reserve( shcmdbuf_t* cb, uint32 total )
+{
+    if ( cb->in_flight == 0 )
+    {
+        // Nothing in use, start over from the beginning
+        cb->head = cb->tail = 0;
+        return ( total <= cb->size ? 0 : ~0u );
+    }
+
+    if ( cb->head > cb->tail )
+    {
+        // Free room is at the end and at the beginning, before the tail
+        if ( total <= cb->size - cb->head )
+            return cb->head;
+        if ( total <= cb->tail )
+            return 0;
+        return ~0u;
+    }
+
+    // Free room is between the head and the tail (none if they're equal)
+    if ( total <= cb->tail - cb->head )
+        return cb->head;
+    return ~0u;
+}
+
+int shCmdBufBeginFrame( shcmdbuf_t* cb, const uint32 list_size[SH_CMDBUF_LISTS] )
+{
+    uint32 words[SH_CMDBUF_LISTS];
+    uint32 total = 0, pos;
+    int i;
+
+    for ( i = 0; i < SH_CMDBUF_LISTS; i++ )
+    {
+        words[i] = ( ( list_size[i] + 31 ) / 32 ) * 8;
+        total += words[i];
+    }
+
+    pos = ring_reserve( cb, total );
+    if ( pos == ~0u )
+        return 0;
+
+    cb->frame_begin = pos;
+    cb->frame_end = pos + total;
+
+    for ( i = 0; i < SH_CMDBUF_LISTS; i++ )
+    {
+        cb->lists[i].start = cb->lists[i].ptr = cb->base + pos;
+        cb->lists[i].end = cb->lists[i].start + words[i];
+        pos += words[i];
+    }
+
+    return 1;
+}
+
+uint32* shCmdBufAlloc( shcmdbuf_t* cb, pvr_list_t list, uint32 size_in_words )
+{
+    shcmdlist_t* l;
+    uint32* ptr;
+
+    if ( (uint32)list >= SH_CMDBUF_LISTS )
+        return NULL;
+
+    l = &cb->lists[list];
+
+    if ( size_in_words > (uint32)( l->end - l->ptr ) )
+    {
+        l->overflow += size_in_words;
+        return NULL;
+    }
+
+    ptr = l->ptr;
+    l->ptr += size_in_words;
+    return ptr;
+}
+
+int shCmdBufWrite( shcmdbuf_t* cb, pvr_list_t list, const uint32* words, uint32 size_in_words )
+{
+    uint32* ptr = shCmdBufAlloc( cb, list, size_in_words );
+    uint32 i;
+
+    if ( ptr == NULL )
+        return 0;
+
+    for ( i = 0; i < size_in_words; i++ )
+        ptr[i] = words[i];
+
+    return size_in_words;
+}
+
+int shCmdBufCommit( shcmdbuf_t* cb, const stripheader_t* hdr )
+{
+    const uint32 list = ( hdr->words[PCW] & PCW_LIST_MASK ) >> PCW_LIST_SHIFT;
+    shblock_t block;
+
+    if ( shBake( hdr, &block ) == 0 )
+        return 0;
+
+    return shCmdBufWrite( cb, list, block.words, block.size );
+}
+
+void shCmdBufEndFrame( shcmdbuf_t* cb, shcmdframe_t* frame )
+{
+    uint32 used = 0;
+    int i;
+
+    for ( i = 0; i < SH_CMDBUF_LISTS; i++ )
+    {
+        shcmdlist_t* l = &cb->lists[i];
+        const uint32 words = l->ptr - l->start;
+
+        frame->list_start[i] = l->start;
+        frame->list_size[i] = words * 4;
+
+        if ( words > l->high_water )
+            l->high_water = words;
+        used += words;
+
+#ifdef _arch_dreamcast
+        if ( words != 0 )
+            dcache_flush_range( (uintptr_t)l->start, words * 4 );
+#endif
+
+        // Nothing more can be written to this frame
+        l->start = l->ptr = l->end = NULL;
+    }
+
+    if ( used > cb->high_water )
+        cb->high_water = used;
+
+    frame->begin = cb->frame_begin;
+    frame->end = cb->frame_end;
+
+    cb->head = cb->frame_end;
+    cb->in_flight++;
+}
+
+void shCmdBufRelease( shcmdbuf_t* cb, const shcmdframe_t* frame )
+{
+    if ( cb->in_flight == 0 )
+        return;
+
+    cb->tail = frame->end;
+    cb->in_flight--;
+}
@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Command buffers.
+
+ Instead of writing headers and vertices to the TA with the store queues,
+ a whole frame can be built in RAM and then handed to the TA with DMA,
+ leaving the CPU free to start on the next frame.
+
+ A command buffer is an arena that's used as a ring of frames. Each frame
+ reserves one segment per list (OP, OP_MOD, TR, TR_MOD, PT) from the ring
+ and everything is appended forward into those segments. When a frame is
+ ended, the start and size of each list is returned so it can be sent.
+ Once the DMA for a frame has finished, the frame is released and its
+ memory can be reused. Frames must be released in the order they were ended.
+
+ Writes that don't fit in their segment are dropped and counted, and the
+ largest amount of memory each list has needed is tracked, so segment
+ sizes can be tuned.
+*/
+
+#ifndef __SHCMDBUF_H__
+#define __SHCMDBUF_H__
+
+#include "stripheader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of lists (OP, OP_MOD, TR, TR_MOD, PT)
+#define SH_CMDBUF_LISTS		5
+
+typedef struct shcmdlist
+{
+    uint32*	start;
+    uint32*	ptr;
+    uint32*	end;
+    uint32	overflow;	// Words dropped because the segment was full
+    uint32	high_water;	// Most words this list has used in a frame
+} shcmdlist_t;
+
+// A finished frame, ready to be sent
+typedef struct shcmdframe
+{
+    uint32*	list_start[SH_CMDBUF_LISTS];
+    uint32	list_size[SH_CMDBUF_LISTS];	// In bytes, 0 for unused lists
+    uint32	begin;				// Ring position, used by shCmdBufRelease
+    uint32	end;
+} shcmdframe_t;
+
+typedef struct shcmdbuf
+{
+    uint32*	base;
+    uint32	size;		// Arena size in words
+    uint32	head;		// Where the next frame is reserved
+    uint32	tail;		// Start of the oldest frame that hasn't been released
+    uint32	in_flight;	// Number of frames that haven't been released
+    uint32	frame_begin;	// Ring position of the frame being built
+    uint32	frame_end;
+    uint32	high_water;	// Most words a frame has used, all lists together
+    shcmdlist_t	lists[SH_CMDBUF_LISTS];
+} shcmdbuf_t;
+
+// Initializes a command buffer using mem as the arena.
+// mem must be 32-byte aligned.
+void shCmdBufInit( shcmdbuf_t* cb, uint32* mem, uint32 size_in_bytes );
+
+// Starts a new frame, reserving list_size[list] bytes for each list.
+// Sizes are rounded up to whole 32-byte blocks.
+// Returns 0 if there's not enough free room in the ring. In that case,
+// release a frame and try again.
+int shCmdBufBeginFrame( shcmdbuf_t* cb, const uint32 list_size[SH_CMDBUF_LISTS] );
+
+// Reserves room for size_in_words words at the end of a list and returns
+// where to write them, or NULL if they don't fit.
+uint32* shCmdBufAlloc( shcmdbuf_t* cb, pvr_list_t list, uint32 size_in_words );
+
+// Appends words to a list. Returns the number of words written.
+int shCmdBufWrite( shcmdbuf_t* cb, pvr_list_t list, const uint32* words, uint32 size_in_words );
+
+// Appends a header to a list, in the same format as shCommit.
+// The list is taken from the header. Returns the number of words written.
+int shCmdBufCommit( shcmdbuf_t* cb, const stripheader_t* hdr );
+
+// Ends the current frame and returns where each list is.
+// On the Dreamcast, the lists are also flushed from the cache so they can be sent with DMA.
+void shCmdBufEndFrame( shcmdbuf_t* cb, shcmdframe_t* frame );
+
+// Gives the memory of a frame back to the ring once it's been sent.
+void shCmdBufRelease( shcmdbuf_t* cb, const shcmdframe_t* frame );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHCMDBUF_H__
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shcolor.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SH_COLOR_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SH_COLOR_NEON
+#endif
+
+// Packs four colors at a time into out[0..3]
+#if defined(SH_COLOR_SSE2)
+
+static inline __m128i pack4_component( __m128 c )
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps( 1.0f );
+
+    c = _mm_min_ps( _mm_max_ps( c, zero ), one );
+    return _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( c, _mm_set1_ps( 255.0f ) ), _mm_set1_ps( 0.5f ) ) );
+}
+
+static inline void pack4( uint32* out, const float* argb )
+{
+    // Reverse each color to BGRA so the bytes end up in ARGB order in memory
+    const __m128 c0 = _mm_shuffle_ps( _mm_loadu_ps( argb +  0 ), _mm_loadu_ps( argb +  0 ), _MM_SHUFFLE( 0, 1, 2, 3 ) );
+    const __m128 c1 = _mm_shuffle_ps( _mm_loadu_ps( argb +  4 ), _mm_loadu_ps( argb +  4 ), _MM_SHUFFLE( 0, 1, 2, 3 ) );
+    const __m128 c2 = _mm_shuffle_ps( _mm_loadu_ps( argb +  8 ), _mm_loadu_ps( argb +  8 ), _MM_SHUFFLE( 0, 1, 2, 3 ) );
+    const __m128 c3 = _mm_shuffle_ps( _mm_loadu_ps( argb + 12 ), _mm_loadu_ps( argb + 12 ), _MM_SHUFFLE( 0, 1, 2, 3 ) );
+
+    const __m128i lo = _mm_packs_epi32( pack4_component( c0 ), pack4_component( c1 ) );
+    const __m128i hi = _mm_packs_epi32( pack4_component( c2 ), pack4_component( c3 ) );
+
+    _mm_storeu_si128( (__m128i*)out, _mm_packus_epi16( lo, hi ) );
+}
+
+#elif defined(SH_COLOR_NEON)
+
+static inline uint32x4_t pack4_component( float32x4_t c )
+{
+    c = vminq_f32( vmaxq_f32( c, vdupq_n_f32( 0.0f ) ), vdupq_n_f32( 1.0f ) );
+    return vcvtq_u32_f32( vmlaq_f32( vdupq_n_f32( 0.5f ), c, vdupq_n_f32( 255.0f ) ) );
+}
+
+static inline void pack4( uint32* out, const float* argb )
+{
+    // Splits the four colors into one vector per component
+    const float32x4x4_t c = vld4q_f32( argb );
+    uint32x4_t packed;
+
+    packed = vshlq_n_u32( pack4_component( c.val[0] ), 24 );
+    packed = vorrq_u32( packed, vshlq_n_u32( pack4_component( c.val[1] ), 16 ) );
+    packed = vorrq_u32( packed, vshlq_n_u32( pack4_component( c.val[2] ), 8 ) );
+    packed = vorrq_u32( packed, pack4_component( c.val[3] ) );
+
+    vst1q_u32( out, packed );
+}
+
+#else
+
+// Unrolled so the SH4 can overlap the float conversions of different colors
+static inline void pack4( uint32* out, const float* argb )
+{
+    const uint32 p0 = shPackColor( argb[0],  argb[1],  argb[2],  argb[3] );
+    const uint32 p1 = shPackColor( argb[4],  argb[5],  argb[6],  argb[7] );
+    const uint32 p2 = shPackColor( argb[8],  argb[9],  argb[10], argb[11] );
+    const uint32 p3 = shPackColor( argb[12], argb[13], argb[14], argb[15] );
+
+    out[0] = p0;
+    out[1] = p1;
+    out[2] = p2;
+    out[3] = p3;
+}
+
+#endif
+
+void shPackColors( uint32* out, const float* argb, uint32 count )
+{
+    uint32 i;
+
+    for ( i = 0; i + 4 <= count; i += 4 )
+        pack4( out + i, argb + i * 4 );
+
+    for ( ; i < count; i++ )
+        out[i] = shPackColor( argb[i * 4], argb[i * 4 + 1], argb[i * 4 + 2], argb[i * 4 + 3] );
+}
+
+void shPackColorsStrided( uint32* out, uint32 stride, const float* argb, uint32 count )
+{
+    uint8* dst = (uint8*)out;
+    uint32 packed[4];
+    uint32 i;
+
+    for ( i = 0; i + 4 <= count; i += 4 )
+    {
+        pack4( packed, argb + i * 4 );
+        *(uint32*)( dst ) = packed[0];
+        *(uint32*)( dst + stride ) = packed[1];
+        *(uint32*)( dst + stride * 2 ) = packed[2];
+        *(uint32*)( dst + stride * 3 ) = packed[3];
+        dst += stride * 4;
+    }
+
+    for ( ; i < count; i++, dst += stride )
+        *(uint32*)dst = shPackColor( argb[i * 4], argb[i * 4 + 1], argb[i * 4 + 2], argb[i * 4 + 3] );
+}
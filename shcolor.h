@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Color packing.
+
+ Converts float ARGB colors (0..1) to the packed 32-bit ARGB format used
+ by sprites and packed color vertices. Components are clamped to 0..1 and
+ rounded to the nearest of 0..255. NaN packs as 0.
+
+ The batch functions use SSE2 or NEON when built for a host that has them
+ and an unrolled scalar loop otherwise. All paths give the same results.
+*/
+
+#ifndef __SHCOLOR_H__
+#define __SHCOLOR_H__
+
+#include <kos.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// NaN fails the first comparison and becomes 0, the same as the SIMD paths.
+// Converting it to an integer as it is would be undefined.
+static inline uint32 shPackComponent( float c )
+{
+    c = ( c > 0.0f ? c : 0.0f );
+    c = ( c < 1.0f ? c : 1.0f );
+    return (uint32)( c * 255.0f + 0.5f );
+}
+
+// Packs a single color.
+static inline uint32 shPackColor( float a, float r, float g, float b )
+{
+    return ( shPackComponent( a ) << 24 ) | ( shPackComponent( r ) << 16 ) |
+           ( shPackComponent( g ) << 8 ) | shPackComponent( b );
+}
+
+// Packs count colors. argb holds four floats per color.
+void shPackColors( uint32* out, const float* argb, uint32 count );
+
+// Same as shPackColors, but every output is stride bytes after the previous
+// one. Use this to write the colors straight into an array of vertices.
+void shPackColorsStrided( uint32* out, uint32 stride, const float* argb, uint32 count );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHCOLOR_H__
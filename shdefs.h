@@ -0,0 +1,654 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Register layouts and other definitions shared by the library's source
+// files and the C++ layer in stripheader.hpp. This is not part of the
+// public C interface.
+
+#ifndef __SHDEFS_H__
+#define __SHDEFS_H__
+
+#include "stripheader.h"
+
+/////////////////////////////////////////////////////
+// Parameter control word                          //
+/////////////////////////////////////////////////////
+
+// Type, bits 31-29
+#define PCW_TYPE_SHIFT				29
+#define PCW_TYPE_END_OF_LIST			(0u << PCW_TYPE_SHIFT)
+#define PCW_TYPE_USER_TILE_CLIP			(1u << PCW_TYPE_SHIFT)
+#define PCW_TYPE_OBJECT_LIST_SET		(2u << PCW_TYPE_SHIFT)
+#define PCW_TYPE_POLYGON			(4u << PCW_TYPE_SHIFT)
+#define PCW_TYPE_MODIFIER			(4u << PCW_TYPE_SHIFT)
+#define PCW_TYPE_SPRITE				(5u << PCW_TYPE_SHIFT)
+#define PCW_TYPE_VERTEX				(7u << PCW_TYPE_SHIFT)
+#define PCW_TYPE_MASK				(7u << PCW_TYPE_SHIFT)
+
+// List, bits 26-24
+#define PCW_LIST_SHIFT				24
+#define PCW_LIST_OP_POLYGON			(0 << PCW_LIST_SHIFT)
+#define PCW_LIST_OP_MODIFIER			(1 << PCW_LIST_SHIFT)
+#define PCW_LIST_TR_POLYGON			(2 << PCW_LIST_SHIFT)
+#define PCW_LIST_TR_MODIFIER			(3 << PCW_LIST_SHIFT)
+#define PCW_LIST_PT_POLYGON			(4 << PCW_LIST_SHIFT)
+#define PCW_LIST_MASK				(7 << PCW_LIST_SHIFT)
+
+// Update strip length & user clip, bit 23
+#define PCW_UPDATE_GROUP_SHIFT			23
+#define PCW_UPDATE_GROUP_OFF			(0 << PCW_UPDATE_GROUP_SHIFT)
+#define PCW_UPDATE_GROUP_ON			(1 << PCW_UPDATE_GROUP_SHIFT)
+#define PCW_UPDATE_GROUP_MASK			(1 << PCW_UPDATE_GROUP_SHIFT)
+
+// End of strip (for vertices), bit 28
+#define PCW_END_OF_STRIP_SHIFT			28
+#define PCW_END_OF_STRIP			(1 << PCW_END_OF_STRIP_SHIFT)
+#define PCW_END_OF_STRIP_MASK			(1 << PCW_END_OF_STRIP_SHIFT)
+
+// Strip length, bits 19-18
+#define PCW_STRIP_LENGTH_SHIFT			18
+#define PCW_STRIP_LENGTH_1			(0 << PCW_STRIP_LENGTH_SHIFT)
+#define PCW_STRIP_LENGTH_2			(1 << PCW_STRIP_LENGTH_SHIFT)
+#define PCW_STRIP_LENGTH_4			(2 << PCW_STRIP_LENGTH_SHIFT)
+#define PCW_STRIP_LENGTH_6			(3 << PCW_STRIP_LENGTH_SHIFT)
+#define PCW_STRIP_LENGTH_MASK			(3 << PCW_STRIP_LENGTH_SHIFT)
+
+// User clip, bits 17-16
+#define PCW_USER_CLIP_SHIFT			16
+#define PCW_USER_CLIP_DISABLE			(0 << PCW_USER_CLIP_SHIFT)
+#define PCW_USER_CLIP_INSIDE			(2 << PCW_USER_CLIP_SHIFT)
+#define PCW_USER_CLIP_OUTSIDE			(3 << PCW_USER_CLIP_SHIFT)
+#define PCW_USER_CLIP_MASK			(3 << PCW_USER_CLIP_SHIFT)
+
+// Enable modifiers (for polygons), bit 7
+#define PCW_MODIFIER_SHIFT			7
+#define PCW_MODIFIER_DISABLE			(0 << PCW_MODIFIER_SHIFT)
+#define PCW_MODIFIER_ENABLE			(1 << PCW_MODIFIER_SHIFT)
+#define PCW_MODIFIER_MASK			(1 << PCW_MODIFIER_SHIFT)
+
+// Modifier type (for polygons), bit 6
+#define PCW_MODIFIER_TYPE_SHIFT			6
+#define PCW_MODIFIER_TYPE_SHADOW		(0 << PCW_MODIFIER_TYPE_SHIFT)
+#define PCW_MODIFIER_TYPE_NORMAL		(1 << PCW_MODIFIER_TYPE_SHIFT)
+#define PCW_MODIFIER_TYPE_MASK			(1 << PCW_MODIFIER_TYPE_SHIFT)
+
+// Last triangle in volume (for modifiers), bit 6
+#define PCW_MODIFIER_TRIANGLE_SHIFT		6
+#define PCW_MODIFIER_TRIANGLE			(0 << PCW_MODIFIER_TRIANGLE_SHIFT)
+#define PCW_MODIFIER_TRIANGLE_LAST		(1 << PCW_MODIFIER_TRIANGLE_SHIFT)
+#define PCW_MODIFIER_TRIANGLE_MASK		(1 << PCW_MODIFIER_TRIANGLE_SHIFT)
+
+// Color type, bits 5-4
+#define PCW_COLOR_TYPE_SHIFT			4
+#define PCW_COLOR_TYPE_PACKED			(0 << PCW_COLOR_TYPE_SHIFT)
+#define PCW_COLOR_TYPE_FLOAT			(1 << PCW_COLOR_TYPE_SHIFT)
+#define PCW_COLOR_TYPE_INTENSITY		(2 << PCW_COLOR_TYPE_SHIFT)
+#define PCW_COLOR_TYPE_PREV_INTENSITY		(3 << PCW_COLOR_TYPE_SHIFT)
+#define PCW_COLOR_TYPE_MASK			(3 << PCW_COLOR_TYPE_SHIFT)
+
+// Texture enable, bit 3
+#define PCW_TEXTURE_SHIFT			3
+#define PCW_TEXTURE_DISABLE			(0 << PCW_TEXTURE_SHIFT)
+#define PCW_TEXTURE_ENABLE			(1 << PCW_TEXTURE_SHIFT)
+#define PCW_TEXTURE_MASK			(1 << PCW_TEXTURE_SHIFT)
+
+// Offset color enable, bit 2
+#define PCW_OFFSET_COLOR_SHIFT			2
+#define PCW_OFFSET_COLOR_DISABLE		(0 << PCW_OFFSET_COLOR_SHIFT)
+#define PCW_OFFSET_COLOR_ENABLE			(1 << PCW_OFFSET_COLOR_SHIFT)
+#define PCW_OFFSET_COLOR_MASK			(1 << PCW_OFFSET_COLOR_SHIFT)
+
+// Shading, bit 1
+#define PCW_SHADING_SHIFT			1
+#define PCW_SHADING_FLAT			(0 << PCW_SHADING_SHIFT)
+#define PCW_SHADING_GOURAUD			(1 << PCW_SHADING_SHIFT)
+#define PCW_SHADING_MASK			(1 << PCW_SHADING_SHIFT)
+
+// UV, bit 0
+#define PCW_UV_SHIFT				0
+#define PCW_UV_32BIT				(0 << PCW_UV_SHIFT)
+#define PCW_UV_16BIT				(1 << PCW_UV_SHIFT)
+#define PCW_UV_MASK				(1 << PCW_UV_SHIFT)
+
+/////////////////////////////////////////////////////
+// ISP/TSP instruction word                        //
+/////////////////////////////////////////////////////
+
+// Depth compare (for polygons), bits 31-29
+#define ISP_TSP_DEPTH_COMPARE_SHIFT		29
+#define ISP_TSP_DEPTH_COMPARE_NEVER		(0u << ISP_TSP_DEPTH_COMPARE_SHIFT)
+#define ISP_TSP_DEPTH_COMPARE_LESS		(1u << ISP_TSP_DEPTH_COMPARE_SHIFT)
+#define ISP_TSP_DEPTH_COMPARE_EQUAL		(2u << ISP_TSP_DEPTH_COMPARE_SHIFT)
+#define ISP_TSP_DEPTH_COMPARE_LESS_OR_EQUAL	(3u << ISP_TSP_DEPTH_COMPARE_SHIFT)
+#define ISP_TSP_DEPTH_COMPARE_GREATER		(4u << ISP_TSP_DEPTH_COMPARE_SHIFT)
+#define ISP_TSP_DEPTH_COMPARE_NOT_EQUAL		(5u << ISP_TSP_DEPTH_COMPARE_SHIFT)
+#define ISP_TSP_DEPTH_COMPARE_GREATER_OR_EQUAL	(6u << ISP_TSP_DEPTH_COMPARE_SHIFT)
+#define ISP_TSP_DEPTH_COMPARE_ALWAYS		(7u << ISP_TSP_DEPTH_COMPARE_SHIFT)
+#define ISP_TSP_DEPTH_COMPARE_MASK		(7u << ISP_TSP_DEPTH_COMPARE_SHIFT)
+
+// Volume instruction (for modifiers), bits 31-29
+#define ISP_TSP_VOLUME_INSTRUCTION_SHIFT	29
+#define ISP_TSP_VOLUME_INSTRUCTION_NORMAL	(0u << ISP_TSP_VOLUME_INSTRUCTION_SHIFT)
+#define ISP_TSP_VOLUME_INSTRUCTION_INSIDE_LAST	(1u << ISP_TSP_VOLUME_INSTRUCTION_SHIFT)
+#define ISP_TSP_VOLUME_INSTRUCTION_OUTSIDE_LAST	(2u << ISP_TSP_VOLUME_INSTRUCTION_SHIFT)
+#define ISP_TSP_VOLUME_INSTRUCTION_MASK		(7u << ISP_TSP_VOLUME_INSTRUCTION_SHIFT)
+
+// Cull mode (for polygons and modifiers), bits 28-27
+#define ISP_TSP_CULL_MODE_SHIFT			27
+#define ISP_TSP_CULL_MODE_NONE			(0 << ISP_TSP_CULL_MODE_SHIFT)
+#define ISP_TSP_CULL_MODE_SMALL			(1 << ISP_TSP_CULL_MODE_SHIFT)
+#define ISP_TSP_CULL_MODE_COUNTER_CLOCKWISE	(2 << ISP_TSP_CULL_MODE_SHIFT)
+#define ISP_TSP_CULL_MODE_CLOCKWISE		(3 << ISP_TSP_CULL_MODE_SHIFT)
+#define ISP_TSP_CULL_MODE_MASK			(3 << ISP_TSP_CULL_MODE_SHIFT)
+
+// Z write disable, bit 26
+#define ISP_TSP_Z_WRITE_SHIFT			26
+#define ISP_TSP_Z_WRITE_ENABLE			(0 << ISP_TSP_Z_WRITE_SHIFT)
+#define ISP_TSP_Z_WRITE_DISABLE			(1 << ISP_TSP_Z_WRITE_SHIFT)
+#define ISP_TSP_Z_WRITE_MASK			(1 << ISP_TSP_Z_WRITE_SHIFT)
+
+// DCalc control, bit 20
+#define ISP_TSP_DCALC_SHIFT			20
+#define ISP_TSP_DCALC_DISABLE			(0 << ISP_TSP_DCALC_SHIFT)
+#define ISP_TSP_DCALC_ENABLE			(1 << ISP_TSP_DCALC_SHIFT)
+#define ISP_TSP_DCALC_MASK			(1 << ISP_TSP_DCALC_SHIFT)
+
+/////////////////////////////////////////////////////
+// TSP instruction word                            //
+/////////////////////////////////////////////////////
+
+// SRC Alpha instruction, bits 31-29
+#define TSP_SRC_ALPHA_INSTR_SHIFT		29
+#define TSP_SRC_ALPHA_INSTR_ZERO		(0u << TSP_SRC_ALPHA_INSTR_SHIFT)
+#define TSP_SRC_ALPHA_INSTR_ONE			(1u << TSP_SRC_ALPHA_INSTR_SHIFT)
+#define TSP_SRC_ALPHA_INSTR_DST_COLOR		(2u << TSP_SRC_ALPHA_INSTR_SHIFT)
+#define TSP_SRC_ALPHA_INSTR_INVERSE_DST_COLOR	(3u << TSP_SRC_ALPHA_INSTR_SHIFT)
+#define TSP_SRC_ALPHA_INSTR_SRC_ALPHA		(4u << TSP_SRC_ALPHA_INSTR_SHIFT)
+#define TSP_SRC_ALPHA_INSTR_INVERSE_SRC_ALPHA	(5u << TSP_SRC_ALPHA_INSTR_SHIFT)
+#define TSP_SRC_ALPHA_INSTR_DST_ALPHA		(6u << TSP_SRC_ALPHA_INSTR_SHIFT)
+#define TSP_SRC_ALPHA_INSTR_INVERSE_DST_ALPHA	(7u << TSP_SRC_ALPHA_INSTR_SHIFT)
+#define TSP_SRC_ALPHA_INSTR_MASK		(7u << TSP_SRC_ALPHA_INSTR_SHIFT)
+
+// DST Alpha instruction, bits 28-26
+#define TSP_DST_ALPHA_INSTR_SHIFT		26
+#define TSP_DST_ALPHA_INSTR_ZERO		(0 << TSP_DST_ALPHA_INSTR_SHIFT)
+#define TSP_DST_ALPHA_INSTR_ONE			(1 << TSP_DST_ALPHA_INSTR_SHIFT)
+#define TSP_DST_ALPHA_INSTR_DST_COLOR		(2 << TSP_DST_ALPHA_INSTR_SHIFT)
+#define TSP_DST_ALPHA_INSTR_INVERSE_DST_COLOR	(3 << TSP_DST_ALPHA_INSTR_SHIFT)
+#define TSP_DST_ALPHA_INSTR_SRC_ALPHA		(4 << TSP_DST_ALPHA_INSTR_SHIFT)
+#define TSP_DST_ALPHA_INSTR_INVERSE_SRC_ALPHA	(5 << TSP_DST_ALPHA_INSTR_SHIFT)
+#define TSP_DST_ALPHA_INSTR_DST_ALPHA		(6 << TSP_DST_ALPHA_INSTR_SHIFT)
+#define TSP_DST_ALPHA_INSTR_INVERSE_DST_ALPHA	(7 << TSP_DST_ALPHA_INSTR_SHIFT)
+#define TSP_DST_ALPHA_INSTR_MASK		(7 << TSP_DST_ALPHA_INSTR_SHIFT)
+
+// SRC select enable, bit 25
+#define TSP_SRC_SELECT_SHIFT			25
+#define TSP_SRC_SELECT_DISABLE			(0 << TSP_SRC_SELECT_SHIFT)
+#define TSP_SRC_SELECT_ENABLE			(1 << TSP_SRC_SELECT_SHIFT)
+#define TSP_SRC_SELECT_MASK			(1 << TSP_SRC_SELECT_SHIFT)
+
+// DST select enable, bit 24
+#define TSP_DST_SELECT_SHIFT			24
+#define TSP_DST_SELECT_DISABLE			(0 << TSP_DST_SELECT_SHIFT)
+#define TSP_DST_SELECT_ENABLE			(1 << TSP_DST_SELECT_SHIFT)
+#define TSP_DST_SELECT_MASK			(1 << TSP_DST_SELECT_SHIFT)
+
+// Fog mode, bits 23-22
+#define TSP_FOG_MODE_SHIFT			22
+#define TSP_FOG_MODE_LOOKUP_TABLE		(0 << TSP_FOG_MODE_SHIFT)
+#define TSP_FOG_MODE_PER_VERTEX			(1 << TSP_FOG_MODE_SHIFT)
+#define TSP_FOG_MODE_DISABLE			(2 << TSP_FOG_MODE_SHIFT)
+#define TSP_FOG_MODE_LOOKUP_TABLE_2		(3 << TSP_FOG_MODE_SHIFT)
+#define TSP_FOG_MODE_MASK			(3 << TSP_FOG_MODE_SHIFT)
+
+// Color clamp enable, bit 21
+#define TSP_COLOR_CLAMP_SHIFT			21
+#define TSP_COLOR_CLAMP_DISABLE			(0 << TSP_COLOR_CLAMP_SHIFT)
+#define TSP_COLOR_CLAMP_ENABLE			(1 << TSP_COLOR_CLAMP_SHIFT)
+#define TSP_COLOR_CLAMP_MASK			(1 << TSP_COLOR_CLAMP_SHIFT)
+
+// Alpha enable, bit 20
+#define TSP_ALPHA_SHIFT				20
+#define TSP_ALPHA_DISABLE			(0 << TSP_ALPHA_SHIFT)
+#define TSP_ALPHA_ENABLE			(1 << TSP_ALPHA_SHIFT)
+#define TSP_ALPHA_MASK				(1 << TSP_ALPHA_SHIFT)
+
+// Texture alpha enable, bit 19
+#define TSP_TEXTURE_ALPHA_SHIFT			19
+#define TSP_TEXTURE_ALPHA_DISABLE		(1 << TSP_TEXTURE_ALPHA_SHIFT)
+#define TSP_TEXTURE_ALPHA_ENABLE		(0 << TSP_TEXTURE_ALPHA_SHIFT)
+#define TSP_TEXTURE_ALPHA_MASK			(1 << TSP_TEXTURE_ALPHA_SHIFT)
+
+// Flip UV, bits 18-17
+#define TSP_UV_FLIP_SHIFT			17
+#define TSP_UV_FLIP_NONE			(0 << TSP_UV_FLIP_SHIFT)
+#define TSP_UV_FLIP_V				(1 << TSP_UV_FLIP_SHIFT)
+#define TSP_UV_FLIP_U				(2 << TSP_UV_FLIP_SHIFT)
+#define TSP_UV_FLIP_UV				(3 << TSP_UV_FLIP_SHIFT)
+#define TSP_UV_FLIP_MASK			(3 << TSP_UV_FLIP_SHIFT)
+
+// Clamp UV, bits 16-15
+#define TSP_UV_CLAMP_SHIFT			15
+#define TSP_UV_CLAMP_NONE			(0 << TSP_UV_CLAMP_SHIFT)
+#define TSP_UV_CLAMP_V				(1 << TSP_UV_CLAMP_SHIFT)
+#define TSP_UV_CLAMP_U				(2 << TSP_UV_CLAMP_SHIFT)
+#define TSP_UV_CLAMP_UV				(3 << TSP_UV_CLAMP_SHIFT)
+#define TSP_UV_CLAMP_MASK			(3 << TSP_UV_CLAMP_SHIFT)
+
+// Texture filter, bits 14-13
+#define TSP_TEXTURE_FILTER_SHIFT		13
+#define TSP_TEXTURE_FILTER_POINT		(0 << TSP_TEXTURE_FILTER_SHIFT)
+#define TSP_TEXTURE_FILTER_BILINEAR		(1 << TSP_TEXTURE_FILTER_SHIFT)
+#define TSP_TEXTURE_FILTER_TRILINEAR_PASS_A	(2 << TSP_TEXTURE_FILTER_SHIFT)
+#define TSP_TEXTURE_FILTER_TRILINEAR_PASS_B	(3 << TSP_TEXTURE_FILTER_SHIFT)
+#define TSP_TEXTURE_FILTER_MASK			(3 << TSP_TEXTURE_FILTER_SHIFT)
+
+// Texture super sampling enable, bit 12
+#define TSP_SUPER_SAMPLING_SHIFT		12
+#define TSP_SUPER_SAMPLING_DISABLE		(0 << TSP_SUPER_SAMPLING_SHIFT)
+#define TSP_SUPER_SAMPLING_ENABLE		(1 << TSP_SUPER_SAMPLING_SHIFT)
+#define TSP_SUPER_SAMPLING_MASK			(1 << TSP_SUPER_SAMPLING_SHIFT)
+
+// Mipmap adjust, bits 11-8
+#define TSP_MIPMAP_ADJUST_SHIFT			8
+#define TSP_MIPMAP_ADJUST_0_25			(1 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_0_50			(2 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_0_75			(3 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_1_00			(4 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_1_25			(5 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_1_50			(6 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_1_75			(7 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_2_00			(8 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_2_25			(9 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_2_50			(10 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_2_75			(11 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_3_00			(12 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_3_25			(13 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_3_50			(14 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_3_75			(15 << TSP_MIPMAP_ADJUST_SHIFT)
+#define TSP_MIPMAP_ADJUST_MASK			(15 << TSP_MIPMAP_ADJUST_SHIFT)
+
+// Texture shading instruction, bits 7-6
+#define TSP_TEXTURE_INSTRUCTION_SHIFT		6
+#define TSP_TEXTURE_INSTRUCTION_DECAL		(0 << TSP_TEXTURE_INSTRUCTION_SHIFT)
+#define TSP_TEXTURE_INSTRUCTION_MODULATE	(1 << TSP_TEXTURE_INSTRUCTION_SHIFT)
+#define TSP_TEXTURE_INSTRUCTION_DECAL_ALPHA	(2 << TSP_TEXTURE_INSTRUCTION_SHIFT)
+#define TSP_TEXTURE_INSTRUCTION_MODULATE_ALPHA	(3 << TSP_TEXTURE_INSTRUCTION_SHIFT)
+#define TSP_TEXTURE_INSTRUCTION_MASK		(3 << TSP_TEXTURE_INSTRUCTION_SHIFT)
+
+// Texture U size, bits 5-3
+#define TSP_TEXTURE_U_SIZE_SHIFT		3
+#define TSP_TEXTURE_U_SIZE_8			(0 << TSP_TEXTURE_U_SIZE_SHIFT)
+#define TSP_TEXTURE_U_SIZE_16			(1 << TSP_TEXTURE_U_SIZE_SHIFT)
+#define TSP_TEXTURE_U_SIZE_32			(2 << TSP_TEXTURE_U_SIZE_SHIFT)
+#define TSP_TEXTURE_U_SIZE_64			(3 << TSP_TEXTURE_U_SIZE_SHIFT)
+#define TSP_TEXTURE_U_SIZE_128			(4 << TSP_TEXTURE_U_SIZE_SHIFT)
+#define TSP_TEXTURE_U_SIZE_256			(5 << TSP_TEXTURE_U_SIZE_SHIFT)
+#define TSP_TEXTURE_U_SIZE_512			(6 << TSP_TEXTURE_U_SIZE_SHIFT)
+#define TSP_TEXTURE_U_SIZE_1024			(7 << TSP_TEXTURE_U_SIZE_SHIFT)
+#define TSP_TEXTURE_U_SIZE_MASK			(7 << TSP_TEXTURE_U_SIZE_SHIFT)
+
+// Texture V size, bits 2-0
+#define TSP_TEXTURE_V_SIZE_SHIFT		0
+#define TSP_TEXTURE_V_SIZE_8			(0 << TSP_TEXTURE_V_SIZE_SHIFT)
+#define TSP_TEXTURE_V_SIZE_16			(1 << TSP_TEXTURE_V_SIZE_SHIFT)
+#define TSP_TEXTURE_V_SIZE_32			(2 << TSP_TEXTURE_V_SIZE_SHIFT)
+#define TSP_TEXTURE_V_SIZE_64			(3 << TSP_TEXTURE_V_SIZE_SHIFT)
+#define TSP_TEXTURE_V_SIZE_128			(4 << TSP_TEXTURE_V_SIZE_SHIFT)
+#define TSP_TEXTURE_V_SIZE_256			(5 << TSP_TEXTURE_V_SIZE_SHIFT)
+#define TSP_TEXTURE_V_SIZE_512			(6 << TSP_TEXTURE_V_SIZE_SHIFT)
+#define TSP_TEXTURE_V_SIZE_1024			(7 << TSP_TEXTURE_V_SIZE_SHIFT)
+#define TSP_TEXTURE_V_SIZE_MASK			(7 << TSP_TEXTURE_V_SIZE_SHIFT)
+
+/////////////////////////////////////////////////////
+// Texture control word                            //
+/////////////////////////////////////////////////////
+
+// Mipmapped, bit 31
+#define TCW_MIPMAP_SHIFT			31
+#define TCW_MIPMAP_DISABLED			(0u << TCW_MIPMAP_SHIFT)
+#define TCW_MIPMAP_ENABLED			(1u << TCW_MIPMAP_SHIFT)
+#define TCW_MIPMAP_MASK				(1u << TCW_MIPMAP_SHIFT)
+
+// VQ compressed, bit 30
+#define TCW_VQ_COMPRESSED_SHIFT			30
+#define TCW_VQ_COMPRESSED_DISABLED		(0 << TCW_VQ_COMPRESSED_SHIFT)
+#define TCW_VQ_COMPRESSED_ENABLED		(1 << TCW_VQ_COMPRESSED_SHIFT)
+#define TCW_VQ_COMPRESSED_MASK			(1 << TCW_VQ_COMPRESSED_SHIFT)
+
+// Texture format, bits 29-27
+#define TCW_PIXEL_FORMAT_SHIFT			27
+#define TCW_PIXEL_FORMAT_ARGB1555		(0 << TCW_PIXEL_FORMAT_SHIFT)
+#define TCW_PIXEL_FORMAT_RGB565			(1 << TCW_PIXEL_FORMAT_SHIFT)
+#define TCW_PIXEL_FORMAT_ARGB4444		(2 << TCW_PIXEL_FORMAT_SHIFT)
+#define TCW_PIXEL_FORMAT_YUV422			(3 << TCW_PIXEL_FORMAT_SHIFT)
+#define TCW_PIXEL_FORMAT_BUMP_MAP		(4 << TCW_PIXEL_FORMAT_SHIFT)
+#define TCW_PIXEL_FORMAT_PAL_4BPP		(5 << TCW_PIXEL_FORMAT_SHIFT)
+#define TCW_PIXEL_FORMAT_PAL_8BPP		(6 << TCW_PIXEL_FORMAT_SHIFT)
+#define TCW_PIXEL_FORMAT_MASK			(7 << TCW_PIXEL_FORMAT_SHIFT)
+
+// Twiddled (for non-paletted textures), bit 26
+#define TCW_TWIDDLED_SHIFT			26
+#define TCW_TWIDDLED_DISABLED			(1 << TCW_TWIDDLED_SHIFT)
+#define TCW_TWIDDLED_ENABLED			(0 << TCW_TWIDDLED_SHIFT)
+#define TCW_TWIDDLED_MASK			(1 << TCW_TWIDDLED_SHIFT)
+
+// Stride enable (for non-paletted textures), bit 25
+#define TCW_STRIDE_SHIFT			25
+#define TCW_STRIDE_DISABLED			(0 << TCW_STRIDE_SHIFT)
+#define TCW_STRIDE_ENABLED			(1 << TCW_STRIDE_SHIFT)
+#define TCW_STRIDE_MASK				(1 << TCW_STRIDE_SHIFT)
+
+// Palette index (for paletted textures), bits 26-21
+#define TCW_PALETTE_INDEX_4BPP_SHIFT		21
+#define TCW_PALETTE_INDEX_4BPP_MASK		(63 << TCW_PALETTE_INDEX_4BPP_SHIFT)
+#define TCW_PALETTE_INDEX_8BPP_SHIFT		25
+#define TCW_PALETTE_INDEX_8BPP_MASK		(63 << TCW_PALETTE_INDEX_8BPP_SHIFT)
+
+// Texture address, bits 20-0
+#define TCW_TEXTURE_ADDRESS(addr)		((((uint32)(uintptr_t)(void*)(addr))&0x7fffff)>>3)
+#define TCW_TEXTURE_ADDRESS_MASK		(0x000FFFFF)
+
+/////////////////////////////////////////////////////
+// User tile clip                                  //
+/////////////////////////////////////////////////////
+
+// Largest tile coordinates, X is bits 5-0 and Y is bits 3-0
+#define TILE_CLIP_X_MAX				0x3F
+#define TILE_CLIP_Y_MAX				0x0F
+
+/////////////////////////////////////////////////////
+// Strip header words                              //
+/////////////////////////////////////////////////////
+
+// Used to index the "words" array of a strip header
+#define PCW	0
+#define ISPTSP	1
+#define TSP0	2
+#define TCW0	3
+#define TSP1	4
+#define TCW1	5
+
+// There's an "allowed" system in place to make sure bits aren't set for
+// header types where they cannot be changed.
+// These will help a lot for setting up "allowed masks".
+#define BIT(n)			(1<<(n))
+// All polygon types
+#define TYPES_POLYGON		(BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4)|BIT(5)|BIT(6)|BIT(7)|BIT(8)|BIT(9)|BIT(10)|BIT(11)|BIT(12)|BIT(13)|BIT(14))
+// All sprite types
+#define TYPES_SPRITE		(BIT(15)|BIT(16))
+// Modifier type
+#define TYPES_MODIFIER  	(BIT(17))
+// Polygons and sprites
+#define TYPES_POLYSPRITE	(TYPES_POLYGON|TYPES_SPRITE)
+// All types
+#define TYPES_ALL		(TYPES_POLYGON|TYPES_SPRITE|TYPES_MODIFIER)
+// Textured types
+#define TYPES_TEXTURED		(BIT(3)|BIT(4)|BIT(5)|BIT(6)|BIT(7)|BIT(8)|BIT(11)|BIT(12)|BIT(13)|BIT(14)|BIT(16))
+// Types affected by cheap shadow modifiers
+#define TYPES_SHADOW		(BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4)|BIT(5)|BIT(6)|BIT(7)|BIT(8))
+// Types affected by two-parameter modifiers
+#define TYPES_POLYGON_2		(BIT(9)|BIT(10)|BIT(11)|BIT(12)|BIT(13)|BIT(14))
+// Textured types affected by two-parameter modifiers
+#define TYPES_TEXTURED_2	(TYPES_POLYGON_2 & TYPES_TEXTURED)
+// Intensity color types
+#define TYPES_INTENSITY		(BIT(2)|BIT(7)|BIT(8)|BIT(10)|BIT(13)|BIT(14))
+// Types that can be stored as a compact header (no colors in the header)
+#define TYPES_COMPACT		(TYPES_ALL & ~TYPES_INTENSITY)
+
+/////////////////////////////////////////////////////
+// Default header words                            //
+/////////////////////////////////////////////////////
+
+// The defaults are also used by the C++ layer, which needs them
+// to be usable in constant expressions. It gets them in sh::detail,
+// so they don't end up in the global namespace of its users.
+#ifdef __cplusplus
+#define SH_CONST constexpr
+namespace sh { namespace detail {
+#else
+#define SH_CONST const
+#endif
+
+// Default parameter control words (just OR in the list and you're set)
+static SH_CONST uint32 default_pcw[18] = 
+{
+/*00*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_DISABLE | PCW_SHADING_GOURAUD,
+/*01*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_FLOAT     | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_DISABLE | PCW_SHADING_GOURAUD,
+/*02*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_DISABLE | PCW_SHADING_GOURAUD,
+/*03*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_32BIT,
+/*04*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_16BIT,
+/*05*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_FLOAT     | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_32BIT,
+/*06*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_FLOAT     | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_16BIT,
+/*07*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_32BIT,
+/*08*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_16BIT,
+/*09*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_DISABLE | PCW_SHADING_GOURAUD,
+/*10*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_DISABLE | PCW_SHADING_GOURAUD,
+/*11*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_32BIT,
+/*12*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_16BIT,
+/*13*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_32BIT,
+/*14*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_16BIT,
+/*15*/	PCW_TYPE_SPRITE   | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_TEXTURE_DISABLE  | PCW_SHADING_FLAT,
+/*16*/	PCW_TYPE_SPRITE   | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_TEXTURE_ENABLE   | PCW_SHADING_FLAT | PCW_UV_16BIT,
+/*17*/	PCW_TYPE_MODIFIER | PCW_MODIFIER_TRIANGLE
+};
+
+// Default isp/tsp words
+static SH_CONST uint32 default_isptsp = ISP_TSP_DEPTH_COMPARE_GREATER_OR_EQUAL | ISP_TSP_CULL_MODE_NONE | ISP_TSP_Z_WRITE_ENABLE | ISP_TSP_DCALC_DISABLE;
+static SH_CONST uint32 default_isptsp_mod = ISP_TSP_VOLUME_INSTRUCTION_NORMAL | ISP_TSP_CULL_MODE_NONE;
+
+// Default tsp words
+#define TSP_BASE ( TSP_SRC_SELECT_DISABLE | TSP_DST_SELECT_DISABLE | TSP_FOG_MODE_DISABLE | TSP_COLOR_CLAMP_DISABLE | TSP_UV_FLIP_NONE | TSP_UV_CLAMP_NONE | TSP_TEXTURE_FILTER_POINT | TSP_SUPER_SAMPLING_DISABLE | TSP_MIPMAP_ADJUST_1_00 )
+static SH_CONST uint32 default_tsp_alpha   = TSP_BASE | TSP_ALPHA_ENABLE  | TSP_TEXTURE_ALPHA_ENABLE  | TSP_SRC_ALPHA_INSTR_SRC_ALPHA | TSP_DST_ALPHA_INSTR_INVERSE_SRC_ALPHA | TSP_TEXTURE_INSTRUCTION_MODULATE_ALPHA;
+static SH_CONST uint32 default_tsp_noalpha = TSP_BASE | TSP_ALPHA_DISABLE | TSP_TEXTURE_ALPHA_DISABLE | TSP_SRC_ALPHA_INSTR_ONE       | TSP_DST_ALPHA_INSTR_ZERO              | TSP_TEXTURE_INSTRUCTION_MODULATE;
+
+/////////////////////////////////////////////////////
+// Capabilities                                    //
+/////////////////////////////////////////////////////
+
+// What enabling/disabling each capability does to a header.
+typedef struct
+{
+    int		word;
+    uint32	allowed_types;
+    uint32	bitmask;
+    uint32	tval;
+    uint32	fval;
+} capability_t;
+
+// Indexed by SHCAPABILITY, so keep it in the same order.
+static SH_CONST capability_t capabilities[] =
+{
+/*SH_AFFECTED_BY_MODIFIER*/	{ PCW,    TYPES_SHADOW,     PCW_MODIFIER_MASK,       PCW_MODIFIER_ENABLE,           PCW_MODIFIER_DISABLE },
+/*SH_SMOOTH_SHADING*/		{ PCW,    TYPES_POLYGON,    PCW_SHADING_MASK,        PCW_SHADING_GOURAUD,           PCW_SHADING_FLAT },
+/*SH_OFFSET_COLOR*/		{ PCW,    TYPES_TEXTURED,   PCW_OFFSET_COLOR_MASK,   PCW_OFFSET_COLOR_ENABLE,       PCW_OFFSET_COLOR_DISABLE },
+/*SH_USE_PREVIOUS_COLOR*/	{ PCW,    TYPES_INTENSITY,  PCW_COLOR_TYPE_MASK,     PCW_COLOR_TYPE_PREV_INTENSITY, PCW_COLOR_TYPE_INTENSITY },
+/*SH_DCALC_CONTROL*/		{ ISPTSP, TYPES_TEXTURED,   ISP_TSP_DCALC_MASK,      ISP_TSP_DCALC_ENABLE,          ISP_TSP_DCALC_DISABLE },
+/*SH_ALPHA*/			{ TSP0,   TYPES_POLYSPRITE, TSP_ALPHA_MASK,          TSP_ALPHA_ENABLE,              TSP_ALPHA_DISABLE },
+/*SH_ALPHA_2*/			{ TSP1,   TYPES_POLYGON_2,  TSP_ALPHA_MASK,          TSP_ALPHA_ENABLE,              TSP_ALPHA_DISABLE },
+/*SH_SRC_SELECT*/		{ TSP0,   TYPES_POLYSPRITE, TSP_SRC_SELECT_MASK,     TSP_SRC_SELECT_ENABLE,         TSP_SRC_SELECT_DISABLE },
+/*SH_SRC_SELECT_2*/		{ TSP1,   TYPES_POLYGON_2,  TSP_SRC_SELECT_MASK,     TSP_SRC_SELECT_ENABLE,         TSP_SRC_SELECT_DISABLE },
+/*SH_DST_SELECT*/		{ TSP0,   TYPES_POLYSPRITE, TSP_DST_SELECT_MASK,     TSP_DST_SELECT_ENABLE,         TSP_DST_SELECT_DISABLE },
+/*SH_DST_SELECT_2*/		{ TSP1,   TYPES_POLYGON_2,  TSP_DST_SELECT_MASK,     TSP_DST_SELECT_ENABLE,         TSP_DST_SELECT_DISABLE },
+/*SH_TEXTURE_ALPHA*/		{ TSP0,   TYPES_TEXTURED,   TSP_TEXTURE_ALPHA_MASK,  TSP_TEXTURE_ALPHA_ENABLE,      TSP_TEXTURE_ALPHA_DISABLE },
+/*SH_TEXTURE_ALPHA_2*/		{ TSP1,   TYPES_TEXTURED_2, TSP_TEXTURE_ALPHA_MASK,  TSP_TEXTURE_ALPHA_ENABLE,      TSP_TEXTURE_ALPHA_DISABLE },
+/*SH_TEX_SUPER_SAMPLING*/	{ TSP0,   TYPES_TEXTURED,   TSP_SUPER_SAMPLING_MASK, TSP_SUPER_SAMPLING_ENABLE,     TSP_SUPER_SAMPLING_DISABLE },
+/*SH_TEX_SUPER_SAMPLING_2*/	{ TSP1,   TYPES_TEXTURED_2, TSP_SUPER_SAMPLING_MASK, TSP_SUPER_SAMPLING_ENABLE,     TSP_SUPER_SAMPLING_DISABLE },
+/*SH_DEPTH_WRITE*/		{ ISPTSP, TYPES_POLYSPRITE, ISP_TSP_Z_WRITE_MASK,    ISP_TSP_Z_WRITE_ENABLE,        ISP_TSP_Z_WRITE_DISABLE }
+};
+
+#define NUM_CAPABILITIES	( sizeof(capabilities) / sizeof(capabilities[0]) )
+
+// Fails to compile if a capability has been added to SHCAPABILITY but not here
+typedef char capabilities_match_enum[( NUM_CAPABILITIES == SH_DEPTH_WRITE + 1 ) ? 1 : -1];
+
+/////////////////////////////////////////////////////
+// Textures                                        //
+/////////////////////////////////////////////////////
+
+// Generates the texture control word and the texture size bits of the tsp
+// word for a texture. Returns 0 if the size isn't a power of two in 8..1024.
+static inline int texture_words( const texture_t* tex, uint32* tsp_out, uint32* tcw_out )
+{
+    uint32 tsp = 0, tcw = 0;
+    int paletted = 0;
+
+    switch ( tex->width )
+    {
+        case 8:		tsp |= TSP_TEXTURE_U_SIZE_8;	break;
+        case 16:	tsp |= TSP_TEXTURE_U_SIZE_16;	break;
+        case 32:	tsp |= TSP_TEXTURE_U_SIZE_32;	break;
+        case 64:	tsp |= TSP_TEXTURE_U_SIZE_64;	break;
+        case 128:	tsp |= TSP_TEXTURE_U_SIZE_128;	break;
+        case 256:	tsp |= TSP_TEXTURE_U_SIZE_256;	break;
+        case 512:	tsp |= TSP_TEXTURE_U_SIZE_512;	break;
+        case 1024:	tsp |= TSP_TEXTURE_U_SIZE_1024;	break;
+        default:	return 0;
+    }
+
+    switch ( tex->height )
+    {
+        case 8:		tsp |= TSP_TEXTURE_V_SIZE_8;	break;
+        case 16:	tsp |= TSP_TEXTURE_V_SIZE_16;	break;
+        case 32:	tsp |= TSP_TEXTURE_V_SIZE_32;	break;
+        case 64:	tsp |= TSP_TEXTURE_V_SIZE_64;	break;
+        case 128:	tsp |= TSP_TEXTURE_V_SIZE_128;	break;
+        case 256:	tsp |= TSP_TEXTURE_V_SIZE_256;	break;
+        case 512:	tsp |= TSP_TEXTURE_V_SIZE_512;	break;
+        case 1024:	tsp |= TSP_TEXTURE_V_SIZE_1024;	break;
+        default:	return 0;
+    }
+
+    // Mipmap and compression flags
+    tcw |= ( ( tex->flags & TEXFLAG_MIPMAPPED ) ? TCW_MIPMAP_ENABLED : TCW_MIPMAP_DISABLED );
+    tcw |= ( ( tex->flags & TEXFLAG_COMPRESSED ) ? TCW_VQ_COMPRESSED_ENABLED : TCW_VQ_COMPRESSED_DISABLED );
+
+    // Format
+    switch ( tex->format )
+    {
+        case TEXFMT_RGB565:	tcw |= TCW_PIXEL_FORMAT_RGB565;		paletted = 0;	break;
+        case TEXFMT_ARGB1555:	tcw |= TCW_PIXEL_FORMAT_ARGB1555;	paletted = 0;	break;
+        case TEXFMT_ARGB4444:	tcw |= TCW_PIXEL_FORMAT_ARGB4444;	paletted = 0;	break;
+        case TEXFMT_PAL4BPP:	tcw |= TCW_PIXEL_FORMAT_PAL_4BPP;	paletted = 1;	break;
+        case TEXFMT_PAL8BPP:	tcw |= TCW_PIXEL_FORMAT_PAL_8BPP;	paletted = 1;	break;
+    }
+
+    // Paletted textures are assumed to be twiddled and doesn't allow stride.
+    // This is because these settings occupy the same bits as palette index.
+    if ( !paletted )
+    {
+        tcw |= ( ( tex->flags & TEXFLAG_TWIDDLED ) ? TCW_TWIDDLED_ENABLED : TCW_TWIDDLED_DISABLED );
+        tcw |= TCW_STRIDE_DISABLED;
+    }
+
+    // Texture address
+    tcw |= TCW_TEXTURE_ADDRESS( tex->vram_ptr );
+
+    *tsp_out = tsp;
+    *tcw_out = tcw;
+    return 1;
+}
+
+/////////////////////////////////////////////////////
+// Vertex data                                     //
+/////////////////////////////////////////////////////
+
+// Raw bits of a float, for writing floats into the word stream
+static inline uint32 float_bits( float f )
+{
+    union { float f; uint32 u; } c;
+    c.f = f;
+    return c.u;
+}
+
+// Packs a pair of texture coordinates into a 16-bit UV word.
+// Each coordinate is the upper half of its float representation.
+static inline uint32 pack_uv16( float u, float v )
+{
+    return ( float_bits( u ) & 0xFFFF0000 ) | ( float_bits( v ) >> 16 );
+}
+
+#ifdef __cplusplus
+} } // namespace sh::detail
+#endif
+
+/////////////////////////////////////////////////////
+// Store queues                                    //
+/////////////////////////////////////////////////////
+
+// Store queue flush. This is only meaningful on the SH4, so it compiles to
+// nothing anywhere else. That way the header path can be built and measured
+// on a host machine against stand-ins for kos.h and shtexture.h.
+#if defined(__SH4__) || defined(_arch_dreamcast)
+#define PREFETCH(addr) __asm__ __volatile__("pref @%0" : : "r" (addr))
+#elif defined(SH_FLUSH_HOOK)
+// Host tests can name a function of their own here to see where, and in
+// which order, bursts are flushed.
+void SH_FLUSH_HOOK( void* addr );
+#define PREFETCH(addr) SH_FLUSH_HOOK( (void*)(addr) )
+#else
+#define PREFETCH(addr) ((void)(addr))
+#endif
+
+/////////////////////////////////////////////////////
+// Error reporting                                 //
+/////////////////////////////////////////////////////
+
+// Reports an error through the current context, error ring or handler.
+// hdr and type describe what the error happened on, for deferred errors.
+// Every source file reports errors through this, so they all behave the
+// same way, and SH_NO_VALIDATION compiles all of them out.
+#ifdef SH_NO_VALIDATION
+#define report_error( err, fnname, hdr, type )	((void)(fnname), (void)(hdr))
+#else
+void sh_report_error( SHERROR err, const char* fnname, const void* hdr, uint32 type );
+#define report_error( err, fnname, hdr, type )	sh_report_error( err, fnname, hdr, type )
+#endif
+
+/////////////////////////////////////////////////////
+// Statistics                                      //
+/////////////////////////////////////////////////////
+
+// Counters only exist when built with SH_STATS (or SH_STATS_TIMING, which
+// also times shCommit). Otherwise they compile to nothing.
+#if defined(SH_STATS_TIMING) && !defined(SH_STATS)
+#define SH_STATS
+#endif
+
+#ifdef SH_STATS
+// Defined in stripheader.c and counted into from every file, by any thread
+extern shstats_t sh_stats;
+#define STAT_ADD(field, n)	((void)__atomic_fetch_add( &sh_stats.field, (n), __ATOMIC_RELAXED ))
+#else
+#define STAT_ADD(field, n)	((void)0)
+#endif
+
+// Cycle counter used by SH_STATS_TIMING. Define SH_STATS_CYCLES before
+// building to use something else. On the Dreamcast, performance counter 0
+// must be started in cycle count mode by the program.
+#if defined(SH_STATS_TIMING) && !defined(SH_STATS_CYCLES)
+#if defined(_arch_dreamcast)
+#include <dc/perfctr.h>
+#define SH_STATS_CYCLES()	perf_cntr_count( PRFC0 )
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define SH_STATS_CYCLES()	__rdtsc()
+#else
+#define SH_STATS_CYCLES()	0
+#endif
+#endif
+
+#endif // __SHDEFS_H__
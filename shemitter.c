@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shemitter.h"
+#include "shdefs.h"
+
+void shEmitterInit( shemitter_t* em )
+{
+    int i;
+
+    shEmitterReset( em );
+    shEmitterResetStats( em );
+
+    em->auto_strip_length = 0;
+    for ( i = 0; i < SH_EMITTER_STRIP_SLOTS; i++ )
+    {
+        em->strip_slots[i].hdr = NULL;
+        em->strip_slots[i].avg = 0;
+    }
+}
+
+void shEmitterReset( shemitter_t* em )
+{
+    int i;
+
+    for ( i = 0; i < SH_EMITTER_LISTS; i++ )
+        em->last_size[i] = 0;
+}
+
+void shEmitterResetList( shemitter_t* em, pvr_list_t list )
+{
+    if ( (uint32)list < SH_EMITTER_LISTS )
+        em->last_size[list] = 0;
+}
+
+void shEmitterResetStats( shemitter_t* em )
+{
+    em->headers_emitted = 0;
+    em->headers_elided = 0;
+    em->bytes_emitted = 0;
+    em->bytes_elided = 0;
+    em->strips = 0;
+    em->strip_triangles = 0;
+    em->strip_pointers = 0;
+}
+
+// Returns 1 if the block is the same as the one last sent
+static inline int same_block( const uint32* last, uint32 last_size, const uint32* block, uint32 size )
+{
+    uint32 i;
+
+    if ( last_size != size )
+        return 0;
+
+    // The PCW and TSP words are the ones most likely to differ,
+    // so test those first to bail out early.
+    if ( last[0] != block[0] || last[2] != block[2] || last[3] != block[3] )
+        return 0;
+
+    for ( i = 1; i < size; i++ )
+    {
+        if ( last[i] != block[i] )
+            return 0;
+    }
+
+    return 1;
+}
+
+int shEmit( shemitter_t* em, stripheader_t* hdr, uint32* ptr )
+{
+    shblock_t block;
+    uint32 list, size, i;
+
+    // Errors have already been reported if this fails
+    size = shBake( hdr, &block );
+    if ( size == 0 )
+        return 0;
+
+    list = ( hdr->words[PCW] & PCW_LIST_MASK ) >> PCW_LIST_SHIFT;
+
+    if ( hdr->type != 17 && list < SH_EMITTER_LISTS &&
+            same_block( em->last[list], em->last_size[list], block.words, size ) )
+    {
+        em->headers_elided++;
+        em->bytes_elided += size * 4;
+        return 0;
+    }
+
+    shCommitBlock( &block, ptr );
+
+    if ( list < SH_EMITTER_LISTS )
+    {
+        for ( i = 0; i < size; i++ )
+            em->last[list][i] = block.words[i];
+        em->last_size[list] = size;
+    }
+
+    em->headers_emitted++;
+    em->bytes_emitted += size * 4;
+    return size;
+}
+
+void shEmitterAutoStripLength( shemitter_t* em, int enable )
+{
+    em->auto_strip_length = ( enable != 0 );
+}
+
+// Triangles per object pointer for each SHSTRIPLENGTH
+static const uint32 strip_length_tris[4] = { 1, 2, 4, 6 };
+
+// The longest strip length that doesn't go past the average strip
+static inline uint32 pick_strip_length( uint32 avg )
+{
+    if ( avg >= ( 6 << 4 ) )
+        return SH_STRIP_LENGTH_6;
+    if ( avg >= ( 4 << 4 ) )
+        return SH_STRIP_LENGTH_4;
+    if ( avg >= ( 2 << 4 ) )
+        return SH_STRIP_LENGTH_2;
+    return SH_STRIP_LENGTH_1;
+}
+
+int shEmitStrip( shemitter_t* em, stripheader_t* hdr, uint32* ptr, uint32 vertex_count )
+{
+    const uint32 tris = ( vertex_count > 2 ? vertex_count - 2 : 0 );
+    uint32 length;
+
+    // Only polygon strips are split by the strip length
+    if ( hdr->type > 14 || tris == 0 )
+        return shEmit( em, hdr, ptr );
+
+    if ( em->auto_strip_length )
+    {
+        const uint32 slot = ( (uintptr_t)hdr / sizeof(stripheader_t) ) % SH_EMITTER_STRIP_SLOTS;
+
+        // Moving average that follows changes within a few frames
+        if ( em->strip_slots[slot].hdr != hdr )
+        {
+            em->strip_slots[slot].hdr = hdr;
+            em->strip_slots[slot].avg = tris << 4;
+        }
+        else
+        {
+            em->strip_slots[slot].avg = ( em->strip_slots[slot].avg * 3 + ( tris << 4 ) ) / 4;
+        }
+
+        length = pick_strip_length( em->strip_slots[slot].avg );
+        if ( ( ( hdr->words[PCW] & PCW_STRIP_LENGTH_MASK ) >> PCW_STRIP_LENGTH_SHIFT ) != length )
+            shStripLength( hdr, length );
+    }
+
+    length = ( hdr->words[PCW] & PCW_STRIP_LENGTH_MASK ) >> PCW_STRIP_LENGTH_SHIFT;
+
+    em->strips++;
+    em->strip_triangles += tris;
+    em->strip_pointers += ( tris + strip_length_tris[length] - 1 ) / strip_length_tris[length];
+
+    return shEmit( em, hdr, ptr );
+}
@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Header emitter.
+
+ Wraps shCommit and remembers the last header block sent to each list.
+ If a header is committed that's identical to the previous one in the
+ same list, nothing is sent at all since the PVR state wouldn't change.
+ This is the common case when many strips share the same material.
+
+ Modifier volume headers (type 17) are always sent, as they mark where
+ volumes begin and end.
+*/
+
+#ifndef __SHEMITTER_H__
+#define __SHEMITTER_H__
+
+#include "stripheader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Number of lists tracked (OP, OP_MOD, TR, TR_MOD, PT)
+#define SH_EMITTER_LISTS	5
+
+// Number of materials tracked for automatic strip lengths.
+// Headers that map to the same slot share it.
+#define SH_EMITTER_STRIP_SLOTS	64
+
+typedef struct shemitter
+{
+    // Last block sent to each list and its size in words (0 if none)
+    uint32	last[SH_EMITTER_LISTS][16];
+    uint32	last_size[SH_EMITTER_LISTS];
+
+    // Statistics, these keep counting until shEmitterResetStats is called
+    uint32	headers_emitted;
+    uint32	headers_elided;
+    uint32	bytes_emitted;
+    uint32	bytes_elided;
+
+    // Strips sent through shEmitStrip, their triangles and the number of
+    // strip length groups they're split into. Each group takes one object
+    // pointer in every tile it touches.
+    uint32	strips;
+    uint32	strip_triangles;
+    uint32	strip_pointers;
+
+    // Automatic strip length
+    uint32	auto_strip_length;
+    struct
+    {
+        const stripheader_t*	hdr;
+        uint32			avg;	// Average triangles per strip, 4 fractional bits
+    } strip_slots[SH_EMITTER_STRIP_SLOTS];
+} shemitter_t;
+
+// Initializes an emitter with no previous headers and cleared statistics.
+void shEmitterInit( shemitter_t* em );
+
+// Forgets the last header sent to every list.
+// Call this whenever the lists are restarted (e.g. at the start of a frame).
+void shEmitterReset( shemitter_t* em );
+
+// Forgets the last header sent to a single list.
+// Call this if anything else than headers and vertices has been sent to it.
+void shEmitterResetList( shemitter_t* em, pvr_list_t list );
+
+// Clears the emitted/elided counters.
+void shEmitterResetStats( shemitter_t* em );
+
+// Commits a header through shCommit unless it's identical to the last
+// header sent to the same list.
+// Returns the number of 32-bit words written, which is 0 if the header was elided.
+int shEmit( shemitter_t* em, stripheader_t* hdr, uint32* ptr );
+
+// When enabled, shEmitStrip keeps a running average of the strip length
+// of each header and sets the header's strip length to match it.
+// Disabled by default.
+void shEmitterAutoStripLength( shemitter_t* em, int enable );
+
+// Same as shEmit, for a header that's followed by a strip of
+// vertex_count vertices. Updates the strip statistics and, if enabled,
+// picks the strip length of the header.
+int shEmitStrip( shemitter_t* em, stripheader_t* hdr, uint32* ptr, uint32 vertex_count );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHEMITTER_H__
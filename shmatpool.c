@@ -0,0 +1,197 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shmatpool.h"
+#include "shdefs.h"
+
+uint32 shMatPoolSize( uint32 capacity )
+{
+    // Six header words and the sprite color, then one byte for the type
+    return capacity * 7 * sizeof(uint32) + capacity;
+}
+
+void shMatPoolInit( shmatpool_t* pool, void* mem, uint32 capacity )
+{
+    uint32* p = (uint32*)mem;
+    int i;
+
+    for ( i = 0; i < 6; i++, p += capacity )
+        pool->words[i] = p;
+
+    pool->sprColor = p;
+    pool->type = (uint8*)( p + capacity );
+    pool->count = 0;
+    pool->capacity = capacity;
+}
+
+int shMatPoolAdd( shmatpool_t* pool, const shcompact_t* c )
+{
+    if ( pool->count >= pool->capacity )
+        return -1;
+
+    // Only what a compact header can hold, see shcompact_t
+    if ( c->type > 17 || !( TYPES_COMPACT & BIT( c->type ) ) )
+    {
+        report_error( ( c->type > 17 ? SH_ERROR_INVALID_TYPE : SH_ERROR_NOT_ALLOWED ), __func__, c, c->type );
+        return -1;
+    }
+
+    shMatPoolSet( pool, pool->count, c );
+    return pool->count++;
+}
+
+void shMatPoolGet( const shmatpool_t* pool, uint32 index, shcompact_t* c )
+{
+    int i;
+
+    c->type = pool->type[index];
+    for ( i = 0; i < 6; i++ )
+        c->words[i] = pool->words[i][index];
+    c->sprColor = pool->sprColor[index];
+}
+
+void shMatPoolSet( shmatpool_t* pool, uint32 index, const shcompact_t* c )
+{
+    int i;
+
+    pool->type[index] = c->type;
+    for ( i = 0; i < 6; i++ )
+        pool->words[i][index] = c->words[i];
+    pool->sprColor[index] = c->sprColor;
+}
+
+// Returns a bitfield of the types used in a range.
+// Invalid types show up as bit 31.
+static uint32 range_types( const shmatpool_t* pool, uint32 first, uint32 count )
+{
+    uint32 types = 0, i;
+
+    for ( i = first; i < first + count; i++ )
+        types |= ( pool->type[i] < 18 ? BIT( pool->type[i] ) : BIT( 31 ) );
+
+    return types;
+}
+
+// Checks that a range is in the pool and only holds types from <allowed>.
+// Returns the types used in the range, or 0 after reporting an error.
+static uint32 check_range( const shmatpool_t* pool, const char* fnname, uint32 first, uint32 count, uint32 allowed )
+{
+    uint32 types;
+
+    if ( first > pool->count || count > pool->count - first )
+    {
+        report_error( SH_ERROR_OUT_OF_RANGE, fnname, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    types = range_types( pool, first, count );
+    if ( types & ~TYPES_ALL )
+    {
+        report_error( SH_ERROR_INVALID_TYPE, fnname, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    if ( types & ~allowed )
+    {
+        report_error( SH_ERROR_NOT_ALLOWED, fnname, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    return types;
+}
+
+int shMatPoolSetState( shmatpool_t* pool, uint32 first, uint32 count, const SHSTATE* state )
+{
+    uint32 clear[6], set[6];
+    uint32 types, t, i;
+    int w;
+
+    if ( count == 0 )
+        return 1;
+
+    // The masks only depend on the state, the type is just checked against
+    // them. Check every type in the range before anything is touched.
+    types = check_range( pool, __func__, first, count, TYPES_ALL );
+    if ( types == 0 )
+        return 0;
+
+    for ( t = 0; t < 18; t++ )
+    {
+        if ( ( types & BIT( t ) ) && !shStateMasks( t, state, clear, set ) )
+            return 0;
+    }
+
+    // One word array at a time, skipping words the state doesn't touch
+    for ( w = 0; w < 6; w++ )
+    {
+        uint32* words = pool->words[w] + first;
+        const uint32 c = clear[w], s = set[w];
+
+        if ( c == 0 )
+            continue;
+
+        for ( i = 0; i < count; i++ )
+            words[i] = ( words[i] & ~c ) | s;
+    }
+
+    return 1;
+}
+
+// Sets the texture of a range, in the tsp/tcw word pair given.
+static int set_texture( shmatpool_t* pool, const char* fnname, int tsp_word, int tcw_word, uint32 allowed,
+                        uint32 first, uint32 count, const shtexturedesc_t* desc )
+{
+    const uint32 tsp = ( desc != NULL ? desc->tsp : 0 );
+    const uint32 tcw = ( desc != NULL ? desc->tcw : 0 );
+    uint32* tsps = pool->words[tsp_word] + first;
+    uint32* tcws = pool->words[tcw_word] + first;
+    uint32 i;
+
+    if ( count == 0 )
+        return 1;
+
+    if ( !check_range( pool, fnname, first, count, allowed ) )
+        return 0;
+
+    STAT_ADD( setter_calls, 1 );
+    STAT_ADD( texture_binds, count );
+
+    for ( i = 0; i < count; i++ )
+    {
+        tsps[i] = ( tsps[i] & ~( TSP_TEXTURE_U_SIZE_MASK | TSP_TEXTURE_V_SIZE_MASK ) ) | tsp;
+        tcws[i] = tcw;
+    }
+
+    return 1;
+}
+
+int shMatPoolTexture( shmatpool_t* pool, uint32 first, uint32 count, const shtexturedesc_t* desc )
+{
+    return set_texture( pool, __func__, TSP0, TCW0, TYPES_TEXTURED, first, count, desc );
+}
+
+int shMatPoolTexture2( shmatpool_t* pool, uint32 first, uint32 count, const shtexturedesc_t* desc )
+{
+    return set_texture( pool, __func__, TSP1, TCW1, TYPES_TEXTURED_2, first, count, desc );
+}
+
+int shMatPoolCommit( const shmatpool_t* pool, uint32 index, uint32* ptr )
+{
+    shcompact_t c;
+
+    shMatPoolGet( pool, index, &c );
+    return shCompactCommit( &c, ptr );
+}
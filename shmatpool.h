@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Material pools.
+
+ A structure-of-arrays store for compact headers. Each header word lives
+ in its own array, so bulk updates such as changing the blend mode or
+ texture of a range of materials only touch the words they change instead
+ of whole headers.
+
+ Materials are referred to by index. A pool never grows, the storage is
+ given to shMatPoolInit and must be at least shMatPoolSize( capacity ) bytes.
+*/
+
+#ifndef __SHMATPOOL_H__
+#define __SHMATPOOL_H__
+
+#include "stripheader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct shmatpool
+{
+    uint32*	words[6];	// words[PCW][index] etc.
+    uint32*	sprColor;
+    uint8*	type;
+    uint32	count;
+    uint32	capacity;
+} shmatpool_t;
+
+// Returns how many bytes of storage a pool of the given capacity needs.
+uint32 shMatPoolSize( uint32 capacity );
+
+// Initializes an empty pool. mem must be 4-byte aligned.
+void shMatPoolInit( shmatpool_t* pool, void* mem, uint32 capacity );
+
+// Adds a material and returns its index, or -1 if the pool is full or the
+// type can't be held by a compact header.
+int shMatPoolAdd( shmatpool_t* pool, const shcompact_t* c );
+
+// Reads or replaces a single material.
+void shMatPoolGet( const shmatpool_t* pool, uint32 index, shcompact_t* c );
+void shMatPoolSet( shmatpool_t* pool, uint32 index, const shcompact_t* c );
+
+// Applies a state to count materials starting at first.
+// If the state isn't valid for every material in the range, nothing is changed.
+// A range past the end of the pool fails with SH_ERROR_OUT_OF_RANGE.
+int shMatPoolSetState( shmatpool_t* pool, uint32 first, uint32 count, const SHSTATE* state );
+
+// Sets the texture of count materials starting at first. NULL clears it.
+// Every material in the range must be textured, or for shMatPoolTexture2,
+// a textured two-parameter type.
+int shMatPoolTexture( shmatpool_t* pool, uint32 first, uint32 count, const shtexturedesc_t* desc );
+int shMatPoolTexture2( shmatpool_t* pool, uint32 first, uint32 count, const shtexturedesc_t* desc );
+
+// Same as shCompactCommit for a material in the pool.
+int shMatPoolCommit( const shmatpool_t* pool, uint32 index, uint32* ptr );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHMATPOOL_H__
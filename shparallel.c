@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shparallel.h"
+#include "shdefs.h"
+
+uint32 shParallelChunkCount( uint32 object_count, uint32 chunk_size )
+{
+    if ( chunk_size == 0 )
+    {
+        report_error( SH_ERROR_OUT_OF_RANGE, __func__, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    return object_count / chunk_size + ( object_count % chunk_size != 0 );
+}
+
+int shParallelInit( shparallel_t* par, shchunk_t* chunks, uint32 object_count, uint32 chunk_size )
+{
+    uint32 i;
+    int l;
+
+    par->next = 0;
+    par->object_count = object_count;
+    par->chunk_size = chunk_size;
+    par->chunk_count = 0;
+    par->chunks = chunks;
+
+    // Leaves a job with no chunks, so the workers stop right away
+    if ( chunk_size == 0 )
+    {
+        report_error( SH_ERROR_OUT_OF_RANGE, __func__, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    par->chunk_count = shParallelChunkCount( object_count, chunk_size );
+
+    for ( i = 0; i < par->chunk_count; i++ )
+    {
+        for ( l = 0; l < SH_CMDBUF_LISTS; l++ )
+        {
+            chunks[i].start[l] = NULL;
+            chunks[i].size[l] = 0;
+        }
+    }
+
+    return 1;
+}
+
+void shParallelWorkerInit( shworker_t* w, shparallel_t* par, shcmdbuf_t* cb, shemitter_t* em )
+{
+    w->par = par;
+    w->cb = cb;
+    w->em = em;
+    w->chunk = -1;
+}
+
+// Records how much of each list the current chunk wrote
+static void end_chunk( shworker_t* w )
+{
+    shchunk_t* c = &w->par->chunks[w->chunk];
+    int l;
+
+    for ( l = 0; l < SH_CMDBUF_LISTS; l++ )
+        c->size[l] = w->cb->lists[l].ptr - c->start[l];
+
+    w->chunk = -1;
+}
+
+int shParallelNext( shworker_t* w, uint32* first, uint32* count )
+{
+    shparallel_t* par = w->par;
+    shchunk_t* c;
+    uint32 index;
+    int l;
+
+    if ( w->chunk >= 0 )
+        end_chunk( w );
+
+    index = __atomic_fetch_add( &par->next, 1, __ATOMIC_RELAXED );
+    if ( index >= par->chunk_count )
+        return 0;
+
+    c = &par->chunks[index];
+    for ( l = 0; l < SH_CMDBUF_LISTS; l++ )
+        c->start[l] = w->cb->lists[l].ptr;
+
+    if ( w->em != NULL )
+        shEmitterReset( w->em );
+
+    w->chunk = index;
+    *first = index * par->chunk_size;
+    *count = par->object_count - *first;
+    if ( *count > par->chunk_size )
+        *count = par->chunk_size;
+
+    return 1;
+}
+
+int shParallelMerge( const shparallel_t* par, pvr_list_t list, uint32* ptr )
+{
+    uint32* const start = ptr;
+    uint32 i, j;
+
+    if ( (uint32)list >= SH_CMDBUF_LISTS )
+        return 0;
+
+    // Chunks are copied in whole 32-byte blocks, so one written with
+    // anything but whole blocks would be cut short or run into the next
+    for ( i = 0; i < par->chunk_count; i++ )
+    {
+        if ( ( par->chunks[i].size[list] & 7 ) != 0 )
+        {
+            report_error( SH_ERROR_INVALID_SIZE, __func__, NULL, SH_ERROR_NO_TYPE );
+            return 0;
+        }
+    }
+
+    for ( i = 0; i < par->chunk_count; i++ )
+    {
+        const uint32* src = par->chunks[i].start[list];
+        const uint32 size = par->chunks[i].size[list];
+
+        for ( j = 0; j < size; j += 8, src += 8, ptr += 8 )
+        {
+            ptr[0] = src[0];
+            ptr[1] = src[1];
+            ptr[2] = src[2];
+            ptr[3] = src[3];
+            ptr[4] = src[4];
+            ptr[5] = src[5];
+            ptr[6] = src[6];
+            ptr[7] = src[7];
+            PREFETCH( (void*)ptr );
+        }
+    }
+
+    return ptr - start;
+}
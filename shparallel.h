@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Parallel command building.
+
+ Splits building a frame across worker threads. The objects of a scene
+ are handed out in fixed-size chunks through an atomic cursor, so faster
+ workers simply take more chunks. Each worker writes into its own command
+ buffer (see shcmdbuf.h) and the part of every list written for each chunk
+ is recorded.
+
+ Once all workers are done, shParallelMerge concatenates the lists in
+ chunk order. The result is the same no matter how many workers there
+ were or which worker got which chunk, as long as building a chunk only
+ depends on the chunk.
+
+ Headers aren't elided across chunks, since the neighbouring chunk in the
+ merged list may have come from another worker. Give shParallelWorkerInit
+ an emitter and it's reset at the start of every chunk.
+*/
+
+#ifndef __SHPARALLEL_H__
+#define __SHPARALLEL_H__
+
+#include "stripheader.h"
+#include "shcmdbuf.h"
+#include "shemitter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Where a chunk ended up in its worker's command buffer
+typedef struct shchunk
+{
+    uint32*	start[SH_CMDBUF_LISTS];
+    uint32	size[SH_CMDBUF_LISTS];	// In words
+} shchunk_t;
+
+typedef struct shparallel
+{
+    uint32	next;		// Next chunk to hand out, updated atomically
+    uint32	object_count;
+    uint32	chunk_size;	// Objects per chunk
+    uint32	chunk_count;
+    shchunk_t*	chunks;
+} shparallel_t;
+
+// Per-thread state
+typedef struct shworker
+{
+    shparallel_t*	par;
+    shcmdbuf_t*		cb;
+    shemitter_t*	em;	// Optional, reset for every chunk
+    int32		chunk;	// Chunk being built, -1 if none
+} shworker_t;
+
+// Returns the number of chunks needed for object_count objects.
+// chunk_size must be at least 1, otherwise this returns 0.
+uint32 shParallelChunkCount( uint32 object_count, uint32 chunk_size );
+
+// Initializes a job. chunks must have room for shParallelChunkCount entries.
+// This isn't thread safe, call it before starting the workers.
+// Returns 0 if chunk_size is 0, leaving a job without any chunks.
+int shParallelInit( shparallel_t* par, shchunk_t* chunks, uint32 object_count, uint32 chunk_size );
+
+// Initializes a worker writing to cb, which must be in a frame.
+void shParallelWorkerInit( shworker_t* w, shparallel_t* par, shcmdbuf_t* cb, shemitter_t* em );
+
+// Finishes the current chunk, if any, and takes the next one.
+// Returns 1 with the object range in first and count, or 0 when all
+// chunks have been taken.
+int shParallelNext( shworker_t* w, uint32* first, uint32* count );
+
+// Concatenates a list from all chunks, in chunk order, to ptr.
+// Call this once every worker has returned 0 from shParallelNext.
+// Returns the number of 32-bit words written. Nothing is written if any
+// chunk isn't a whole number of 32-byte blocks.
+int shParallelMerge( const shparallel_t* par, pvr_list_t list, uint32* ptr );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHPARALLEL_H__
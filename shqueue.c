@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shqueue.h"
+#include "shdefs.h"
+
+// The sort key, from most to least significant bits:
+//   63-61  List
+//   60-40  Texture address
+//   39-8   TSP word
+//   6-0    Depth compare, cull mode, Z write and DCalc bits of the ISP/TSP word
+// Translucent and modifier lists only get the list bits, which together
+// with the sort being stable keeps them in the order they were pushed.
+static inline uint64 make_key( const stripheader_t* hdr )
+{
+    const uint32 list = ( hdr->words[PCW] & PCW_LIST_MASK ) >> PCW_LIST_SHIFT;
+    const uint32 isp = hdr->words[ISPTSP];
+    uint64 key = (uint64)list << 61;
+
+    if ( list == PVR_LIST_OP_POLY || list == PVR_LIST_PT_POLY )
+    {
+        key |= (uint64)( hdr->words[TCW0] & 0x1FFFFF ) << 40;
+        key |= (uint64)hdr->words[TSP0] << 8;
+        key |= ( ( isp & ( ISP_TSP_DEPTH_COMPARE_MASK | ISP_TSP_CULL_MODE_MASK | ISP_TSP_Z_WRITE_MASK ) ) >> 25 ) |
+                ( ( isp & ISP_TSP_DCALC_MASK ) >> ISP_TSP_DCALC_SHIFT );
+    }
+
+    return key;
+}
+
+void shQueueInit( shqueue_t* q, shqueue_entry_t* entries, shqueue_entry_t* scratch, uint32 capacity )
+{
+    q->entries = entries;
+    q->scratch = scratch;
+    q->count = 0;
+    q->capacity = capacity;
+}
+
+int shQueuePush( shqueue_t* q, stripheader_t* hdr, const uint32* verts, uint32 size_in_words )
+{
+    shqueue_entry_t* e;
+
+    // Vertices are copied 8 words at a time
+    if ( ( size_in_words & 7 ) != 0 )
+    {
+        report_error( SH_ERROR_INVALID_SIZE, __func__, hdr, hdr->type );
+        return 0;
+    }
+
+    if ( q->count >= q->capacity )
+        return 0;
+
+    e = &q->entries[ q->count++ ];
+    e->hdr = hdr;
+    e->verts = verts;
+    e->size = size_in_words;
+    return 1;
+}
+
+// LSD radix sort on the keys, one byte per pass.
+// Passes where every key has the same byte are skipped, which is most of
+// them for small queues. The sorted result is always left in q->entries.
+static void sort_entries( shqueue_t* q )
+{
+    shqueue_entry_t* src = q->entries;
+    shqueue_entry_t* dst = q->scratch;
+    shqueue_entry_t* tmp;
+    uint32 count[256];
+    uint32 pass, i, sum;
+
+    for ( pass = 0; pass < 8; pass++ )
+    {
+        const uint32 shift = pass * 8;
+
+        for ( i = 0; i < 256; i++ )
+            count[i] = 0;
+
+        for ( i = 0; i < q->count; i++ )
+            count[ ( src[i].key >> shift ) & 0xFF ]++;
+
+        // Nothing to do if all keys fell into the same bucket
+        if ( count[ ( src[0].key >> shift ) & 0xFF ] == q->count )
+            continue;
+
+        for ( i = 0, sum = 0; i < 256; i++ )
+        {
+            const uint32 c = count[i];
+            count[i] = sum;
+            sum += c;
+        }
+
+        for ( i = 0; i < q->count; i++ )
+            dst[ count[ ( src[i].key >> shift ) & 0xFF ]++ ] = src[i];
+
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if ( src != q->entries )
+    {
+        for ( i = 0; i < q->count; i++ )
+            q->entries[i] = src[i];
+    }
+}
+
+int shQueueFlush( shqueue_t* q, shemitter_t* em, uint32* ptr )
+{
+    uint32* const start = ptr;
+    uint32 i, j;
+
+    // Keys are made now, so headers changed after being pushed sort by
+    // the state they're actually sent with
+    if ( q->count > 1 )
+    {
+        for ( i = 0; i < q->count; i++ )
+            q->entries[i].key = make_key( q->entries[i].hdr );
+
+        sort_entries( q );
+    }
+
+    for ( i = 0; i < q->count; i++ )
+    {
+        const shqueue_entry_t* e = &q->entries[i];
+        const uint32* src = e->verts;
+
+        ptr += shEmit( em, e->hdr, ptr );
+
+        // Vertices are sent 32 bytes at a time
+        for ( j = 0; j < e->size; j += 8 )
+        {
+            ptr[0] = src[0];
+            ptr[1] = src[1];
+            ptr[2] = src[2];
+            ptr[3] = src[3];
+            ptr[4] = src[4];
+            ptr[5] = src[5];
+            ptr[6] = src[6];
+            ptr[7] = src[7];
+            PREFETCH( (void*)ptr );
+            ptr += 8;
+            src += 8;
+        }
+    }
+
+    q->count = 0;
+    return ptr - start;
+}
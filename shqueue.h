@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ State-sorted submission queue.
+
+ Instead of committing headers and vertices right away, (header, vertices)
+ pairs are pushed to a queue. When the queue is flushed, opaque and
+ punch-through entries are sorted by a key made from the texture address,
+ the TSP word and the depth/cull bits of the ISP/TSP word, so entries
+ sharing the same state end up next to each other. Headers are sent through
+ an emitter, which means only one header is sent per run of identical state.
+
+ Translucent and modifier entries are never reordered, since their order
+ matters. Entries of different lists are grouped by list, but it's
+ recommended to use one queue per list.
+
+ The queue doesn't copy headers or vertices, so both must stay valid
+ until the queue has been flushed. Headers may still be changed until then,
+ entries are sorted and sent with the state their headers have at the flush.
+*/
+
+#ifndef __SHQUEUE_H__
+#define __SHQUEUE_H__
+
+#include "stripheader.h"
+#include "shemitter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct shqueue_entry
+{
+    uint64		key;	// Made when the queue is flushed
+    stripheader_t*	hdr;
+    const uint32*	verts;	// Finished vertex words
+    uint32		size;	// Number of vertex words, a multiple of 8
+} shqueue_entry_t;
+
+typedef struct shqueue
+{
+    shqueue_entry_t*	entries;
+    shqueue_entry_t*	scratch;	// Used while sorting
+    uint32		count;
+    uint32		capacity;
+} shqueue_t;
+
+// Initializes a queue using caller-owned storage.
+// entries and scratch must both have room for capacity entries.
+void shQueueInit( shqueue_t* q, shqueue_entry_t* entries, shqueue_entry_t* scratch, uint32 capacity );
+
+// Pushes a header and its vertices to the queue.
+// size_in_words must be a multiple of 8, otherwise SH_ERROR_INVALID_SIZE is reported.
+// Returns 1 on success or 0 if the queue is full or the size is invalid.
+int shQueuePush( shqueue_t* q, stripheader_t* hdr, const uint32* verts, uint32 size_in_words );
+
+// Sorts the queue and commits everything in it to ptr using store queues.
+// The queue is empty afterwards.
+// Returns the number of 32-bit words written.
+int shQueueFlush( shqueue_t* q, shemitter_t* em, uint32* ptr );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHQUEUE_H__
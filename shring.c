@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shring.h"
+#include "shdefs.h"
+
+int shRingInit( shring_t* r, uint32* mem, uint32 capacity )
+{
+    r->blocks = mem;
+    r->capacity = capacity;
+    r->full = 0;
+    r->head = 0;
+    r->tail = 0;
+
+    // Positions are masked with capacity - 1. A ring without any room
+    // refuses every push instead.
+    if ( capacity == 0 || ( capacity & ( capacity - 1 ) ) != 0 )
+    {
+        r->capacity = 0;
+        report_error( SH_ERROR_OUT_OF_RANGE, __func__, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    return 1;
+}
+
+static inline void copy_block( uint32* dst, const uint32* src )
+{
+    dst[0] = src[0];
+    dst[1] = src[1];
+    dst[2] = src[2];
+    dst[3] = src[3];
+    dst[4] = src[4];
+    dst[5] = src[5];
+    dst[6] = src[6];
+    dst[7] = src[7];
+}
+
+int shRingPush( shring_t* r, const uint32* words, uint32 size_in_words )
+{
+    const uint32 count = size_in_words / 8;
+    const uint32 mask = r->capacity - 1;
+    const uint32 head = r->head;
+    uint32 i;
+
+    // Blocks are copied 8 words at a time
+    if ( ( size_in_words & 7 ) != 0 )
+    {
+        report_error( SH_ERROR_INVALID_SIZE, __func__, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    // The consumer's reads of the blocks must be done before they're reused
+    if ( count > r->capacity - ( head - __atomic_load_n( &r->tail, __ATOMIC_ACQUIRE ) ) )
+    {
+        r->full++;
+        return 0;
+    }
+
+    for ( i = 0; i < count; i++ )
+        copy_block( r->blocks + ( ( head + i ) & mask ) * 8, words + i * 8 );
+
+    // Publish the blocks only once they're all written
+    __atomic_store_n( &r->head, head + count, __ATOMIC_RELEASE );
+    return size_in_words;
+}
+
+int shRingCommit( shring_t* r, const stripheader_t* hdr )
+{
+    shblock_t block;
+
+    if ( shBake( hdr, &block ) == 0 )
+        return 0;
+
+    return shRingPush( r, block.words, block.size );
+}
+
+int shRingDrain( shring_t* r, uint32* ptr, uint32 max_words )
+{
+    const uint32 mask = r->capacity - 1;
+    const uint32 tail = r->tail;
+    uint32 count = __atomic_load_n( &r->head, __ATOMIC_ACQUIRE ) - tail;
+    uint32 i;
+
+    if ( count > max_words / 8 )
+        count = max_words / 8;
+
+    for ( i = 0; i < count; i++, ptr += 8 )
+    {
+        copy_block( ptr, r->blocks + ( ( tail + i ) & mask ) * 8 );
+        PREFETCH( (void*)ptr );
+    }
+
+    // Hand the blocks back to the producer
+    __atomic_store_n( &r->tail, tail + count, __ATOMIC_RELEASE );
+    return count * 8;
+}
+
+uint32 shRingPending( const shring_t* r )
+{
+    return ( __atomic_load_n( &r->head, __ATOMIC_ACQUIRE ) - __atomic_load_n( &r->tail, __ATOMIC_ACQUIRE ) ) * 8;
+}
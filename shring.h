@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Block rings.
+
+ A single-producer, single-consumer ring of 32-byte blocks, for handing
+ finished headers and vertices from the thread that builds a frame to
+ the thread that sends it to the TA. Neither side ever takes a lock,
+ so building the next frame can overlap with sending the current one.
+
+ Only one thread may push and only one thread may drain. Everything that
+ goes through the ring is a whole number of blocks, which is what shCommit
+ and the vertex writers produce anyway.
+*/
+
+#ifndef __SHRING_H__
+#define __SHRING_H__
+
+#include "stripheader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The head and tail are kept apart so the two threads don't share a cache line
+#define SH_RING_PAD		64
+
+typedef struct shring
+{
+    uint32*	blocks;		// capacity blocks of 8 words
+    uint32	capacity;	// In blocks, a power of two
+    uint32	full;		// Pushes that failed because the ring was full
+
+    uint8	pad0[SH_RING_PAD];
+    uint32	head;		// Blocks pushed so far, only written by the producer
+    uint8	pad1[SH_RING_PAD];
+    uint32	tail;		// Blocks drained so far, only written by the consumer
+    uint8	pad2[SH_RING_PAD];
+} shring_t;
+
+// Initializes an empty ring. mem must have room for capacity blocks of
+// 32 bytes and capacity must be a power of two.
+// Returns 0 if it isn't, leaving a ring that refuses every push.
+int shRingInit( shring_t* r, uint32* mem, uint32 capacity );
+
+// Producer side. Pushes size_in_words words (a multiple of 8) as one piece.
+// Returns the number of 32-bit words pushed, or 0 if there's not enough
+// room or the size isn't a multiple of 8. Nothing is pushed then.
+int shRingPush( shring_t* r, const uint32* words, uint32 size_in_words );
+
+// Producer side. Bakes a header if needed and pushes it.
+// Returns the number of 32-bit words pushed, like shCommit.
+int shRingCommit( shring_t* r, const stripheader_t* hdr );
+
+// Consumer side. Copies at most max_words words (rounded down to whole
+// blocks) from the ring to ptr using store queues.
+// Returns the number of 32-bit words written.
+int shRingDrain( shring_t* r, uint32* ptr, uint32 max_words );
+
+// Number of words waiting to be drained. Safe to call from either side,
+// but only a snapshot.
+uint32 shRingPending( const shring_t* r );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHRING_H__
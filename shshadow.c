@@ -0,0 +1,276 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include "shshadow.h"
+#include "shdefs.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SH_SHADOW_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SH_SHADOW_NEON
+#endif
+
+uint32 shShadowMeshSize( uint32 tri_count )
+{
+    // Adjacency, three normal components and the lit flags
+    return tri_count * 3 * sizeof(int32) + tri_count * 3 * sizeof(float) + ( ( tri_count + 3 ) & ~3u );
+}
+
+uint32 shShadowScratchSize( uint32 tri_count )
+{
+    // One sort key per edge
+    return tri_count * 3 * sizeof(uint64);
+}
+
+static int compare_edges( const void* a, const void* b )
+{
+    const uint64 ka = *(const uint64*)a, kb = *(const uint64*)b;
+    return ( ka < kb ? -1 : ( ka > kb ? 1 : 0 ) );
+}
+
+// Finds the triangle across every edge by sorting the edges on their
+// vertex pair. Edges shared by two triangles end up next to each other.
+static void build_adjacency( shshadowmesh_t* m, uint64* edges )
+{
+    const uint32 count = m->tri_count * 3;
+    uint32 i;
+
+    for ( i = 0; i < count; i++ )
+    {
+        const uint32 a = m->indices[i];
+        const uint32 b = m->indices[( i % 3 == 2 ) ? i - 2 : i + 1];
+        const uint32 key = ( a < b ? ( a << 16 ) | b : ( b << 16 ) | a );
+
+        edges[i] = ( (uint64)key << 32 ) | i;
+        m->adjacency[i] = -1;
+    }
+
+    qsort( edges, count, sizeof(uint64), compare_edges );
+
+    for ( i = 0; i + 1 < count; i++ )
+    {
+        if ( ( edges[i] >> 32 ) == ( edges[i + 1] >> 32 ) )
+        {
+            const uint32 e0 = (uint32)edges[i], e1 = (uint32)edges[i + 1];
+
+            m->adjacency[e0] = e1 / 3;
+            m->adjacency[e1] = e0 / 3;
+            i++;
+        }
+    }
+}
+
+void shShadowMeshInit( shshadowmesh_t* m, void* mem, void* scratch, const float* xyz, const uint16* indices, uint32 tri_count )
+{
+    uint8* p = (uint8*)mem;
+
+    m->indices = indices;
+    m->tri_count = tri_count;
+    m->adjacency = (int32*)p;	p += tri_count * 3 * sizeof(int32);
+    m->nx = (float*)p;		p += tri_count * sizeof(float);
+    m->ny = (float*)p;		p += tri_count * sizeof(float);
+    m->nz = (float*)p;		p += tri_count * sizeof(float);
+    m->lit = p;
+
+    build_adjacency( m, (uint64*)scratch );
+    shShadowMeshUpdate( m, xyz );
+}
+
+void shShadowMeshUpdate( shshadowmesh_t* m, const float* xyz )
+{
+    uint32 i;
+
+    m->xyz = xyz;
+
+    // The normals don't need to be unit length, only their sign against
+    // the light matters
+    for ( i = 0; i < m->tri_count; i++ )
+    {
+        const float* a = &xyz[m->indices[i * 3 + 0] * 3];
+        const float* b = &xyz[m->indices[i * 3 + 1] * 3];
+        const float* c = &xyz[m->indices[i * 3 + 2] * 3];
+        const float ux = b[0] - a[0], uy = b[1] - a[1], uz = b[2] - a[2];
+        const float vx = c[0] - a[0], vy = c[1] - a[1], vz = c[2] - a[2];
+
+        m->nx[i] = uy * vz - uz * vy;
+        m->ny[i] = uz * vx - ux * vz;
+        m->nz[i] = ux * vy - uy * vx;
+    }
+}
+
+uint32 shShadowMaxTriangles( const shshadowmesh_t* m )
+{
+    // Two caps, and at most three silhouette quads per triangle
+    return m->tri_count * 8;
+}
+
+// Sets lit[i] for every triangle whose normal points against the light.
+// Returns the number of lit triangles.
+static uint32 classify( shshadowmesh_t* m, const float light[3] )
+{
+    const uint32 count = m->tri_count;
+    uint32 i = 0, lit = 0;
+
+#if defined(SH_SHADOW_SSE2)
+    const __m128 lx = _mm_set1_ps( light[0] ), ly = _mm_set1_ps( light[1] ), lz = _mm_set1_ps( light[2] );
+    const __m128 zero = _mm_setzero_ps();
+
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        const __m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( m->nx + i ), lx ),
+                                                 _mm_mul_ps( _mm_loadu_ps( m->ny + i ), ly ) ),
+                                     _mm_mul_ps( _mm_loadu_ps( m->nz + i ), lz ) );
+        const int mask = _mm_movemask_ps( _mm_cmplt_ps( d, zero ) );
+
+        m->lit[i + 0] = ( mask >> 0 ) & 1;
+        m->lit[i + 1] = ( mask >> 1 ) & 1;
+        m->lit[i + 2] = ( mask >> 2 ) & 1;
+        m->lit[i + 3] = ( mask >> 3 ) & 1;
+        lit += m->lit[i] + m->lit[i + 1] + m->lit[i + 2] + m->lit[i + 3];
+    }
+#elif defined(SH_SHADOW_NEON)
+    const float32x4_t lx = vdupq_n_f32( light[0] ), ly = vdupq_n_f32( light[1] ), lz = vdupq_n_f32( light[2] );
+
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        float32x4_t d = vmulq_f32( vld1q_f32( m->nx + i ), lx );
+        uint32 flags[4];
+        int j;
+
+        d = vmlaq_f32( d, vld1q_f32( m->ny + i ), ly );
+        d = vmlaq_f32( d, vld1q_f32( m->nz + i ), lz );
+        vst1q_u32( flags, vshrq_n_u32( vcltq_f32( d, vdupq_n_f32( 0.0f ) ), 31 ) );
+
+        for ( j = 0; j < 4; j++ )
+        {
+            m->lit[i + j] = flags[j];
+            lit += flags[j];
+        }
+    }
+#endif
+
+    for ( ; i < count; i++ )
+    {
+        m->lit[i] = ( m->nx[i] * light[0] + m->ny[i] * light[1] + m->nz[i] * light[2] < 0.0f );
+        lit += m->lit[i];
+    }
+
+    return lit;
+}
+
+static inline void set_triangle( shmodtriangle_t* t, const float* a, const float* b, const float* c )
+{
+    t->ax = a[0]; t->ay = a[1]; t->az = a[2];
+    t->bx = b[0]; t->by = b[1]; t->bz = b[2];
+    t->cx = c[0]; t->cy = c[1]; t->cz = c[2];
+}
+
+static inline void extrude( float* out, const float* v, const float* offset )
+{
+    out[0] = v[0] + offset[0];
+    out[1] = v[1] + offset[1];
+    out[2] = v[2] + offset[2];
+}
+
+// Builds the volume. Returns the number of triangles, or -1 if they don't fit.
+static int extrude_volume( shshadowmesh_t* m, const float light[3], float distance, shmodtriangle_t* out, int capacity )
+{
+    const float offset[3] = { light[0] * distance, light[1] * distance, light[2] * distance };
+    const uint32 lit = classify( m, light );
+    uint32 i, e, n = 0;
+
+    // Quick reject before writing anything, the silhouette is counted as it goes
+    if ( lit * 2 > (uint32)capacity )
+        return -1;
+
+    for ( i = 0; i < m->tri_count; i++ )
+    {
+        const float* v[3];
+        float ext[3][3];
+
+        if ( !m->lit[i] )
+            continue;
+
+        for ( e = 0; e < 3; e++ )
+        {
+            v[e] = &m->xyz[m->indices[i * 3 + e] * 3];
+            extrude( ext[e], v[e], offset );
+        }
+
+        if ( n + 2 > (uint32)capacity )
+            return -1;
+
+        // Front and back caps
+        set_triangle( &out[n++], v[0], v[1], v[2] );
+        set_triangle( &out[n++], ext[0], ext[1], ext[2] );
+
+        // Sides along silhouette and open edges
+        for ( e = 0; e < 3; e++ )
+        {
+            const int32 adj = m->adjacency[i * 3 + e];
+            const uint32 e1 = ( e == 2 ? 0 : e + 1 );
+
+            if ( adj >= 0 && m->lit[adj] )
+                continue;
+
+            if ( n + 2 > (uint32)capacity )
+                return -1;
+
+            set_triangle( &out[n++], v[e], v[e1], ext[e1] );
+            set_triangle( &out[n++], v[e], ext[e1], ext[e] );
+        }
+    }
+
+    return n;
+}
+
+int shShadowExtrude( shshadowmesh_t* m, const float light[3], float distance, shmodtriangle_t* out, int capacity )
+{
+    const int count = extrude_volume( m, light, distance, out, capacity );
+
+    if ( count < 0 )
+        report_error( SH_ERROR_OVERFLOW, __func__, NULL, SH_ERROR_NO_TYPE );
+
+    return count;
+}
+
+int shShadowEmit( shshadowmesh_t* m, shvolumebuilder_t* vb, const float light[3], float distance,
+                  shmodtriangle_t* out, int capacity, void (*project)( float* v, void* user ), void* user )
+{
+    const int count = extrude_volume( m, light, distance, out, capacity );
+    int i;
+
+    if ( count < 0 )
+    {
+        report_error( SH_ERROR_OVERFLOW, __func__, NULL, SH_ERROR_NO_TYPE );
+        return -1;
+    }
+
+    if ( project != NULL )
+    {
+        for ( i = 0; i < count; i++ )
+        {
+            project( &out[i].ax, user );
+            project( &out[i].bx, user );
+            project( &out[i].cx, user );
+        }
+    }
+
+    return shVolumeTriangles( vb, out, count );
+}
@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Shadow volumes.
+
+ Builds closed shadow volumes from indexed meshes and a directional light,
+ for use with cheap shadow modifiers (SH_AFFECTED_BY_MODIFIER on types 0-8).
+
+ A mesh is prepared once with shShadowMeshInit, which finds the triangle
+ across every edge. For each light direction, triangles are classified as
+ facing the light or not, and the volume is made from:
+    - the triangles facing the light (front cap),
+    - the same triangles pushed away from the light (back cap),
+    - a quad along every silhouette edge, i.e. every edge between a
+      triangle facing the light and one that doesn't.
+
+ Winding doesn't matter to modifier volumes, so none of these are flipped.
+
+ The volume is generated in the same space as the mesh. It has to be
+ projected to screen space before it's sent, which shShadowEmit can do
+ through a callback.
+
+ Classification uses SSE2 or NEON when built for a host that has them.
+*/
+
+#ifndef __SHSHADOW_H__
+#define __SHSHADOW_H__
+
+#include "stripheader.h"
+#include "shvertex.h"
+#include "shvolume.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct shshadowmesh
+{
+    const float*	xyz;		// Three floats per vertex
+    const uint16*	indices;	// Three per triangle
+    uint32		tri_count;
+    int32*		adjacency;	// Triangle across each edge, -1 for open edges
+    float*		nx;		// Face normals, one per triangle
+    float*		ny;
+    float*		nz;
+    uint8*		lit;		// Set for triangles facing the light
+} shshadowmesh_t;
+
+// Returns how many bytes of storage shShadowMeshInit needs for the mesh
+// and how many bytes of scratch it needs while building it.
+uint32 shShadowMeshSize( uint32 tri_count );
+uint32 shShadowScratchSize( uint32 tri_count );
+
+// Prepares a mesh. The vertices and indices aren't copied and must stay
+// valid. mem must be 4-byte aligned and 8-byte aligned for scratch,
+// which can be reused once this returns.
+void shShadowMeshInit( shshadowmesh_t* m, void* mem, void* scratch, const float* xyz, const uint16* indices, uint32 tri_count );
+
+// Updates the face normals after the vertices have moved (e.g. skinning).
+// xyz may point to a new vertex array with the same layout.
+void shShadowMeshUpdate( shshadowmesh_t* m, const float* xyz );
+
+// Returns the largest number of triangles a volume of the mesh can have.
+uint32 shShadowMaxTriangles( const shshadowmesh_t* m );
+
+// Builds the volume for a light shining in direction light, extruded
+// distance units. Returns the number of triangles written to out, which
+// is 0 if no triangle faces the light. If there are more than capacity,
+// SH_ERROR_OVERFLOW is reported and -1 returned.
+int shShadowExtrude( shshadowmesh_t* m, const float light[3], float distance, shmodtriangle_t* out, int capacity );
+
+// Builds a volume and writes it through a volume builder.
+// project is called for every vertex (x, y, z) of the volume, to move it
+// to screen space. It can be NULL if the mesh already is in screen space.
+// out is used as scratch and needs room for shShadowMaxTriangles triangles.
+// Returns the number of 32-bit words written, or -1 after reporting
+// SH_ERROR_OVERFLOW if the volume didn't fit in out.
+int shShadowEmit( shshadowmesh_t* m, shvolumebuilder_t* vb, const float light[3], float distance,
+                  shmodtriangle_t* out, int capacity, void (*project)( float* v, void* user ), void* user );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHSHADOW_H__
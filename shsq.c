@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shsq.h"
+
+void shSqInit( shsq_t* sq, uint32* dest )
+{
+    sq->ptr = dest;
+    sq->fill = 0;
+    sq->flushes = 0;
+
+#ifdef SH_SQ_HOST
+    sq->base = dest;
+    sq->record = NULL;
+    sq->record_size = 0;
+#endif
+}
+
+#ifdef SH_SQ_HOST
+void shSqRecord( shsq_t* sq, uint32* record, uint32 record_size )
+{
+    sq->record = record;
+    sq->record_size = record_size;
+}
+#endif
+
+void shSqWrite( shsq_t* sq, const uint32* words, int count )
+{
+    int i;
+
+    // Top up the current burst first, whole bursts can then be written in one go
+    while ( count > 0 && sq->fill != 0 )
+    {
+        shSqPut( sq, *words++ );
+        count--;
+    }
+
+    while ( count >= 8 )
+    {
+        uint32* ptr = sq->ptr;
+
+        ptr[0] = words[0];
+        ptr[1] = words[1];
+        ptr[2] = words[2];
+        ptr[3] = words[3];
+        ptr[4] = words[4];
+        ptr[5] = words[5];
+        ptr[6] = words[6];
+        ptr[7] = words[7];
+        sq->ptr += 8;
+        shSqFlushBurst( sq );
+
+        words += 8;
+        count -= 8;
+    }
+
+    for ( i = 0; i < count; i++ )
+        shSqPut( sq, words[i] );
+}
+
+int shSqCommit( shsq_t* sq, const stripheader_t* hdr )
+{
+    shblock_t block;
+    const int size = shBake( hdr, &block );
+
+    shSqWrite( sq, block.words, size );
+    return size;
+}
+
+void shSqFinish( shsq_t* sq )
+{
+    while ( sq->fill != 0 )
+        shSqPut( sq, 0 );
+}
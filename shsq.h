@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Store queue writer.
+
+ Collects words into 32-byte bursts and only flushes a store queue once a
+ burst is complete. Consecutive bursts go to alternating store queues, since
+ bit 5 of the address selects the queue, so one queue can be filled while
+ the other is being flushed.
+
+ On the SH4 the destination is an address in the store queue area that has
+ been set up to point at the TA. On any other machine the writer works on
+ plain memory and records every flush instead, so the order of bursts and
+ the number of flushes can be checked on a host.
+*/
+
+#ifndef __SHSQ_H__
+#define __SHSQ_H__
+
+#include "stripheader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined(__SH4__) && !defined(_arch_dreamcast)
+#define SH_SQ_HOST
+#endif
+
+typedef struct shsq
+{
+    uint32*	ptr;		// Next word to write
+    uint32	fill;		// Words written to the current burst
+    uint32	flushes;	// Number of completed bursts
+
+#ifdef SH_SQ_HOST
+    uint32*	base;		// Start of the destination
+    uint32*	record;		// Word offset of each flushed burst, may be NULL
+    uint32	record_size;	// Number of entries record has room for
+#endif
+} shsq_t;
+
+// Starts writing at dest, which must be 32-byte aligned.
+void shSqInit( shsq_t* sq, uint32* dest );
+
+#ifdef SH_SQ_HOST
+// Host only: also logs the word offset of every flushed burst into record.
+void shSqRecord( shsq_t* sq, uint32* record, uint32 record_size );
+#endif
+
+// Flushes the current burst. Only called once it's full.
+static inline void shSqFlushBurst( shsq_t* sq )
+{
+    uint32* burst = sq->ptr - 8;
+
+#ifdef SH_SQ_HOST
+    if ( sq->record != NULL && sq->flushes < sq->record_size )
+        sq->record[ sq->flushes ] = burst - sq->base;
+#else
+    __asm__ __volatile__( "pref @%0" : : "r" (burst) );
+#endif
+
+    sq->flushes++;
+    sq->fill = 0;
+}
+
+// Writes a single word
+static inline void shSqPut( shsq_t* sq, uint32 word )
+{
+    *sq->ptr++ = word;
+
+    if ( ++sq->fill == 8 )
+        shSqFlushBurst( sq );
+}
+
+// Writes count words
+void shSqWrite( shsq_t* sq, const uint32* words, int count );
+
+// Writes a header, the same way shCommit does. Returns the number of words written.
+int shSqCommit( shsq_t* sq, const stripheader_t* hdr );
+
+// Pads the current burst with zeros and flushes it, if anything's been written to it.
+// Use this when done writing, as the TA only accepts whole bursts.
+void shSqFinish( shsq_t* sq );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHSQ_H__
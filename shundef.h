@@ -0,0 +1,302 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Undefines the macros from shdefs.h, so they don't leak out of the C++
+ header (see the end of stripheader.hpp). Keep this in sync with shdefs.h,
+ the host build checks that nothing is left defined.
+
+ shdefs.h itself stays included, it can't be included again afterwards.
+*/
+
+#undef PCW_TYPE_SHIFT
+#undef PCW_TYPE_END_OF_LIST
+#undef PCW_TYPE_USER_TILE_CLIP
+#undef PCW_TYPE_OBJECT_LIST_SET
+#undef PCW_TYPE_POLYGON
+#undef PCW_TYPE_MODIFIER
+#undef PCW_TYPE_SPRITE
+#undef PCW_TYPE_VERTEX
+#undef PCW_TYPE_MASK
+#undef PCW_LIST_SHIFT
+#undef PCW_LIST_OP_POLYGON
+#undef PCW_LIST_OP_MODIFIER
+#undef PCW_LIST_TR_POLYGON
+#undef PCW_LIST_TR_MODIFIER
+#undef PCW_LIST_PT_POLYGON
+#undef PCW_LIST_MASK
+#undef PCW_UPDATE_GROUP_SHIFT
+#undef PCW_UPDATE_GROUP_OFF
+#undef PCW_UPDATE_GROUP_ON
+#undef PCW_UPDATE_GROUP_MASK
+#undef PCW_END_OF_STRIP_SHIFT
+#undef PCW_END_OF_STRIP
+#undef PCW_END_OF_STRIP_MASK
+#undef PCW_STRIP_LENGTH_SHIFT
+#undef PCW_STRIP_LENGTH_1
+#undef PCW_STRIP_LENGTH_2
+#undef PCW_STRIP_LENGTH_4
+#undef PCW_STRIP_LENGTH_6
+#undef PCW_STRIP_LENGTH_MASK
+#undef PCW_USER_CLIP_SHIFT
+#undef PCW_USER_CLIP_DISABLE
+#undef PCW_USER_CLIP_INSIDE
+#undef PCW_USER_CLIP_OUTSIDE
+#undef PCW_USER_CLIP_MASK
+#undef PCW_MODIFIER_SHIFT
+#undef PCW_MODIFIER_DISABLE
+#undef PCW_MODIFIER_ENABLE
+#undef PCW_MODIFIER_MASK
+#undef PCW_MODIFIER_TYPE_SHIFT
+#undef PCW_MODIFIER_TYPE_SHADOW
+#undef PCW_MODIFIER_TYPE_NORMAL
+#undef PCW_MODIFIER_TYPE_MASK
+#undef PCW_MODIFIER_TRIANGLE_SHIFT
+#undef PCW_MODIFIER_TRIANGLE
+#undef PCW_MODIFIER_TRIANGLE_LAST
+#undef PCW_MODIFIER_TRIANGLE_MASK
+#undef PCW_COLOR_TYPE_SHIFT
+#undef PCW_COLOR_TYPE_PACKED
+#undef PCW_COLOR_TYPE_FLOAT
+#undef PCW_COLOR_TYPE_INTENSITY
+#undef PCW_COLOR_TYPE_PREV_INTENSITY
+#undef PCW_COLOR_TYPE_MASK
+#undef PCW_TEXTURE_SHIFT
+#undef PCW_TEXTURE_DISABLE
+#undef PCW_TEXTURE_ENABLE
+#undef PCW_TEXTURE_MASK
+#undef PCW_OFFSET_COLOR_SHIFT
+#undef PCW_OFFSET_COLOR_DISABLE
+#undef PCW_OFFSET_COLOR_ENABLE
+#undef PCW_OFFSET_COLOR_MASK
+#undef PCW_SHADING_SHIFT
+#undef PCW_SHADING_FLAT
+#undef PCW_SHADING_GOURAUD
+#undef PCW_SHADING_MASK
+#undef PCW_UV_SHIFT
+#undef PCW_UV_32BIT
+#undef PCW_UV_16BIT
+#undef PCW_UV_MASK
+
+#undef ISP_TSP_DEPTH_COMPARE_SHIFT
+#undef ISP_TSP_DEPTH_COMPARE_NEVER
+#undef ISP_TSP_DEPTH_COMPARE_LESS
+#undef ISP_TSP_DEPTH_COMPARE_EQUAL
+#undef ISP_TSP_DEPTH_COMPARE_LESS_OR_EQUAL
+#undef ISP_TSP_DEPTH_COMPARE_GREATER
+#undef ISP_TSP_DEPTH_COMPARE_NOT_EQUAL
+#undef ISP_TSP_DEPTH_COMPARE_GREATER_OR_EQUAL
+#undef ISP_TSP_DEPTH_COMPARE_ALWAYS
+#undef ISP_TSP_DEPTH_COMPARE_MASK
+#undef ISP_TSP_VOLUME_INSTRUCTION_SHIFT
+#undef ISP_TSP_VOLUME_INSTRUCTION_NORMAL
+#undef ISP_TSP_VOLUME_INSTRUCTION_INSIDE_LAST
+#undef ISP_TSP_VOLUME_INSTRUCTION_OUTSIDE_LAST
+#undef ISP_TSP_VOLUME_INSTRUCTION_MASK
+#undef ISP_TSP_CULL_MODE_SHIFT
+#undef ISP_TSP_CULL_MODE_NONE
+#undef ISP_TSP_CULL_MODE_SMALL
+#undef ISP_TSP_CULL_MODE_COUNTER_CLOCKWISE
+#undef ISP_TSP_CULL_MODE_CLOCKWISE
+#undef ISP_TSP_CULL_MODE_MASK
+#undef ISP_TSP_Z_WRITE_SHIFT
+#undef ISP_TSP_Z_WRITE_ENABLE
+#undef ISP_TSP_Z_WRITE_DISABLE
+#undef ISP_TSP_Z_WRITE_MASK
+#undef ISP_TSP_DCALC_SHIFT
+#undef ISP_TSP_DCALC_DISABLE
+#undef ISP_TSP_DCALC_ENABLE
+#undef ISP_TSP_DCALC_MASK
+
+#undef TSP_SRC_ALPHA_INSTR_SHIFT
+#undef TSP_SRC_ALPHA_INSTR_ZERO
+#undef TSP_SRC_ALPHA_INSTR_ONE
+#undef TSP_SRC_ALPHA_INSTR_DST_COLOR
+#undef TSP_SRC_ALPHA_INSTR_INVERSE_DST_COLOR
+#undef TSP_SRC_ALPHA_INSTR_SRC_ALPHA
+#undef TSP_SRC_ALPHA_INSTR_INVERSE_SRC_ALPHA
+#undef TSP_SRC_ALPHA_INSTR_DST_ALPHA
+#undef TSP_SRC_ALPHA_INSTR_INVERSE_DST_ALPHA
+#undef TSP_SRC_ALPHA_INSTR_MASK
+#undef TSP_DST_ALPHA_INSTR_SHIFT
+#undef TSP_DST_ALPHA_INSTR_ZERO
+#undef TSP_DST_ALPHA_INSTR_ONE
+#undef TSP_DST_ALPHA_INSTR_DST_COLOR
+#undef TSP_DST_ALPHA_INSTR_INVERSE_DST_COLOR
+#undef TSP_DST_ALPHA_INSTR_SRC_ALPHA
+#undef TSP_DST_ALPHA_INSTR_INVERSE_SRC_ALPHA
+#undef TSP_DST_ALPHA_INSTR_DST_ALPHA
+#undef TSP_DST_ALPHA_INSTR_INVERSE_DST_ALPHA
+#undef TSP_DST_ALPHA_INSTR_MASK
+#undef TSP_SRC_SELECT_SHIFT
+#undef TSP_SRC_SELECT_DISABLE
+#undef TSP_SRC_SELECT_ENABLE
+#undef TSP_SRC_SELECT_MASK
+#undef TSP_DST_SELECT_SHIFT
+#undef TSP_DST_SELECT_DISABLE
+#undef TSP_DST_SELECT_ENABLE
+#undef TSP_DST_SELECT_MASK
+#undef TSP_FOG_MODE_SHIFT
+#undef TSP_FOG_MODE_LOOKUP_TABLE
+#undef TSP_FOG_MODE_PER_VERTEX
+#undef TSP_FOG_MODE_DISABLE
+#undef TSP_FOG_MODE_LOOKUP_TABLE_2
+#undef TSP_FOG_MODE_MASK
+#undef TSP_COLOR_CLAMP_SHIFT
+#undef TSP_COLOR_CLAMP_DISABLE
+#undef TSP_COLOR_CLAMP_ENABLE
+#undef TSP_COLOR_CLAMP_MASK
+#undef TSP_ALPHA_SHIFT
+#undef TSP_ALPHA_DISABLE
+#undef TSP_ALPHA_ENABLE
+#undef TSP_ALPHA_MASK
+#undef TSP_TEXTURE_ALPHA_SHIFT
+#undef TSP_TEXTURE_ALPHA_DISABLE
+#undef TSP_TEXTURE_ALPHA_ENABLE
+#undef TSP_TEXTURE_ALPHA_MASK
+#undef TSP_UV_FLIP_SHIFT
+#undef TSP_UV_FLIP_NONE
+#undef TSP_UV_FLIP_V
+#undef TSP_UV_FLIP_U
+#undef TSP_UV_FLIP_UV
+#undef TSP_UV_FLIP_MASK
+#undef TSP_UV_CLAMP_SHIFT
+#undef TSP_UV_CLAMP_NONE
+#undef TSP_UV_CLAMP_V
+#undef TSP_UV_CLAMP_U
+#undef TSP_UV_CLAMP_UV
+#undef TSP_UV_CLAMP_MASK
+#undef TSP_TEXTURE_FILTER_SHIFT
+#undef TSP_TEXTURE_FILTER_POINT
+#undef TSP_TEXTURE_FILTER_BILINEAR
+#undef TSP_TEXTURE_FILTER_TRILINEAR_PASS_A
+#undef TSP_TEXTURE_FILTER_TRILINEAR_PASS_B
+#undef TSP_TEXTURE_FILTER_MASK
+#undef TSP_SUPER_SAMPLING_SHIFT
+#undef TSP_SUPER_SAMPLING_DISABLE
+#undef TSP_SUPER_SAMPLING_ENABLE
+#undef TSP_SUPER_SAMPLING_MASK
+#undef TSP_MIPMAP_ADJUST_SHIFT
+#undef TSP_MIPMAP_ADJUST_0_25
+#undef TSP_MIPMAP_ADJUST_0_50
+#undef TSP_MIPMAP_ADJUST_0_75
+#undef TSP_MIPMAP_ADJUST_1_00
+#undef TSP_MIPMAP_ADJUST_1_25
+#undef TSP_MIPMAP_ADJUST_1_50
+#undef TSP_MIPMAP_ADJUST_1_75
+#undef TSP_MIPMAP_ADJUST_2_00
+#undef TSP_MIPMAP_ADJUST_2_25
+#undef TSP_MIPMAP_ADJUST_2_50
+#undef TSP_MIPMAP_ADJUST_2_75
+#undef TSP_MIPMAP_ADJUST_3_00
+#undef TSP_MIPMAP_ADJUST_3_25
+#undef TSP_MIPMAP_ADJUST_3_50
+#undef TSP_MIPMAP_ADJUST_3_75
+#undef TSP_MIPMAP_ADJUST_MASK
+#undef TSP_TEXTURE_INSTRUCTION_SHIFT
+#undef TSP_TEXTURE_INSTRUCTION_DECAL
+#undef TSP_TEXTURE_INSTRUCTION_MODULATE
+#undef TSP_TEXTURE_INSTRUCTION_DECAL_ALPHA
+#undef TSP_TEXTURE_INSTRUCTION_MODULATE_ALPHA
+#undef TSP_TEXTURE_INSTRUCTION_MASK
+#undef TSP_TEXTURE_U_SIZE_SHIFT
+#undef TSP_TEXTURE_U_SIZE_8
+#undef TSP_TEXTURE_U_SIZE_16
+#undef TSP_TEXTURE_U_SIZE_32
+#undef TSP_TEXTURE_U_SIZE_64
+#undef TSP_TEXTURE_U_SIZE_128
+#undef TSP_TEXTURE_U_SIZE_256
+#undef TSP_TEXTURE_U_SIZE_512
+#undef TSP_TEXTURE_U_SIZE_1024
+#undef TSP_TEXTURE_U_SIZE_MASK
+#undef TSP_TEXTURE_V_SIZE_SHIFT
+#undef TSP_TEXTURE_V_SIZE_8
+#undef TSP_TEXTURE_V_SIZE_16
+#undef TSP_TEXTURE_V_SIZE_32
+#undef TSP_TEXTURE_V_SIZE_64
+#undef TSP_TEXTURE_V_SIZE_128
+#undef TSP_TEXTURE_V_SIZE_256
+#undef TSP_TEXTURE_V_SIZE_512
+#undef TSP_TEXTURE_V_SIZE_1024
+#undef TSP_TEXTURE_V_SIZE_MASK
+
+#undef TCW_MIPMAP_SHIFT
+#undef TCW_MIPMAP_DISABLED
+#undef TCW_MIPMAP_ENABLED
+#undef TCW_MIPMAP_MASK
+#undef TCW_VQ_COMPRESSED_SHIFT
+#undef TCW_VQ_COMPRESSED_DISABLED
+#undef TCW_VQ_COMPRESSED_ENABLED
+#undef TCW_VQ_COMPRESSED_MASK
+#undef TCW_PIXEL_FORMAT_SHIFT
+#undef TCW_PIXEL_FORMAT_ARGB1555
+#undef TCW_PIXEL_FORMAT_RGB565
+#undef TCW_PIXEL_FORMAT_ARGB4444
+#undef TCW_PIXEL_FORMAT_YUV422
+#undef TCW_PIXEL_FORMAT_BUMP_MAP
+#undef TCW_PIXEL_FORMAT_PAL_4BPP
+#undef TCW_PIXEL_FORMAT_PAL_8BPP
+#undef TCW_PIXEL_FORMAT_MASK
+#undef TCW_TWIDDLED_SHIFT
+#undef TCW_TWIDDLED_DISABLED
+#undef TCW_TWIDDLED_ENABLED
+#undef TCW_TWIDDLED_MASK
+#undef TCW_STRIDE_SHIFT
+#undef TCW_STRIDE_DISABLED
+#undef TCW_STRIDE_ENABLED
+#undef TCW_STRIDE_MASK
+#undef TCW_PALETTE_INDEX_4BPP_SHIFT
+#undef TCW_PALETTE_INDEX_4BPP_MASK
+#undef TCW_PALETTE_INDEX_8BPP_SHIFT
+#undef TCW_PALETTE_INDEX_8BPP_MASK
+#undef TCW_TEXTURE_ADDRESS
+#undef TCW_TEXTURE_ADDRESS_MASK
+
+#undef TILE_CLIP_X_MAX
+#undef TILE_CLIP_Y_MAX
+
+#undef PCW
+#undef ISPTSP
+#undef TSP0
+#undef TCW0
+#undef TSP1
+#undef TCW1
+
+#undef BIT
+
+#undef TYPES_POLYGON
+#undef TYPES_SPRITE
+#undef TYPES_MODIFIER
+#undef TYPES_POLYSPRITE
+#undef TYPES_ALL
+#undef TYPES_TEXTURED
+#undef TYPES_SHADOW
+#undef TYPES_POLYGON_2
+#undef TYPES_TEXTURED_2
+#undef TYPES_INTENSITY
+#undef TYPES_COMPACT
+
+#undef SH_CONST
+
+#undef TSP_BASE
+
+#undef NUM_CAPABILITIES
+
+#undef PREFETCH
+
+#undef report_error
+
+#undef STAT_ADD
@@ -0,0 +1,415 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shvertex.h"
+#include "shdefs.h"
+
+#define VERTEX		( PCW_TYPE_VERTEX )
+#define VERTEX_EOS	( PCW_TYPE_VERTEX | PCW_END_OF_STRIP )
+
+// Vertex control word for vertex i of a strip of count vertices
+#define STRIP_PCW( i, count )	( ( (i) == (count) - 1 ) ? VERTEX_EOS : VERTEX )
+
+#define F( f )	float_bits( f )
+
+// Writes 32 bytes and flushes them
+static inline void put8( uint32* ptr, uint32 w0, uint32 w1, uint32 w2, uint32 w3, uint32 w4, uint32 w5, uint32 w6, uint32 w7 )
+{
+    ptr[0] = w0;
+    ptr[1] = w1;
+    ptr[2] = w2;
+    ptr[3] = w3;
+    ptr[4] = w4;
+    ptr[5] = w5;
+    ptr[6] = w6;
+    ptr[7] = w7;
+    PREFETCH( (void*)ptr );
+}
+
+/*
+===============================================================================
+
+VERTEX FORMATS
+
+===============================================================================
+*/
+
+// Packed color
+static inline int put_packed_0( uint32* ptr, const shvertexpacked_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), 0, 0, v->argb, 0 );
+    return 8;
+}
+
+static inline int put_packed_3( uint32* ptr, const shvertexpacked_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), F(v->u), F(v->v), v->argb, v->oargb );
+    return 8;
+}
+
+static inline int put_packed_4( uint32* ptr, const shvertexpacked_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), pack_uv16( v->u, v->v ), 0, v->argb, v->oargb );
+    return 8;
+}
+
+// Float color
+static inline int put_float_1( uint32* ptr, const shvertexfloat_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), F(v->base[0]), F(v->base[1]), F(v->base[2]), F(v->base[3]) );
+    return 8;
+}
+
+static inline int put_float_5( uint32* ptr, const shvertexfloat_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), F(v->u), F(v->v), 0, 0 );
+    put8( ptr + 8, F(v->base[0]), F(v->base[1]), F(v->base[2]), F(v->base[3]),
+          F(v->offset[0]), F(v->offset[1]), F(v->offset[2]), F(v->offset[3]) );
+    return 16;
+}
+
+static inline int put_float_6( uint32* ptr, const shvertexfloat_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), pack_uv16( v->u, v->v ), 0, 0, 0 );
+    put8( ptr + 8, F(v->base[0]), F(v->base[1]), F(v->base[2]), F(v->base[3]),
+          F(v->offset[0]), F(v->offset[1]), F(v->offset[2]), F(v->offset[3]) );
+    return 16;
+}
+
+// Intensity
+static inline int put_intensity_2( uint32* ptr, const shvertexintensity_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), 0, 0, F(v->base), 0 );
+    return 8;
+}
+
+static inline int put_intensity_7( uint32* ptr, const shvertexintensity_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), F(v->u), F(v->v), F(v->base), F(v->offset) );
+    return 8;
+}
+
+static inline int put_intensity_8( uint32* ptr, const shvertexintensity_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), pack_uv16( v->u, v->v ), 0, F(v->base), F(v->offset) );
+    return 8;
+}
+
+// Two-parameter, packed color
+static inline int put_packed2_9( uint32* ptr, const shvertexpacked2_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), v->argb0, v->argb1, 0, 0 );
+    return 8;
+}
+
+static inline int put_packed2_11( uint32* ptr, const shvertexpacked2_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), F(v->u0), F(v->v0), v->argb0, v->oargb0 );
+    put8( ptr + 8, F(v->u1), F(v->v1), v->argb1, v->oargb1, 0, 0, 0, 0 );
+    return 16;
+}
+
+static inline int put_packed2_12( uint32* ptr, const shvertexpacked2_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), pack_uv16( v->u0, v->v0 ), 0, v->argb0, v->oargb0 );
+    put8( ptr + 8, pack_uv16( v->u1, v->v1 ), 0, v->argb1, v->oargb1, 0, 0, 0, 0 );
+    return 16;
+}
+
+// Two-parameter, intensity
+static inline int put_intensity2_10( uint32* ptr, const shvertexintensity2_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), F(v->base0), F(v->base1), 0, 0 );
+    return 8;
+}
+
+static inline int put_intensity2_13( uint32* ptr, const shvertexintensity2_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), F(v->u0), F(v->v0), F(v->base0), F(v->offset0) );
+    put8( ptr + 8, F(v->u1), F(v->v1), F(v->base1), F(v->offset1), 0, 0, 0, 0 );
+    return 16;
+}
+
+static inline int put_intensity2_14( uint32* ptr, const shvertexintensity2_t* v, uint32 pcw )
+{
+    put8( ptr, pcw, F(v->x), F(v->y), F(v->z), pack_uv16( v->u0, v->v0 ), 0, F(v->base0), F(v->offset0) );
+    put8( ptr + 8, pack_uv16( v->u1, v->v1 ), 0, F(v->base1), F(v->offset1), 0, 0, 0, 0 );
+    return 16;
+}
+
+// Sprites
+static inline int put_sprite_15( uint32* ptr, const shsprite_t* s )
+{
+    put8( ptr, VERTEX_EOS, F(s->ax), F(s->ay), F(s->az), F(s->bx), F(s->by), F(s->bz), F(s->cx) );
+    put8( ptr + 8, F(s->cy), F(s->cz), F(s->dx), F(s->dy), 0, 0, 0, 0 );
+    return 16;
+}
+
+static inline int put_sprite_16( uint32* ptr, const shsprite_t* s )
+{
+    put8( ptr, VERTEX_EOS, F(s->ax), F(s->ay), F(s->az), F(s->bx), F(s->by), F(s->bz), F(s->cx) );
+    put8( ptr + 8, F(s->cy), F(s->cz), F(s->dx), F(s->dy), 0,
+          pack_uv16( s->au, s->av ), pack_uv16( s->bu, s->bv ), pack_uv16( s->cu, s->cv ) );
+    return 16;
+}
+
+// Modifier volume triangle
+static inline int put_modtriangle( uint32* ptr, const shmodtriangle_t* t )
+{
+    put8( ptr, VERTEX_EOS, F(t->ax), F(t->ay), F(t->az), F(t->bx), F(t->by), F(t->bz), F(t->cx) );
+    put8( ptr + 8, F(t->cy), F(t->cz), 0, 0, 0, 0, 0, 0 );
+    return 16;
+}
+
+/*
+===============================================================================
+
+SINGLE VERTICES
+
+===============================================================================
+*/
+
+int shVertexPacked( uint32* ptr, uint32 type, const shvertexpacked_t* v, int eos )
+{
+    const uint32 pcw = ( eos ? VERTEX_EOS : VERTEX );
+
+    switch ( type )
+    {
+        case 0:	return put_packed_0( ptr, v, pcw );
+        case 3:	return put_packed_3( ptr, v, pcw );
+        case 4:	return put_packed_4( ptr, v, pcw );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            return 0;
+    }
+}
+
+int shVertexFloat( uint32* ptr, uint32 type, const shvertexfloat_t* v, int eos )
+{
+    const uint32 pcw = ( eos ? VERTEX_EOS : VERTEX );
+
+    switch ( type )
+    {
+        case 1:	return put_float_1( ptr, v, pcw );
+        case 5:	return put_float_5( ptr, v, pcw );
+        case 6:	return put_float_6( ptr, v, pcw );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            return 0;
+    }
+}
+
+int shVertexIntensity( uint32* ptr, uint32 type, const shvertexintensity_t* v, int eos )
+{
+    const uint32 pcw = ( eos ? VERTEX_EOS : VERTEX );
+
+    switch ( type )
+    {
+        case 2:	return put_intensity_2( ptr, v, pcw );
+        case 7:	return put_intensity_7( ptr, v, pcw );
+        case 8:	return put_intensity_8( ptr, v, pcw );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            return 0;
+    }
+}
+
+int shVertexPacked2( uint32* ptr, uint32 type, const shvertexpacked2_t* v, int eos )
+{
+    const uint32 pcw = ( eos ? VERTEX_EOS : VERTEX );
+
+    switch ( type )
+    {
+        case 9:		return put_packed2_9( ptr, v, pcw );
+        case 11:	return put_packed2_11( ptr, v, pcw );
+        case 12:	return put_packed2_12( ptr, v, pcw );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            return 0;
+    }
+}
+
+int shVertexIntensity2( uint32* ptr, uint32 type, const shvertexintensity2_t* v, int eos )
+{
+    const uint32 pcw = ( eos ? VERTEX_EOS : VERTEX );
+
+    switch ( type )
+    {
+        case 10:	return put_intensity2_10( ptr, v, pcw );
+        case 13:	return put_intensity2_13( ptr, v, pcw );
+        case 14:	return put_intensity2_14( ptr, v, pcw );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            return 0;
+    }
+}
+
+int shSprite( uint32* ptr, uint32 type, const shsprite_t* s )
+{
+    switch ( type )
+    {
+        case 15:	return put_sprite_15( ptr, s );
+        case 16:	return put_sprite_16( ptr, s );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            return 0;
+    }
+}
+
+int shModifierTriangle( uint32* ptr, const shmodtriangle_t* t )
+{
+    return put_modtriangle( ptr, t );
+}
+
+/*
+===============================================================================
+
+STRIPS
+
+===============================================================================
+*/
+
+// The type is only looked at once per strip, each case gets its own loop
+#define STRIP_LOOP( put )						\
+    for ( i = 0; i < count; i++ )					\
+        ptr += put( ptr, &v[i], STRIP_PCW( i, count ) );		\
+    break
+
+int shStripPacked( uint32* ptr, uint32 type, const shvertexpacked_t* v, int count )
+{
+    uint32* const start = ptr;
+    int i;
+
+    switch ( type )
+    {
+        case 0:	STRIP_LOOP( put_packed_0 );
+        case 3:	STRIP_LOOP( put_packed_3 );
+        case 4:	STRIP_LOOP( put_packed_4 );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            break;
+    }
+
+    return ptr - start;
+}
+
+int shStripFloat( uint32* ptr, uint32 type, const shvertexfloat_t* v, int count )
+{
+    uint32* const start = ptr;
+    int i;
+
+    switch ( type )
+    {
+        case 1:	STRIP_LOOP( put_float_1 );
+        case 5:	STRIP_LOOP( put_float_5 );
+        case 6:	STRIP_LOOP( put_float_6 );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            break;
+    }
+
+    return ptr - start;
+}
+
+int shStripIntensity( uint32* ptr, uint32 type, const shvertexintensity_t* v, int count )
+{
+    uint32* const start = ptr;
+    int i;
+
+    switch ( type )
+    {
+        case 2:	STRIP_LOOP( put_intensity_2 );
+        case 7:	STRIP_LOOP( put_intensity_7 );
+        case 8:	STRIP_LOOP( put_intensity_8 );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            break;
+    }
+
+    return ptr - start;
+}
+
+int shStripPacked2( uint32* ptr, uint32 type, const shvertexpacked2_t* v, int count )
+{
+    uint32* const start = ptr;
+    int i;
+
+    switch ( type )
+    {
+        case 9:		STRIP_LOOP( put_packed2_9 );
+        case 11:	STRIP_LOOP( put_packed2_11 );
+        case 12:	STRIP_LOOP( put_packed2_12 );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            break;
+    }
+
+    return ptr - start;
+}
+
+int shStripIntensity2( uint32* ptr, uint32 type, const shvertexintensity2_t* v, int count )
+{
+    uint32* const start = ptr;
+    int i;
+
+    switch ( type )
+    {
+        case 10:	STRIP_LOOP( put_intensity2_10 );
+        case 13:	STRIP_LOOP( put_intensity2_13 );
+        case 14:	STRIP_LOOP( put_intensity2_14 );
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            break;
+    }
+
+    return ptr - start;
+}
+
+int shSprites( uint32* ptr, uint32 type, const shsprite_t* s, int count )
+{
+    uint32* const start = ptr;
+    int i;
+
+    switch ( type )
+    {
+        case 15:
+            for ( i = 0; i < count; i++ )
+                ptr += put_sprite_15( ptr, &s[i] );
+            break;
+
+        case 16:
+            for ( i = 0; i < count; i++ )
+                ptr += put_sprite_16( ptr, &s[i] );
+            break;
+
+        default:
+            report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, type );
+            break;
+    }
+
+    return ptr - start;
+}
+
+int shModifierTriangles( uint32* ptr, const shmodtriangle_t* t, int count )
+{
+    uint32* const start = ptr;
+    int i;
+
+    for ( i = 0; i < count; i++ )
+        ptr += put_modtriangle( ptr, &t[i] );
+
+    return ptr - start;
+}
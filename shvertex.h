@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Vertex submission.
+
+ These write vertices straight to the same destination as shCommit,
+ 32 bytes at a time. The vertex format is given by the type of the header
+ the vertices belong to (see the table in stripheader.h), so pass
+ hdr->type as the "type" argument.
+
+ There's one vertex struct per color class:
+    Packed color      types 0, 3, 4          shvertexpacked_t
+    Float color       types 1, 5, 6          shvertexfloat_t
+    Intensity         types 2, 7, 8          shvertexintensity_t
+    Two-parameter     types 9, 11, 12        shvertexpacked2_t
+                      types 10, 13, 14       shvertexintensity2_t
+    Sprite            types 15, 16           shsprite_t
+    Modifier volume   type 17                shmodtriangle_t
+
+ Fields that don't apply to a type (e.g. UVs for untextured types) are
+ ignored. Each single vertex writer takes an end-of-strip flag. The batch
+ writers send a whole strip and set it on the last vertex.
+
+ All writers return the number of 32-bit words written, or 0 if the type
+ doesn't belong to the writer's color class. That's reported as
+ SH_ERROR_NOT_ALLOWED, except in SH_NO_VALIDATION builds.
+*/
+
+#ifndef __SHVERTEX_H__
+#define __SHVERTEX_H__
+
+#include "stripheader.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct shvertexpacked
+{
+    float	x, y, z;
+    float	u, v;
+    uint32	argb;		// Base color
+    uint32	oargb;		// Offset color, textured types only
+} shvertexpacked_t;
+
+typedef struct shvertexfloat
+{
+    float	x, y, z;
+    float	u, v;
+    float	base[4];	// Base color, ARGB
+    float	offset[4];	// Offset color (ARGB), textured types only
+} shvertexfloat_t;
+
+typedef struct shvertexintensity
+{
+    float	x, y, z;
+    float	u, v;
+    float	base;		// Base intensity
+    float	offset;		// Offset intensity, textured types only
+} shvertexintensity_t;
+
+// Vertices for two-parameter polygons carry one set of UVs and colors per volume
+typedef struct shvertexpacked2
+{
+    float	x, y, z;
+    float	u0, v0;
+    uint32	argb0, oargb0;
+    float	u1, v1;
+    uint32	argb1, oargb1;
+} shvertexpacked2_t;
+
+typedef struct shvertexintensity2
+{
+    float	x, y, z;
+    float	u0, v0;
+    float	base0, offset0;
+    float	u1, v1;
+    float	base1, offset1;
+} shvertexintensity2_t;
+
+// Sprite quad. D's texture coordinate is derived by the hardware.
+typedef struct shsprite
+{
+    float	ax, ay, az;
+    float	bx, by, bz;
+    float	cx, cy, cz;
+    float	dx, dy;
+    float	au, av;
+    float	bu, bv;
+    float	cu, cv;
+} shsprite_t;
+
+// Modifier volume triangle
+typedef struct shmodtriangle
+{
+    float	ax, ay, az;
+    float	bx, by, bz;
+    float	cx, cy, cz;
+} shmodtriangle_t;
+
+// Single vertices
+int shVertexPacked( uint32* ptr, uint32 type, const shvertexpacked_t* v, int eos );
+int shVertexFloat( uint32* ptr, uint32 type, const shvertexfloat_t* v, int eos );
+int shVertexIntensity( uint32* ptr, uint32 type, const shvertexintensity_t* v, int eos );
+int shVertexPacked2( uint32* ptr, uint32 type, const shvertexpacked2_t* v, int eos );
+int shVertexIntensity2( uint32* ptr, uint32 type, const shvertexintensity2_t* v, int eos );
+
+// Sprites and modifier triangles are always complete strips on their own
+int shSprite( uint32* ptr, uint32 type, const shsprite_t* s );
+int shModifierTriangle( uint32* ptr, const shmodtriangle_t* t );
+
+// Whole strips
+int shStripPacked( uint32* ptr, uint32 type, const shvertexpacked_t* v, int count );
+int shStripFloat( uint32* ptr, uint32 type, const shvertexfloat_t* v, int count );
+int shStripIntensity( uint32* ptr, uint32 type, const shvertexintensity_t* v, int count );
+int shStripPacked2( uint32* ptr, uint32 type, const shvertexpacked2_t* v, int count );
+int shStripIntensity2( uint32* ptr, uint32 type, const shvertexintensity2_t* v, int count );
+
+// Arrays of sprites and modifier triangles
+int shSprites( uint32* ptr, uint32 type, const shsprite_t* s, int count );
+int shModifierTriangles( uint32* ptr, const shmodtriangle_t* t, int count );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHVERTEX_H__
@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+#include "shvolume.h"
+#include "shdefs.h"
+
+int shVolumeBegin( shvolumebuilder_t* vb, uint32* ptr, pvr_list_t list, SHMODIFIERINSTRUCTION instr )
+{
+    if ( !shInit( &vb->normal, 17, list, NULL, NULL ) ||
+            !shModifierInstruction( &vb->normal, SH_MODIFIER_NORMAL ) )
+        return 0;
+
+    vb->last = vb->normal;
+    if ( !shVolumeInstruction( vb, instr ) )
+        return 0;
+
+    // Bake up front so the headers are only copied while writing volumes
+    shBake( &vb->normal, &vb->normal_block );
+
+    vb->ptr = ptr;
+    vb->volumes = 0;
+    vb->triangles = 0;
+    vb->headers = 0;
+    return 1;
+}
+
+int shVolumeInstruction( shvolumebuilder_t* vb, SHMODIFIERINSTRUCTION instr )
+{
+    // The last triangle of a volume has to close it
+    if ( instr == SH_MODIFIER_NORMAL )
+    {
+        report_error( SH_ERROR_INVALID_PARAMETER, __func__, &vb->last, 17 );
+        return 0;
+    }
+
+    if ( !shModifierInstruction( &vb->last, instr ) )
+        return 0;
+
+    shBake( &vb->last, &vb->last_block );
+    return 1;
+}
+
+int shVolumeTriangles( shvolumebuilder_t* vb, const shmodtriangle_t* t, int count )
+{
+    uint32* const start = vb->ptr;
+
+    if ( count <= 0 )
+        return 0;
+
+    if ( count > 1 )
+    {
+        vb->ptr += shCommitBlock( &vb->normal_block, vb->ptr );
+        vb->ptr += shModifierTriangles( vb->ptr, t, count - 1 );
+        vb->headers++;
+    }
+
+    vb->ptr += shCommitBlock( &vb->last_block, vb->ptr );
+    vb->ptr += shModifierTriangle( vb->ptr, &t[count - 1] );
+    vb->headers++;
+
+    vb->volumes++;
+    vb->triangles += count;
+    return vb->ptr - start;
+}
+
+// Gathers one triangle of an indexed mesh
+static inline void load_triangle( shmodtriangle_t* t, const float* xyz, const uint16* idx )
+{
+    const float* a = &xyz[idx[0] * 3];
+    const float* b = &xyz[idx[1] * 3];
+    const float* c = &xyz[idx[2] * 3];
+
+    t->ax = a[0]; t->ay = a[1]; t->az = a[2];
+    t->bx = b[0]; t->by = b[1]; t->bz = b[2];
+    t->cx = c[0]; t->cy = c[1]; t->cz = c[2];
+}
+
+int shVolumeIndexed( shvolumebuilder_t* vb, const float* xyz, const uint16* indices, int tri_count )
+{
+    uint32* const start = vb->ptr;
+    shmodtriangle_t t;
+    int i;
+
+    if ( tri_count <= 0 )
+        return 0;
+
+    if ( tri_count > 1 )
+    {
+        vb->ptr += shCommitBlock( &vb->normal_block, vb->ptr );
+        vb->headers++;
+
+        for ( i = 0; i < tri_count - 1; i++ )
+        {
+            load_triangle( &t, xyz, &indices[i * 3] );
+            vb->ptr += shModifierTriangle( vb->ptr, &t );
+        }
+    }
+
+    vb->ptr += shCommitBlock( &vb->last_block, vb->ptr );
+    vb->headers++;
+
+    load_triangle( &t, xyz, &indices[( tri_count - 1 ) * 3] );
+    vb->ptr += shModifierTriangle( vb->ptr, &t );
+
+    vb->volumes++;
+    vb->triangles += tri_count;
+    return vb->ptr - start;
+}
+
+uint32* shVolumeEnd( shvolumebuilder_t* vb )
+{
+    return vb->ptr;
+}
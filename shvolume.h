@@ -0,0 +1,81 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Modifier volume building.
+
+ A modifier volume is a closed mesh sent as type 17 triangles. Every
+ triangle but the last one is sent with SH_MODIFIER_NORMAL, and the last
+ one with SH_MODIFIER_INSIDE_LAST or SH_MODIFIER_OUTSIDE_LAST, which needs
+ a header of its own.
+
+ The builder bakes both headers up front and writes each volume as
+ normal header, triangles, last header, last triangle. Volumes with a
+ single triangle only get the last header. Any number of volumes can be
+ written in a row to the same list.
+
+ All writes go forward from the pointer given to shVolumeBegin.
+*/
+
+#ifndef __SHVOLUME_H__
+#define __SHVOLUME_H__
+
+#include "stripheader.h"
+#include "shvertex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct shvolumebuilder
+{
+    stripheader_t	normal;		// Header for all triangles but the last
+    stripheader_t	last;		// Header for the last triangle of a volume
+    shblock_t		normal_block;	// Both headers, baked
+    shblock_t		last_block;
+    uint32*		ptr;		// Where the next words are written
+
+    // Statistics
+    uint32		volumes;
+    uint32		triangles;
+    uint32		headers;
+} shvolumebuilder_t;
+
+// Starts writing volumes to a modifier list (PVR_LIST_OP_MOD or PVR_LIST_TR_MOD).
+// instr is the instruction for the volumes, SH_MODIFIER_INSIDE_LAST or SH_MODIFIER_OUTSIDE_LAST.
+int shVolumeBegin( shvolumebuilder_t* vb, uint32* ptr, pvr_list_t list, SHMODIFIERINSTRUCTION instr );
+
+// Changes the instruction for the following volumes.
+// SH_MODIFIER_NORMAL fails with SH_ERROR_INVALID_PARAMETER.
+int shVolumeInstruction( shvolumebuilder_t* vb, SHMODIFIERINSTRUCTION instr );
+
+// Writes one closed volume given as triangles.
+// Returns the number of 32-bit words written.
+int shVolumeTriangles( shvolumebuilder_t* vb, const shmodtriangle_t* t, int count );
+
+// Writes one closed volume given as an indexed mesh.
+// xyz holds three floats per vertex, indices three per triangle.
+// Returns the number of 32-bit words written.
+int shVolumeIndexed( shvolumebuilder_t* vb, const float* xyz, const uint16* indices, int tri_count );
+
+// Returns the pointer following the last word written.
+uint32* shVolumeEnd( shvolumebuilder_t* vb );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SHVOLUME_H__
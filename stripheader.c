@@ -14,341 +14,36 @@
 // Author: Anton Norgren (Tvspelsfreak) (2011)           //
 ///////////////////////////////////////////////////////////
 
-#include "stripheader.h"
-
-/////////////////////////////////////////////////////
-// Parameter control word                          //
-/////////////////////////////////////////////////////
-
-// Type, bits 31-29
-#define PCW_TYPE_SHIFT				29
-#define PCW_TYPE_END_OF_LIST			(0 << PCW_TYPE_SHIFT)
-#define PCW_TYPE_USER_TILE_CLIP			(1 << PCW_TYPE_SHIFT)
-#define PCW_TYPE_OBJECT_LIST_SET		(2 << PCW_TYPE_SHIFT)
-#define PCW_TYPE_POLYGON			(4 << PCW_TYPE_SHIFT)
-#define PCW_TYPE_MODIFIER			(4 << PCW_TYPE_SHIFT)
-#define PCW_TYPE_SPRITE				(5 << PCW_TYPE_SHIFT)
-#define PCW_TYPE_MASK				(7 << PCW_TYPE_SHIFT)
-
-// List, bits 26-24
-#define PCW_LIST_SHIFT				24
-#define PCW_LIST_OP_POLYGON			(0 << PCW_LIST_SHIFT)
-#define PCW_LIST_OP_MODIFIER			(1 << PCW_LIST_SHIFT)
-#define PCW_LIST_TR_POLYGON			(2 << PCW_LIST_SHIFT)
-#define PCW_LIST_TR_MODIFIER			(3 << PCW_LIST_SHIFT)
-#define PCW_LIST_PT_POLYGON			(4 << PCW_LIST_SHIFT)
-#define PCW_LIST_MASK				(7 << PCW_LIST_SHIFT)
-
-// Update strip length & user clip, bit 23
-#define PCW_UPDATE_GROUP_SHIFT			23
-#define PCW_UPDATE_GROUP_OFF			(0 << PCW_UPDATE_GROUP_SHIFT)
-#define PCW_UPDATE_GROUP_ON			(1 << PCW_UPDATE_GROUP_SHIFT)
-#define PCW_UPDATE_GROUP_MASK			(1 << PCW_UPDATE_GROUP_SHIFT)
-
-// Strip length, bits 19-18
-#define PCW_STRIP_LENGTH_SHIFT			18
-#define PCW_STRIP_LENGTH_1			(0 << PCW_STRIP_LENGTH_SHIFT)
-#define PCW_STRIP_LENGTH_2			(1 << PCW_STRIP_LENGTH_SHIFT)
-#define PCW_STRIP_LENGTH_4			(2 << PCW_STRIP_LENGTH_SHIFT)
-#define PCW_STRIP_LENGTH_6			(3 << PCW_STRIP_LENGTH_SHIFT)
-#define PCW_STRIP_LENGTH_MASK			(3 << PCW_STRIP_LENGTH_SHIFT)
-
-// User clip, bits 17-16
-#define PCW_USER_CLIP_SHIFT			16
-#define PCW_USER_CLIP_DISABLE			(0 << PCW_USER_CLIP_SHIFT)
-#define PCW_USER_CLIP_INSIDE			(2 << PCW_USER_CLIP_SHIFT)
-#define PCW_USER_CLIP_OUTSIDE			(3 << PCW_USER_CLIP_SHIFT)
-#define PCW_USER_CLIP_MASK			(3 << PCW_USER_CLIP_SHIFT)
-
-// Enable modifiers (for polygons), bit 7
-#define PCW_MODIFIER_SHIFT			7
-#define PCW_MODIFIER_DISABLE			(0 << PCW_MODIFIER_SHIFT)
-#define PCW_MODIFIER_ENABLE			(1 << PCW_MODIFIER_SHIFT)
-#define PCW_MODIFIER_MASK			(1 << PCW_MODIFIER_SHIFT)
-
-// Modifier type (for polygons), bit 6
-#define PCW_MODIFIER_TYPE_SHIFT			6
-#define PCW_MODIFIER_TYPE_SHADOW		(0 << PCW_MODIFIER_TYPE_SHIFT)
-#define PCW_MODIFIER_TYPE_NORMAL		(1 << PCW_MODIFIER_TYPE_SHIFT)
-#define PCW_MODIFIER_TYPE_MASK			(1 << PCW_MODIFIER_TYPE_SHIFT)
-
-// Last triangle in volume (for modifiers), bit 6
-#define PCW_MODIFIER_TRIANGLE_SHIFT		6
-#define PCW_MODIFIER_TRIANGLE			(0 << PCW_MODIFIER_TRIANGLE_SHIFT)
-#define PCW_MODIFIER_TRIANGLE_LAST		(1 << PCW_MODIFIER_TRIANGLE_SHIFT)
-#define PCW_MODIFIER_TRIANGLE_MASK		(1 << PCW_MODIFIER_TRIANGLE_SHIFT)
-
-// Color type, bits 5-4
-#define PCW_COLOR_TYPE_SHIFT			4
-#define PCW_COLOR_TYPE_PACKED			(0 << PCW_COLOR_TYPE_SHIFT)
-#define PCW_COLOR_TYPE_FLOAT			(1 << PCW_COLOR_TYPE_SHIFT)
-#define PCW_COLOR_TYPE_INTENSITY		(2 << PCW_COLOR_TYPE_SHIFT)
-#define PCW_COLOR_TYPE_PREV_INTENSITY		(3 << PCW_COLOR_TYPE_SHIFT)
-#define PCW_COLOR_TYPE_MASK			(3 << PCW_COLOR_TYPE_SHIFT)
-
-// Texture enable, bit 3
-#define PCW_TEXTURE_SHIFT			3
-#define PCW_TEXTURE_DISABLE			(0 << PCW_TEXTURE_SHIFT)
-#define PCW_TEXTURE_ENABLE			(1 << PCW_TEXTURE_SHIFT)
-#define PCW_TEXTURE_MASK			(1 << PCW_TEXTURE_SHIFT)
-
-// Offset color enable, bit 2
-#define PCW_OFFSET_COLOR_SHIFT			2
-#define PCW_OFFSET_COLOR_DISABLE		(0 << PCW_OFFSET_COLOR_SHIFT)
-#define PCW_OFFSET_COLOR_ENABLE			(1 << PCW_OFFSET_COLOR_SHIFT)
-#define PCW_OFFSET_COLOR_MASK			(1 << PCW_OFFSET_COLOR_SHIFT)
-
-// Shading, bit 1
-#define PCW_SHADING_SHIFT			1
-#define PCW_SHADING_FLAT			(0 << PCW_SHADING_SHIFT)
-#define PCW_SHADING_GOURAUD			(1 << PCW_SHADING_SHIFT)
-#define PCW_SHADING_MASK			(1 << PCW_SHADING_SHIFT)
-
-// UV, bit 0
-#define PCW_UV_SHIFT				0
-#define PCW_UV_32BIT				(0 << PCW_UV_SHIFT)
-#define PCW_UV_16BIT				(1 << PCW_UV_SHIFT)
-#define PCW_UV_MASK				(1 << PCW_UV_SHIFT)
-
-/////////////////////////////////////////////////////
-// ISP/TSP instruction word                        //
-/////////////////////////////////////////////////////
-
-// Depth compare (for polygons), bits 31-29
-#define ISP_TSP_DEPTH_COMPARE_SHIFT		29
-#define ISP_TSP_DEPTH_COMPARE_NEVER		(0 << ISP_TSP_DEPTH_COMPARE_SHIFT)
-#define ISP_TSP_DEPTH_COMPARE_LESS		(1 << ISP_TSP_DEPTH_COMPARE_SHIFT)
-#define ISP_TSP_DEPTH_COMPARE_EQUAL		(2 << ISP_TSP_DEPTH_COMPARE_SHIFT)
-#define ISP_TSP_DEPTH_COMPARE_LESS_OR_EQUAL	(3 << ISP_TSP_DEPTH_COMPARE_SHIFT)
-#define ISP_TSP_DEPTH_COMPARE_GREATER		(4 << ISP_TSP_DEPTH_COMPARE_SHIFT)
-#define ISP_TSP_DEPTH_COMPARE_NOT_EQUAL		(5 << ISP_TSP_DEPTH_COMPARE_SHIFT)
-#define ISP_TSP_DEPTH_COMPARE_GREATER_OR_EQUAL	(6 << ISP_TSP_DEPTH_COMPARE_SHIFT)
-#define ISP_TSP_DEPTH_COMPARE_ALWAYS		(7 << ISP_TSP_DEPTH_COMPARE_SHIFT)
-#define ISP_TSP_DEPTH_COMPARE_MASK		(7 << ISP_TSP_DEPTH_COMPARE_SHIFT)
-
-// Volume instruction (for modifiers), bits 31-29
-#define ISP_TSP_VOLUME_INSTRUCTION_SHIFT	29
-#define ISP_TSP_VOLUME_INSTRUCTION_NORMAL	(0 << ISP_TSP_VOLUME_INSTRUCTION_SHIFT)
-#define ISP_TSP_VOLUME_INSTRUCTION_INSIDE_LAST	(1 << ISP_TSP_VOLUME_INSTRUCTION_SHIFT)
-#define ISP_TSP_VOLUME_INSTRUCTION_OUTSIDE_LAST	(2 << ISP_TSP_VOLUME_INSTRUCTION_SHIFT)
-#define ISP_TSP_VOLUME_INSTRUCTION_MASK		(7 << ISP_TSP_VOLUME_INSTRUCTION_SHIFT)
-
-// Cull mode (for polygons and modifiers), bits 28-27
-#define ISP_TSP_CULL_MODE_SHIFT			27
-#define ISP_TSP_CULL_MODE_NONE			(0 << ISP_TSP_CULL_MODE_SHIFT)
-#define ISP_TSP_CULL_MODE_SMALL			(1 << ISP_TSP_CULL_MODE_SHIFT)
-#define ISP_TSP_CULL_MODE_COUNTER_CLOCKWISE	(2 << ISP_TSP_CULL_MODE_SHIFT)
-#define ISP_TSP_CULL_MODE_CLOCKWISE		(3 << ISP_TSP_CULL_MODE_SHIFT)
-#define ISP_TSP_CULL_MODE_MASK			(3 << ISP_TSP_CULL_MODE_SHIFT)
-
-// Z write disable, bit 26
-#define ISP_TSP_Z_WRITE_SHIFT			26
-#define ISP_TSP_Z_WRITE_ENABLE			(0 << ISP_TSP_Z_WRITE_SHIFT)
-#define ISP_TSP_Z_WRITE_DISABLE			(1 << ISP_TSP_Z_WRITE_SHIFT)
-#define ISP_TSP_Z_WRITE_MASK			(1 << ISP_TSP_Z_WRITE_SHIFT)
-
-// DCalc control, bit 20
-#define ISP_TSP_DCALC_SHIFT			20
-#define ISP_TSP_DCALC_DISABLE			(0 << ISP_TSP_DCALC_SHIFT)
-#define ISP_TSP_DCALC_ENABLE			(1 << ISP_TSP_DCALC_SHIFT)
-#define ISP_TSP_DCALC_MASK			(1 << ISP_TSP_DCALC_SHIFT)
-
-/////////////////////////////////////////////////////
-// TSP instruction word                            //
-/////////////////////////////////////////////////////
-
-// SRC Alpha instruction, bits 31-29
-#define TSP_SRC_ALPHA_INSTR_SHIFT		29
-#define TSP_SRC_ALPHA_INSTR_ZERO		(0 << TSP_SRC_ALPHA_INSTR_SHIFT)
-#define TSP_SRC_ALPHA_INSTR_ONE			(1 << TSP_SRC_ALPHA_INSTR_SHIFT)
-#define TSP_SRC_ALPHA_INSTR_DST_COLOR		(2 << TSP_SRC_ALPHA_INSTR_SHIFT)
-#define TSP_SRC_ALPHA_INSTR_INVERSE_DST_COLOR	(3 << TSP_SRC_ALPHA_INSTR_SHIFT)
-#define TSP_SRC_ALPHA_INSTR_SRC_ALPHA		(4 << TSP_SRC_ALPHA_INSTR_SHIFT)
-#define TSP_SRC_ALPHA_INSTR_INVERSE_SRC_ALPHA	(5 << TSP_SRC_ALPHA_INSTR_SHIFT)
-#define TSP_SRC_ALPHA_INSTR_DST_ALPHA		(6 << TSP_SRC_ALPHA_INSTR_SHIFT)
-#define TSP_SRC_ALPHA_INSTR_INVERSE_DST_ALPHA	(7 << TSP_SRC_ALPHA_INSTR_SHIFT)
-#define TSP_SRC_ALPHA_INSTR_MASK		(7 << TSP_SRC_ALPHA_INSTR_SHIFT)
-
-// DST Alpha instruction, bits 28-26
-#define TSP_DST_ALPHA_INSTR_SHIFT		26
-#define TSP_DST_ALPHA_INSTR_ZERO		(0 << TSP_DST_ALPHA_INSTR_SHIFT)
-#define TSP_DST_ALPHA_INSTR_ONE			(1 << TSP_DST_ALPHA_INSTR_SHIFT)
-#define TSP_DST_ALPHA_INSTR_DST_COLOR		(2 << TSP_DST_ALPHA_INSTR_SHIFT)
-#define TSP_DST_ALPHA_INSTR_INVERSE_DST_COLOR	(3 << TSP_DST_ALPHA_INSTR_SHIFT)
-#define TSP_DST_ALPHA_INSTR_SRC_ALPHA		(4 << TSP_DST_ALPHA_INSTR_SHIFT)
-#define TSP_DST_ALPHA_INSTR_INVERSE_SRC_ALPHA	(5 << TSP_DST_ALPHA_INSTR_SHIFT)
-#define TSP_DST_ALPHA_INSTR_DST_ALPHA		(6 << TSP_DST_ALPHA_INSTR_SHIFT)
-#define TSP_DST_ALPHA_INSTR_INVERSE_DST_ALPHA	(7 << TSP_DST_ALPHA_INSTR_SHIFT)
-#define TSP_DST_ALPHA_INSTR_MASK		(7 << TSP_DST_ALPHA_INSTR_SHIFT)
-
-// SRC select enable, bit 25
-#define TSP_SRC_SELECT_SHIFT			25
-#define TSP_SRC_SELECT_DISABLE			(0 << TSP_SRC_SELECT_SHIFT)
-#define TSP_SRC_SELECT_ENABLE			(1 << TSP_SRC_SELECT_SHIFT)
-#define TSP_SRC_SELECT_MASK			(1 << TSP_SRC_SELECT_SHIFT)
-
-// DST select enable, bit 24
-#define TSP_DST_SELECT_SHIFT			24
-#define TSP_DST_SELECT_DISABLE			(0 << TSP_DST_SELECT_SHIFT)
-#define TSP_DST_SELECT_ENABLE			(1 << TSP_DST_SELECT_SHIFT)
-#define TSP_DST_SELECT_MASK			(1 << TSP_DST_SELECT_SHIFT)
-
-// Fog mode, bits 23-22
-#define TSP_FOG_MODE_SHIFT			22
-#define TSP_FOG_MODE_LOOKUP_TABLE		(0 << TSP_FOG_MODE_SHIFT)
-#define TSP_FOG_MODE_PER_VERTEX			(1 << TSP_FOG_MODE_SHIFT)
-#define TSP_FOG_MODE_DISABLE			(2 << TSP_FOG_MODE_SHIFT)
-#define TSP_FOG_MODE_LOOKUP_TABLE_2		(3 << TSP_FOG_MODE_SHIFT)
-#define TSP_FOG_MODE_MASK			(3 << TSP_FOG_MODE_SHIFT)
-
-// Color clamp enable, bit 21
-#define TSP_COLOR_CLAMP_SHIFT			21
-#define TSP_COLOR_CLAMP_DISABLE			(0 << TSP_COLOR_CLAMP_SHIFT)
-#define TSP_COLOR_CLAMP_ENABLE			(1 << TSP_COLOR_CLAMP_SHIFT)
-#define TSP_COLOR_CLAMP_MASK			(1 << TSP_COLOR_CLAMP_SHIFT)
-
-// Alpha enable, bit 20
-#define TSP_ALPHA_SHIFT				20
-#define TSP_ALPHA_DISABLE			(0 << TSP_ALPHA_SHIFT)
-#define TSP_ALPHA_ENABLE			(1 << TSP_ALPHA_SHIFT)
-#define TSP_ALPHA_MASK				(1 << TSP_ALPHA_SHIFT)
-
-// Texture alpha enable, bit 19
-#define TSP_TEXTURE_ALPHA_SHIFT			19
-#define TSP_TEXTURE_ALPHA_DISABLE		(1 << TSP_TEXTURE_ALPHA_SHIFT)
-#define TSP_TEXTURE_ALPHA_ENABLE		(0 << TSP_TEXTURE_ALPHA_SHIFT)
-#define TSP_TEXTURE_ALPHA_MASK			(1 << TSP_TEXTURE_ALPHA_SHIFT)
-
-// Flip UV, bits 18-17
-#define TSP_UV_FLIP_SHIFT			17
-#define TSP_UV_FLIP_NONE			(0 << TSP_UV_FLIP_SHIFT)
-#define TSP_UV_FLIP_V				(1 << TSP_UV_FLIP_SHIFT)
-#define TSP_UV_FLIP_U				(2 << TSP_UV_FLIP_SHIFT)
-#define TSP_UV_FLIP_UV				(3 << TSP_UV_FLIP_SHIFT)
-#define TSP_UV_FLIP_MASK			(3 << TSP_UV_FLIP_SHIFT)
-
-// Clamp UV, bits 16-15
-#define TSP_UV_CLAMP_SHIFT			15
-#define TSP_UV_CLAMP_NONE			(0 << TSP_UV_CLAMP_SHIFT)
-#define TSP_UV_CLAMP_V				(1 << TSP_UV_CLAMP_SHIFT)
-#define TSP_UV_CLAMP_U				(2 << TSP_UV_CLAMP_SHIFT)
-#define TSP_UV_CLAMP_UV				(3 << TSP_UV_CLAMP_SHIFT)
-#define TSP_UV_CLAMP_MASK			(3 << TSP_UV_CLAMP_SHIFT)
-
-// Texture filter, bits 14-13
-#define TSP_TEXTURE_FILTER_SHIFT		13
-#define TSP_TEXTURE_FILTER_POINT		(0 << TSP_TEXTURE_FILTER_SHIFT)
-#define TSP_TEXTURE_FILTER_BILINEAR		(1 << TSP_TEXTURE_FILTER_SHIFT)
-#define TSP_TEXTURE_FILTER_TRILINEAR_PASS_A	(2 << TSP_TEXTURE_FILTER_SHIFT)
-#define TSP_TEXTURE_FILTER_TRILINEAR_PASS_B	(3 << TSP_TEXTURE_FILTER_SHIFT)
-#define TSP_TEXTURE_FILTER_MASK			(3 << TSP_TEXTURE_FILTER_SHIFT)
-
-// Texture super sampling enable, bit 12
-#define TSP_SUPER_SAMPLING_SHIFT		12
-#define TSP_SUPER_SAMPLING_DISABLE		(0 << TSP_SUPER_SAMPLING_SHIFT)
-#define TSP_SUPER_SAMPLING_ENABLE		(1 << TSP_SUPER_SAMPLING_SHIFT)
-#define TSP_SUPER_SAMPLING_MASK			(1 << TSP_SUPER_SAMPLING_SHIFT)
-
-// Mipmap adjust, bits 11-8
-#define TSP_MIPMAP_ADJUST_SHIFT			8
-#define TSP_MIPMAP_ADJUST_0_25			(1 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_0_50			(2 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_0_75			(3 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_1_00			(4 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_1_25			(5 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_1_50			(6 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_1_75			(7 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_2_00			(8 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_2_25			(9 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_2_50			(10 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_2_75			(11 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_3_00			(12 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_3_25			(13 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_3_50			(14 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_3_75			(15 << TSP_MIPMAP_ADJUST_SHIFT)
-#define TSP_MIPMAP_ADJUST_MASK			(15 << TSP_MIPMAP_ADJUST_SHIFT)
-
-// Texture shading instruction, bits 7-6
-#define TSP_TEXTURE_INSTRUCTION_SHIFT		6
-#define TSP_TEXTURE_INSTRUCTION_DECAL		(0 << TSP_TEXTURE_INSTRUCTION_SHIFT)
-#define TSP_TEXTURE_INSTRUCTION_MODULATE	(1 << TSP_TEXTURE_INSTRUCTION_SHIFT)
-#define TSP_TEXTURE_INSTRUCTION_DECAL_ALPHA	(2 << TSP_TEXTURE_INSTRUCTION_SHIFT)
-#define TSP_TEXTURE_INSTRUCTION_MODULATE_ALPHA	(3 << TSP_TEXTURE_INSTRUCTION_SHIFT)
-#define TSP_TEXTURE_INSTRUCTION_MASK		(3 << TSP_TEXTURE_INSTRUCTION_SHIFT)
-
-// Texture U size, bits 5-3
-#define TSP_TEXTURE_U_SIZE_SHIFT		3
-#define TSP_TEXTURE_U_SIZE_8			(0 << TSP_TEXTURE_U_SIZE_SHIFT)
-#define TSP_TEXTURE_U_SIZE_16			(1 << TSP_TEXTURE_U_SIZE_SHIFT)
-#define TSP_TEXTURE_U_SIZE_32			(2 << TSP_TEXTURE_U_SIZE_SHIFT)
-#define TSP_TEXTURE_U_SIZE_64			(3 << TSP_TEXTURE_U_SIZE_SHIFT)
-#define TSP_TEXTURE_U_SIZE_128			(4 << TSP_TEXTURE_U_SIZE_SHIFT)
-#define TSP_TEXTURE_U_SIZE_256			(5 << TSP_TEXTURE_U_SIZE_SHIFT)
-#define TSP_TEXTURE_U_SIZE_512			(6 << TSP_TEXTURE_U_SIZE_SHIFT)
-#define TSP_TEXTURE_U_SIZE_1024			(7 << TSP_TEXTURE_U_SIZE_SHIFT)
-#define TSP_TEXTURE_U_SIZE_MASK			(7 << TSP_TEXTURE_U_SIZE_SHIFT)
-
-// Texture V size, bits 2-0
-#define TSP_TEXTURE_V_SIZE_SHIFT		0
-#define TSP_TEXTURE_V_SIZE_8			(0 << TSP_TEXTURE_V_SIZE_SHIFT)
-#define TSP_TEXTURE_V_SIZE_16			(1 << TSP_TEXTURE_V_SIZE_SHIFT)
-#define TSP_TEXTURE_V_SIZE_32			(2 << TSP_TEXTURE_V_SIZE_SHIFT)
-#define TSP_TEXTURE_V_SIZE_64			(3 << TSP_TEXTURE_V_SIZE_SHIFT)
-#define TSP_TEXTURE_V_SIZE_128			(4 << TSP_TEXTURE_V_SIZE_SHIFT)
-#define TSP_TEXTURE_V_SIZE_256			(5 << TSP_TEXTURE_V_SIZE_SHIFT)
-#define TSP_TEXTURE_V_SIZE_512			(6 << TSP_TEXTURE_V_SIZE_SHIFT)
-#define TSP_TEXTURE_V_SIZE_1024			(7 << TSP_TEXTURE_V_SIZE_SHIFT)
-#define TSP_TEXTURE_V_SIZE_MASK			(7 << TSP_TEXTURE_V_SIZE_SHIFT)
-
-/////////////////////////////////////////////////////
-// Texture control word                            //
-/////////////////////////////////////////////////////
-
-// Mipmapped, bit 31
-#define TCW_MIPMAP_SHIFT			31
-#define TCW_MIPMAP_DISABLED			(0 << TCW_MIPMAP_SHIFT)
-#define TCW_MIPMAP_ENABLED			(1 << TCW_MIPMAP_SHIFT)
-#define TCW_MIPMAP_MASK				(1 << TCW_MIPMAP_SHIFT)
-
-// VQ compressed, bit 30
-#define TCW_VQ_COMPRESSED_SHIFT			30
-#define TCW_VQ_COMPRESSED_DISABLED		(0 << TCW_VQ_COMPRESSED_SHIFT)
-#define TCW_VQ_COMPRESSED_ENABLED		(1 << TCW_VQ_COMPRESSED_SHIFT)
-#define TCW_VQ_COMPRESSED_MASK			(1 << TCW_VQ_COMPRESSED_SHIFT)
-
-// Texture format, bits 29-27
-#define TCW_PIXEL_FORMAT_SHIFT			27
-#define TCW_PIXEL_FORMAT_ARGB1555		(0 << TCW_PIXEL_FORMAT_SHIFT)
-#define TCW_PIXEL_FORMAT_RGB565			(1 << TCW_PIXEL_FORMAT_SHIFT)
-#define TCW_PIXEL_FORMAT_ARGB4444		(2 << TCW_PIXEL_FORMAT_SHIFT)
-#define TCW_PIXEL_FORMAT_YUV422			(3 << TCW_PIXEL_FORMAT_SHIFT)
-#define TCW_PIXEL_FORMAT_BUMP_MAP		(4 << TCW_PIXEL_FORMAT_SHIFT)
-#define TCW_PIXEL_FORMAT_PAL_4BPP		(5 << TCW_PIXEL_FORMAT_SHIFT)
-#define TCW_PIXEL_FORMAT_PAL_8BPP		(6 << TCW_PIXEL_FORMAT_SHIFT)
-#define TCW_PIXEL_FORMAT_MASK			(7 << TCW_PIXEL_FORMAT_SHIFT)
-
-// Twiddled (for non-paletted textures), bit 26
-#define TCW_TWIDDLED_SHIFT			26
-#define TCW_TWIDDLED_DISABLED			(1 << TCW_TWIDDLED_SHIFT)
-#define TCW_TWIDDLED_ENABLED			(0 << TCW_TWIDDLED_SHIFT)
-#define TCW_TWIDDLED_MASK			(1 << TCW_TWIDDLED_SHIFT)
-
-// Stride enable (for non-paletted textures), bit 25
-#define TCW_STRIDE_SHIFT			25
-#define TCW_STRIDE_DISABLED			(0 << TCW_STRIDE_SHIFT)
-#define TCW_STRIDE_ENABLED			(1 << TCW_STRIDE_SHIFT)
-#define TCW_STRIDE_MASK				(1 << TCW_STRIDE_SHIFT)
-
-// Palette index (for paletted textures), bits 26-21
-#define TCW_PALETTE_INDEX_4BPP_SHIFT		21
-#define TCW_PALETTE_INDEX_4BPP_MASK		(63 << TCW_PALETTE_INDEX_4BPP_SHIFT)
-#define TCW_PALETTE_INDEX_8BPP_SHIFT		25
-#define TCW_PALETTE_INDEX_8BPP_MASK		(63 << TCW_PALETTE_INDEX_8BPP_SHIFT)
-
-// Texture address, bits 20-0
-#define TCW_TEXTURE_ADDRESS(addr)		((((uint32)(void*)(addr))&0x7fffff)>>3)
-#define TCW_TEXTURE_ADDRESS_MASK		(0x000FFFFF)
+#include "shdefs.h"
+#include "shcolor.h"
 
+/*
+===============================================================================
+
+STATISTICS
+
+===============================================================================
+*/
+
+#ifdef SH_STATS
+shstats_t sh_stats;
+#endif
+
+void shGetStats( shstats_t* stats )
+{
+#ifdef SH_STATS
+    *stats = sh_stats;
+#else
+    memset( stats, 0, sizeof(shstats_t) );
+#endif
+}
+
+void shResetStats( void )
+{
+#ifdef SH_STATS
+    memset( &sh_stats, 0, sizeof(shstats_t) );
+#endif
+}
 
 /*
 ===============================================================================
@@ -359,18 +54,187 @@ ERROR HANDLER FUNCTIONS
 */
 
 static void (*_error_handler)(SHERROR, const char* fnname) = NULL;
+static sherrorring_t* _error_ring = NULL;
+
+// The current context is per thread, so threads with their own context never
+// touch each other's state. Toolchains without thread local storage can
+// define SH_NO_TLS to get a single current context for the whole program,
+// which shMakeCurrent then hands to one context at a time.
+#if defined(SH_NO_TLS)
+#define SH_THREAD_LOCAL
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define SH_THREAD_LOCAL	_Thread_local
+#elif defined(__GNUC__)
+#define SH_THREAD_LOCAL	__thread
+#else
+#error "No thread local storage for the current context, define SH_NO_TLS"
+#endif
+
+static SH_THREAD_LOCAL sh_context_t* _current_context = NULL;
+
+static inline sh_context_t* current_context( void )
+{
+#ifdef SH_NO_TLS
+    return __atomic_load_n( &_current_context, __ATOMIC_ACQUIRE );
+#else
+    return _current_context;
+#endif
+}
 
 void shErrorHandler( void (*hnd)(SHERROR, const char* fnname) )
 {
     _error_handler = hnd;
 }
 
-static inline void report_error( SHERROR err, const char* fnname )
+int shErrorRingInit( sherrorring_t* ring, sherrorentry_t* entries, uint32 capacity )
+{
+    ring->entries = entries;
+    ring->capacity = capacity;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->overflow = 0;
+
+    // Entries are found by masking, which needs a power of two. A ring
+    // without room counts every error as an overflow and is always empty.
+    if ( capacity == 0 || ( capacity & ( capacity - 1 ) ) != 0 )
+    {
+        ring->capacity = 0;
+        report_error( SH_ERROR_OUT_OF_RANGE, __func__, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    return 1;
+}
+
+void shErrorRing( sherrorring_t* ring )
+{
+    _error_ring = ring;
+}
+
+int shErrorRingPop( sherrorring_t* ring, sherrorentry_t* entry )
+{
+    const uint32 tail = ring->tail;
+
+    if ( tail == __atomic_load_n( &ring->head, __ATOMIC_ACQUIRE ) )
+        return 0;
+
+    *entry = ring->entries[tail & ( ring->capacity - 1 )];
+
+    // The entry has been read, so the reporting thread may reuse it
+    __atomic_store_n( &ring->tail, tail + 1, __ATOMIC_RELEASE );
+    return 1;
+}
+
+void shContextInit( sh_context_t* ctx )
+{
+    ctx->error_handler = NULL;
+    ctx->last_error = SH_ERROR_OK;
+    ctx->error_count = 0;
+    ctx->error_ring = NULL;
+}
+
+void shContextErrorHandler( sh_context_t* ctx, void (*hnd)(SHERROR, const char* fnname) )
+{
+    ctx->error_handler = hnd;
+}
+
+void shContextErrorRing( sh_context_t* ctx, sherrorring_t* ring )
+{
+    ctx->error_ring = ring;
+}
+
+int shMakeCurrent( sh_context_t* ctx )
+{
+#ifdef SH_NO_TLS
+    sh_context_t* expected = NULL;
+
+    if ( ctx == NULL )
+    {
+        __atomic_store_n( &_current_context, NULL, __ATOMIC_RELEASE );
+        return 1;
+    }
+
+    // Another context being current means another thread may be using it,
+    // and taking it over would send that thread's errors here
+    if ( ctx != current_context() && !__atomic_compare_exchange_n( &_current_context, &expected, ctx, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE ) )
+    {
+        report_error( SH_ERROR_NOT_ALLOWED, __func__, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+#else
+    _current_context = ctx;
+#endif
+
+    return 1;
+}
+
+sh_context_t* shGetCurrentContext( void )
+{
+    return current_context();
+}
+
+SHERROR shContextError( sh_context_t* ctx )
+{
+    const SHERROR err = ctx->last_error;
+
+    ctx->last_error = SH_ERROR_OK;
+    return err;
+}
+
+// Shipping builds can define SH_NO_VALIDATION to compile out all header type
+// and "allowed" checks along with error reporting. Every call is then assumed
+// to be valid, so the setters boil down to their mask and or, and the function
+// names passed around for error reporting are optimized away with the rest.
+// report_error itself is defined in shdefs.h.
+#ifndef SH_NO_VALIDATION
+
+// Appends an error to a ring, or counts it if the ring is full
+static void defer_error( sherrorring_t* ring, SHERROR err, const char* fnname, const void* hdr, uint32 type )
+{
+    const uint32 head = ring->head;
+    sherrorentry_t* e;
+
+    if ( head - __atomic_load_n( &ring->tail, __ATOMIC_ACQUIRE ) >= ring->capacity )
+    {
+        ring->overflow++;
+        return;
+    }
+
+    e = &ring->entries[head & ( ring->capacity - 1 )];
+    e->code = err;
+    e->fname = fnname;
+    e->hdr = hdr;
+    e->type = type;
+
+    __atomic_store_n( &ring->head, head + 1, __ATOMIC_RELEASE );
+}
+
+void sh_report_error( SHERROR err, const char* fnname, const void* hdr, uint32 type )
 {
-    if ( _error_handler != NULL )
+    sh_context_t* const ctx = current_context();
+
+    STAT_ADD( errors[err], 1 );
+
+    if ( ctx != NULL )
+    {
+        ctx->last_error = err;
+        ctx->error_count++;
+
+        if ( ctx->error_ring != NULL )
+            defer_error( ctx->error_ring, err, fnname, hdr, type );
+        else if ( ctx->error_handler != NULL )
+            (*ctx->error_handler)( err, fnname );
+        return;
+    }
+
+    if ( _error_ring != NULL )
+        defer_error( _error_ring, err, fnname, hdr, type );
+    else if ( _error_handler != NULL )
         (*_error_handler)( err, fnname );
 }
 
+#endif
+
 /*
 ===============================================================================
 
@@ -379,43 +243,27 @@ STRIP HEADER UTILITIES
 ===============================================================================
 */
 
-// Used to index the "words" array of a strip header
-#define PCW	0
-#define ISPTSP	1
-#define TSP0	2
-#define TCW0	3
-#define TSP1	4
-#define TCW1	5
-
-// There's an "allowed" system in place to make sure bits aren't set for
-// header types where they cannot be changed.
-// These will help a lot for setting up "allowed masks".
-#define BIT(n)			(1<<(n))
-// All polygon types
-#define TYPES_POLYGON		(BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4)|BIT(5)|BIT(6)|BIT(7)|BIT(8)|BIT(9)|BIT(10)|BIT(11)|BIT(12)|BIT(13)|BIT(14))
-// All sprite types
-#define TYPES_SPRITE		(BIT(15)|BIT(16))
-// Modifier type
-#define TYPES_MODIFIER  	(BIT(17))
-// Polygons and sprites
-#define TYPES_POLYSPRITE	(TYPES_POLYGON|TYPES_SPRITE)
-// All types
-#define TYPES_ALL		(TYPES_POLYGON|TYPES_SPRITE|TYPES_MODIFIER)
-// Textured types
-#define TYPES_TEXTURED		(BIT(3)|BIT(4)|BIT(5)|BIT(6)|BIT(7)|BIT(8)|BIT(11)|BIT(12)|BIT(13)|BIT(14)|BIT(16))
-// Types affected by cheap shadow modifiers
-#define TYPES_SHADOW		(BIT(0)|BIT(1)|BIT(2)|BIT(3)|BIT(4)|BIT(5)|BIT(6)|BIT(7)|BIT(8))
-// Types affected by two-parameter modifiers
-#define TYPES_POLYGON_2		(BIT(9)|BIT(10)|BIT(11)|BIT(12)|BIT(13)|BIT(14))
-// Textured types affected by two-parameter modifiers
-#define TYPES_TEXTURED_2	(TYPES_POLYGON_2 & TYPES_TEXTURED)
-// Intensity color types
-#define TYPES_INTENSITY		(BIT(2)|BIT(7)|BIT(8)|BIT(10)|BIT(13)|BIT(14))
+// Returns 1 if <type> is a valid header type, otherwise 0.
+static inline int check_type( uint32 type )
+{
+#ifdef SH_NO_VALIDATION
+    (void)type;
+    return 1;
+#else
+    return ( type <= 17 );
+#endif
+}
 
 // Returns 1 if bit <type> can be found in bitfield <types>, otherwise 0.
 static inline int check_allowed( uint32 type, uint32 types )
 {
+#ifdef SH_NO_VALIDATION
+    (void)type;
+    (void)types;
+    return 1;
+#else
     return ( ( types & BIT(type) ) != 0 );
+#endif
 }
 
 // The following two functions are "safe" ways of setting boolean and generic values
@@ -424,76 +272,50 @@ static inline int check_allowed( uint32 type, uint32 types )
 // do the error handling at a higher level to avoid passing top level functions
 // everywhere, the amount of top level error checking would just be insane.
 
-static int set_boolean_safe( stripheader_t* hdr, const char* fnname, int cond, int affected_word, uint32 allowed_types, uint32 bitmask, uint32 tval, uint32 fval )
+static inline int set_boolean_safe( stripheader_t* hdr, const char* fnname, int cond, int affected_word, uint32 allowed_types, uint32 bitmask, uint32 tval, uint32 fval )
 {
-    if ( hdr->type > 17 )
+    STAT_ADD( setter_calls, 1 );
+
+    if ( !check_type( hdr->type ) )
     {
-        report_error( SH_ERROR_INVALID_TYPE, fnname );
+        report_error( SH_ERROR_INVALID_TYPE, fnname, hdr, hdr->type );
         return 0;
     }
 
     if ( !check_allowed( hdr->type, allowed_types ) )
     {
-        report_error( SH_ERROR_NOT_ALLOWED, fnname );
+        report_error( SH_ERROR_NOT_ALLOWED, fnname, hdr, hdr->type );
         return 0;
     }
 
     hdr->words[ affected_word ] &= ~bitmask;
     hdr->words[ affected_word ] |= ( cond ? tval : fval );
+    hdr->dirty = 1;
     return 1;
 }
 
-static int set_generic_safe( stripheader_t* hdr, const char* fnname, int affected_word, uint32 allowed_types, uint32 bitmask, uint32 shift, uint32 value )
+static inline int set_generic_safe( stripheader_t* hdr, const char* fnname, int affected_word, uint32 allowed_types, uint32 bitmask, uint32 shift, uint32 value )
 {
-    if ( hdr->type > 17 )
+    STAT_ADD( setter_calls, 1 );
+
+    if ( !check_type( hdr->type ) )
     {
-        report_error( SH_ERROR_INVALID_TYPE, fnname );
+        report_error( SH_ERROR_INVALID_TYPE, fnname, hdr, hdr->type );
         return 0;
     }
 
     if ( !check_allowed( hdr->type, allowed_types ) )
     {
-        report_error( SH_ERROR_NOT_ALLOWED, fnname );
+        report_error( SH_ERROR_NOT_ALLOWED, fnname, hdr, hdr->type );
         return 0;
     }
 
     hdr->words[ affected_word ] &= ~bitmask;
     hdr->words[ affected_word ] |= ( ( value << shift ) & bitmask );
+    hdr->dirty = 1;
     return 1;
 }
 
-// Default parameter control words (just OR in the list and you're set)
-static const uint32 default_pcw[18] = 
-{
-/*00*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_DISABLE | PCW_SHADING_GOURAUD,
-/*01*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_FLOAT     | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_DISABLE | PCW_SHADING_GOURAUD,
-/*02*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_DISABLE | PCW_SHADING_GOURAUD,
-/*03*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_32BIT,
-/*04*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_16BIT,
-/*05*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_FLOAT     | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_32BIT,
-/*06*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_FLOAT     | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_16BIT,
-/*07*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_32BIT,
-/*08*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_DISABLE | PCW_MODIFIER_TYPE_SHADOW | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_16BIT,
-/*09*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_DISABLE | PCW_SHADING_GOURAUD,
-/*10*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_DISABLE | PCW_SHADING_GOURAUD,
-/*11*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_32BIT,
-/*12*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_16BIT,
-/*13*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_32BIT,
-/*14*/	PCW_TYPE_POLYGON  | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_INTENSITY | PCW_MODIFIER_ENABLE  | PCW_MODIFIER_TYPE_NORMAL | PCW_TEXTURE_ENABLE  | PCW_SHADING_GOURAUD | PCW_UV_16BIT,
-/*15*/	PCW_TYPE_SPRITE   | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_TEXTURE_DISABLE  | PCW_SHADING_FLAT,
-/*16*/	PCW_TYPE_SPRITE   | PCW_UPDATE_GROUP_ON | PCW_STRIP_LENGTH_2 | PCW_COLOR_TYPE_PACKED    | PCW_TEXTURE_ENABLE   | PCW_SHADING_FLAT | PCW_UV_16BIT,
-/*17*/	PCW_TYPE_MODIFIER | PCW_MODIFIER_TRIANGLE
-};
-
-// Default isp/tsp words
-static const uint32 default_isptsp = ISP_TSP_DEPTH_COMPARE_GREATER_OR_EQUAL | ISP_TSP_CULL_MODE_NONE | ISP_TSP_Z_WRITE_ENABLE | ISP_TSP_DCALC_DISABLE;
-static const uint32 default_isptsp_mod = ISP_TSP_VOLUME_INSTRUCTION_NORMAL | ISP_TSP_CULL_MODE_NONE;
-
-// Default tsp words
-#define TSP_BASE ( TSP_SRC_SELECT_DISABLE | TSP_DST_SELECT_DISABLE | TSP_FOG_MODE_DISABLE | TSP_COLOR_CLAMP_DISABLE | TSP_UV_FLIP_NONE | TSP_UV_CLAMP_NONE | TSP_TEXTURE_FILTER_POINT | TSP_SUPER_SAMPLING_DISABLE | TSP_MIPMAP_ADJUST_1_00 )
-static const uint32 default_tsp_alpha   = TSP_BASE | TSP_ALPHA_ENABLE  | TSP_TEXTURE_ALPHA_ENABLE  | TSP_SRC_ALPHA_INSTR_SRC_ALPHA | TSP_DST_ALPHA_INSTR_INVERSE_SRC_ALPHA | TSP_TEXTURE_INSTRUCTION_MODULATE_ALPHA;
-static const uint32 default_tsp_noalpha = TSP_BASE | TSP_ALPHA_DISABLE | TSP_TEXTURE_ALPHA_DISABLE | TSP_SRC_ALPHA_INSTR_ONE       | TSP_DST_ALPHA_INSTR_ZERO              | TSP_TEXTURE_INSTRUCTION_MODULATE;
-
 /*
 ===============================================================================
 
@@ -504,9 +326,9 @@ STRIP HEADER METHODS
 
 int shInit( stripheader_t* hdr, uint32 type, pvr_list_t list, const texture_t* tex0, const texture_t* tex1 )
 {
-    if ( type > 17 )
+    if ( !check_type( type ) )
     {
-        report_error( SH_ERROR_INVALID_TYPE, __func__ );
+        report_error( SH_ERROR_INVALID_TYPE, __func__, hdr, type );
         return 0;
     }
 
@@ -515,12 +337,14 @@ int shInit( stripheader_t* hdr, uint32 type, pvr_list_t list, const texture_t* t
     // initialization if that's the case.
     if ( type == 17 )
     {
+#ifndef SH_NO_VALIDATION
         // Make sure modifiers have a modifier list specified
         if ( list == PVR_LIST_OP_POLY || list == PVR_LIST_TR_POLY || list == PVR_LIST_PT_POLY )
         {
-            report_error( SH_ERROR_INVALID_LIST, __func__ );
+            report_error( SH_ERROR_INVALID_LIST, __func__, hdr, type );
             return 0;
         }
+#endif
 
         // Start with a cleared header
         memset( hdr, 0, sizeof(stripheader_t) );
@@ -529,6 +353,7 @@ int shInit( stripheader_t* hdr, uint32 type, pvr_list_t list, const texture_t* t
         hdr->type = type;
         hdr->words[PCW] = default_pcw[type] | ( list << PCW_LIST_SHIFT );
         hdr->words[ISPTSP] = default_isptsp_mod;
+        hdr->dirty = 1;
     }
 
     // Every other type needs full initialization
@@ -536,12 +361,14 @@ int shInit( stripheader_t* hdr, uint32 type, pvr_list_t list, const texture_t* t
     {
         int twoparam, textured;
 
+#ifndef SH_NO_VALIDATION
         // Make sure polygons and sprites have non-modifier lists specified
         if ( list == PVR_LIST_OP_MOD || list == PVR_LIST_TR_MOD )
         {
-            report_error( SH_ERROR_INVALID_LIST, __func__ );
+            report_error( SH_ERROR_INVALID_LIST, __func__, hdr, type );
             return 0;
         }
+#endif
 
         // Set the header type, PCW and ISP/TSP word
         hdr->type = type;
@@ -572,57 +399,31 @@ int shInit( stripheader_t* hdr, uint32 type, pvr_list_t list, const texture_t* t
             hdr->words[TCW1] = 0;
         }
 
-        // Clear this one as well, just to be nice.. :)
-        hdr->unused = 0;
+        // Nothing has been baked yet
+        hdr->dirty = 1;
 
         // Clear colors to white
         hdr->color0[0] = hdr->color0[1] = hdr->color0[2] = hdr->color0[3] = 1.0f;
         hdr->color1[0] = hdr->color1[1] = hdr->color1[2] = hdr->color1[3] = 1.0f;
+        hdr->sprColor[0] = hdr->sprColor[1] = hdr->sprColor[2] = hdr->sprColor[3] = 0xFF;
     }
 
     return 1;
 }
 
-// Generic enable/disable method so we don't have to do this large
-// switch statement twice.
+// Generic enable/disable method so we don't have to do the lookup twice.
 static int set_enabled( stripheader_t* hdr, const char* fnname, SHCAPABILITY cap, int enable )
 {
-    switch ( cap )
+    const capability_t* c;
+
+    if ( (uint32)cap >= NUM_CAPABILITIES )
     {
-        case SH_AFFECTED_BY_MODIFIER:
-            return set_boolean_safe( hdr, fnname, enable, PCW, TYPES_SHADOW, PCW_MODIFIER_MASK, PCW_MODIFIER_ENABLE, PCW_MODIFIER_DISABLE );
-        case SH_SMOOTH_SHADING:
-            return set_boolean_safe( hdr, fnname, enable, PCW, TYPES_POLYGON, PCW_SHADING_MASK, PCW_SHADING_GOURAUD, PCW_SHADING_FLAT );
-        case SH_OFFSET_COLOR:
-            return set_boolean_safe( hdr, fnname, enable, PCW, TYPES_TEXTURED, PCW_OFFSET_COLOR_MASK, PCW_OFFSET_COLOR_ENABLE, PCW_OFFSET_COLOR_DISABLE );
-        case SH_USE_PREVIOUS_COLOR:
-            return set_boolean_safe( hdr, fnname, enable, PCW, TYPES_INTENSITY, PCW_COLOR_TYPE_MASK, PCW_COLOR_TYPE_PREV_INTENSITY, PCW_COLOR_TYPE_INTENSITY );
-        case SH_DCALC_CONTROL:
-            return set_boolean_safe( hdr, fnname, enable, ISPTSP, TYPES_TEXTURED, ISP_TSP_DCALC_MASK, ISP_TSP_DCALC_ENABLE, ISP_TSP_DCALC_DISABLE );
-        case SH_ALPHA:
-            return set_boolean_safe( hdr, fnname, enable, TSP0, TYPES_POLYSPRITE, TSP_ALPHA_MASK, TSP_ALPHA_ENABLE, TSP_ALPHA_DISABLE );
-        case SH_ALPHA_2:
-            return set_boolean_safe( hdr, fnname, enable, TSP1, TYPES_POLYGON_2, TSP_ALPHA_MASK, TSP_ALPHA_ENABLE, TSP_ALPHA_DISABLE );
-        case SH_SRC_SELECT:
-            return set_boolean_safe( hdr, fnname, enable, TSP0, TYPES_POLYSPRITE, TSP_SRC_SELECT_MASK, TSP_SRC_SELECT_ENABLE, TSP_SRC_SELECT_DISABLE );
-        case SH_SRC_SELECT_2:
-            return set_boolean_safe( hdr, fnname, enable, TSP1, TYPES_POLYGON_2, TSP_SRC_SELECT_MASK, TSP_SRC_SELECT_ENABLE, TSP_SRC_SELECT_DISABLE );
-        case SH_DST_SELECT:
-            return set_boolean_safe( hdr, fnname, enable, TSP0, TYPES_POLYSPRITE, TSP_DST_SELECT_MASK, TSP_DST_SELECT_ENABLE, TSP_DST_SELECT_DISABLE );
-        case SH_DST_SELECT_2:
-            return set_boolean_safe( hdr, fnname, enable, TSP1, TYPES_POLYGON_2, TSP_DST_SELECT_MASK, TSP_DST_SELECT_ENABLE, TSP_DST_SELECT_DISABLE );
-        case SH_TEXTURE_ALPHA:
-            return set_boolean_safe( hdr, fnname, enable, TSP0, TYPES_TEXTURED, TSP_TEXTURE_ALPHA_MASK, TSP_TEXTURE_ALPHA_ENABLE, TSP_TEXTURE_ALPHA_DISABLE );
-        case SH_TEXTURE_ALPHA_2:
-            return set_boolean_safe( hdr, fnname, enable, TSP1, TYPES_TEXTURED_2, TSP_TEXTURE_ALPHA_MASK, TSP_TEXTURE_ALPHA_ENABLE, TSP_TEXTURE_ALPHA_DISABLE );
-        case SH_TEX_SUPER_SAMPLING:
-            return set_boolean_safe( hdr, fnname, enable, TSP0, TYPES_TEXTURED, TSP_SUPER_SAMPLING_MASK, TSP_SUPER_SAMPLING_ENABLE, TSP_SUPER_SAMPLING_DISABLE );
-        case SH_TEX_SUPER_SAMPLING_2:
-            return set_boolean_safe( hdr, fnname, enable, TSP1, TYPES_TEXTURED_2, TSP_SUPER_SAMPLING_MASK, TSP_SUPER_SAMPLING_ENABLE, TSP_SUPER_SAMPLING_DISABLE );
+        report_error( SH_ERROR_CAPABILITY, fnname, hdr, hdr->type );
+        return 0;
     }
 
-    report_error( SH_ERROR_CAPABILITY, fnname );
-    return 0;
+    c = &capabilities[cap];
+    return set_boolean_safe( hdr, fnname, enable, c->word, c->allowed_types, c->bitmask, c->tval, c->fval );
 }
 
 int shEnable( stripheader_t* hdr, SHCAPABILITY cap )  { return set_enabled( hdr, __func__, cap, 1 ); }
@@ -634,6 +435,21 @@ int shCullMode( stripheader_t* hdr, SHCULLMODE mode )
     return set_generic_safe( hdr, __func__, ISPTSP, TYPES_ALL, ISP_TSP_CULL_MODE_MASK, ISP_TSP_CULL_MODE_SHIFT, mode );
 }
 
+int shDepthFunc( stripheader_t* hdr, SHDEPTHFUNC func )
+{
+    return set_generic_safe( hdr, __func__, ISPTSP, TYPES_POLYSPRITE, ISP_TSP_DEPTH_COMPARE_MASK, ISP_TSP_DEPTH_COMPARE_SHIFT, func );
+}
+
+int shUserClip( stripheader_t* hdr, SHUSERCLIP mode )
+{
+    return set_generic_safe( hdr, __func__, PCW, TYPES_ALL, PCW_USER_CLIP_MASK, PCW_USER_CLIP_SHIFT, mode );
+}
+
+int shStripLength( stripheader_t* hdr, SHSTRIPLENGTH length )
+{
+    return set_generic_safe( hdr, __func__, PCW, TYPES_POLYSPRITE, PCW_STRIP_LENGTH_MASK, PCW_STRIP_LENGTH_SHIFT, length );
+}
+
 int shFogMode( stripheader_t* hdr, SHFOGMODE mode )
 {
     return set_generic_safe( hdr, __func__, TSP0, TYPES_POLYSPRITE, TSP_FOG_MODE_MASK, TSP_FOG_MODE_SHIFT, mode );
@@ -676,6 +492,145 @@ int shBlendFunc2( stripheader_t* hdr, SHBLENDFUNC src, SHBLENDFUNC dst )
             set_generic_safe( hdr, __func__, TSP1, TYPES_POLYGON_2, TSP_DST_ALPHA_INSTR_MASK, TSP_DST_ALPHA_INSTR_SHIFT, dst );
 }
 
+// Masks built up by shSetState before anything is written
+typedef struct
+{
+    uint32	clear[6];
+    uint32	set[6];
+    uint32	allowed_types;
+} state_masks_t;
+
+static inline void add_state_field( state_masks_t* m, int word, uint32 allowed_types, uint32 bitmask, uint32 value )
+{
+    m->clear[word] |= bitmask;
+    m->set[word] = ( m->set[word] & ~bitmask ) | ( value & bitmask );
+    m->allowed_types &= allowed_types;
+}
+
+// Builds the masks for a state block and checks them against a header type.
+// Shared by headers, compact headers and material pools.
+static int build_state_masks( state_masks_t* m_out, const void* obj, uint32 type, const char* fnname, const SHSTATE* state )
+{
+    state_masks_t m;
+    uint32 i, caps;
+
+    if ( !check_type( type ) )
+    {
+        report_error( SH_ERROR_INVALID_TYPE, fnname, obj, type );
+        return 0;
+    }
+
+    for ( i = 0; i < 6; i++ )
+    {
+        m.clear[i] = 0;
+        m.set[i] = 0;
+    }
+    m.allowed_types = TYPES_ALL;
+
+    if ( state->flags & SH_STATE_BLEND )
+    {
+        add_state_field( &m, TSP0, TYPES_POLYSPRITE, TSP_SRC_ALPHA_INSTR_MASK, state->src << TSP_SRC_ALPHA_INSTR_SHIFT );
+        add_state_field( &m, TSP0, TYPES_POLYSPRITE, TSP_DST_ALPHA_INSTR_MASK, state->dst << TSP_DST_ALPHA_INSTR_SHIFT );
+    }
+    if ( state->flags & SH_STATE_BLEND_2 )
+    {
+        add_state_field( &m, TSP1, TYPES_POLYGON_2, TSP_SRC_ALPHA_INSTR_MASK, state->src2 << TSP_SRC_ALPHA_INSTR_SHIFT );
+        add_state_field( &m, TSP1, TYPES_POLYGON_2, TSP_DST_ALPHA_INSTR_MASK, state->dst2 << TSP_DST_ALPHA_INSTR_SHIFT );
+    }
+    if ( state->flags & SH_STATE_FOG )
+        add_state_field( &m, TSP0, TYPES_POLYSPRITE, TSP_FOG_MODE_MASK, state->fog << TSP_FOG_MODE_SHIFT );
+    if ( state->flags & SH_STATE_FOG_2 )
+        add_state_field( &m, TSP1, TYPES_POLYGON_2, TSP_FOG_MODE_MASK, state->fog2 << TSP_FOG_MODE_SHIFT );
+    if ( state->flags & SH_STATE_CULL )
+        add_state_field( &m, ISPTSP, TYPES_ALL, ISP_TSP_CULL_MODE_MASK, state->cull << ISP_TSP_CULL_MODE_SHIFT );
+    if ( state->flags & SH_STATE_DEPTH_FUNC )
+        add_state_field( &m, ISPTSP, TYPES_POLYSPRITE, ISP_TSP_DEPTH_COMPARE_MASK, (uint32)state->depth << ISP_TSP_DEPTH_COMPARE_SHIFT );
+    if ( state->flags & SH_STATE_USER_CLIP )
+        add_state_field( &m, PCW, TYPES_ALL, PCW_USER_CLIP_MASK, state->clip << PCW_USER_CLIP_SHIFT );
+    if ( state->flags & SH_STATE_STRIP_LENGTH )
+        add_state_field( &m, PCW, TYPES_POLYSPRITE, PCW_STRIP_LENGTH_MASK, state->strip << PCW_STRIP_LENGTH_SHIFT );
+    if ( state->flags & SH_STATE_FILTER )
+        add_state_field( &m, TSP0, TYPES_TEXTURED, TSP_TEXTURE_FILTER_MASK, state->filter << TSP_TEXTURE_FILTER_SHIFT );
+    if ( state->flags & SH_STATE_FILTER_2 )
+        add_state_field( &m, TSP1, TYPES_TEXTURED_2, TSP_TEXTURE_FILTER_MASK, state->filter2 << TSP_TEXTURE_FILTER_SHIFT );
+    if ( state->flags & SH_STATE_MIPMAP_ADJUST )
+        add_state_field( &m, TSP0, TYPES_TEXTURED, TSP_MIPMAP_ADJUST_MASK, state->mipmap << TSP_MIPMAP_ADJUST_SHIFT );
+    if ( state->flags & SH_STATE_MIPMAP_ADJUST_2 )
+        add_state_field( &m, TSP1, TYPES_TEXTURED_2, TSP_MIPMAP_ADJUST_MASK, state->mipmap2 << TSP_MIPMAP_ADJUST_SHIFT );
+
+    // Disables go first, so a capability in both masks ends up enabled
+    if ( ( state->disable | state->enable ) >> NUM_CAPABILITIES )
+    {
+        report_error( SH_ERROR_CAPABILITY, fnname, obj, type );
+        return 0;
+    }
+
+    for ( caps = state->disable, i = 0; caps != 0; caps >>= 1, i++ )
+    {
+        if ( caps & 1 )
+            add_state_field( &m, capabilities[i].word, capabilities[i].allowed_types, capabilities[i].bitmask, capabilities[i].fval );
+    }
+
+    for ( caps = state->enable, i = 0; caps != 0; caps >>= 1, i++ )
+    {
+        if ( caps & 1 )
+            add_state_field( &m, capabilities[i].word, capabilities[i].allowed_types, capabilities[i].bitmask, capabilities[i].tval );
+    }
+
+    // Nothing is changed unless everything is allowed
+    if ( !check_allowed( type, m.allowed_types ) )
+    {
+        report_error( SH_ERROR_NOT_ALLOWED, fnname, obj, type );
+        return 0;
+    }
+
+    *m_out = m;
+    return 1;
+}
+
+// Applies a state block to the words of a header of the given type.
+static int apply_state( const void* obj, uint32 type, uint32* words, const char* fnname, const SHSTATE* state )
+{
+    state_masks_t m;
+    int i;
+
+    STAT_ADD( setter_calls, 1 );
+
+    if ( !build_state_masks( &m, obj, type, fnname, state ) )
+        return 0;
+
+    for ( i = 0; i < 6; i++ )
+        words[i] = ( words[i] & ~m.clear[i] ) | m.set[i];
+
+    return 1;
+}
+
+int shStateMasks( uint32 type, const SHSTATE* state, uint32 clear[6], uint32 set[6] )
+{
+    state_masks_t m;
+    int i;
+
+    if ( !build_state_masks( &m, NULL, type, __func__, state ) )
+        return 0;
+
+    for ( i = 0; i < 6; i++ )
+    {
+        clear[i] = m.clear[i];
+        set[i] = m.set[i];
+    }
+
+    return 1;
+}
+
+int shSetState( stripheader_t* hdr, const SHSTATE* state )
+{
+    if ( !apply_state( hdr, hdr->type, hdr->words, __func__, state ) )
+        return 0;
+
+    hdr->dirty = 1;
+    return 1;
+}
+
 int shModifierInstruction( stripheader_t* hdr, SHMODIFIERINSTRUCTION instr ) 
 { 
 	// Need to set both both the instruction and the "last triangle in volume" flag.
@@ -692,17 +647,17 @@ int shPalette( stripheader_t* hdr, uint32 index )
         case TCW_PIXEL_FORMAT_PAL_4BPP:
             if ( index < 64 )
                 return set_generic_safe( hdr, __func__, TCW0, TYPES_TEXTURED, TCW_PALETTE_INDEX_4BPP_MASK, TCW_PALETTE_INDEX_4BPP_SHIFT, index );
-            report_error( SH_ERROR_PALETTE_OUT_OF_BOUNDS, __func__ );
+            report_error( SH_ERROR_PALETTE_OUT_OF_BOUNDS, __func__, hdr, hdr->type );
             break;
 
         case TCW_PIXEL_FORMAT_PAL_8BPP:
             if ( index < 4 )
                 return set_generic_safe( hdr, __func__, TCW0, TYPES_TEXTURED, TCW_PALETTE_INDEX_8BPP_MASK, TCW_PALETTE_INDEX_8BPP_SHIFT, index );
-            report_error( SH_ERROR_PALETTE_OUT_OF_BOUNDS, __func__ );
+            report_error( SH_ERROR_PALETTE_OUT_OF_BOUNDS, __func__, hdr, hdr->type );
             break;
 
         default:
-            report_error( SH_ERROR_NOT_PALETTED, __func__ );
+            report_error( SH_ERROR_NOT_PALETTED, __func__, hdr, hdr->type );
             break;
     }
 
@@ -718,23 +673,45 @@ int shPalette2( stripheader_t* hdr, uint32 index )
         case TCW_PIXEL_FORMAT_PAL_4BPP:
             if ( index < 64 )
                 return set_generic_safe( hdr, __func__, TCW1, TYPES_TEXTURED_2, TCW_PALETTE_INDEX_4BPP_MASK, TCW_PALETTE_INDEX_4BPP_SHIFT, index );
-            report_error( SH_ERROR_PALETTE_OUT_OF_BOUNDS, __func__ );
+            report_error( SH_ERROR_PALETTE_OUT_OF_BOUNDS, __func__, hdr, hdr->type );
             break;
 
         case TCW_PIXEL_FORMAT_PAL_8BPP:
             if ( index < 4 )
                 return set_generic_safe( hdr, __func__, TCW1, TYPES_TEXTURED_2, TCW_PALETTE_INDEX_8BPP_MASK, TCW_PALETTE_INDEX_8BPP_SHIFT, index );
-            report_error( SH_ERROR_PALETTE_OUT_OF_BOUNDS, __func__ );
+            report_error( SH_ERROR_PALETTE_OUT_OF_BOUNDS, __func__, hdr, hdr->type );
             break;
 
         default:
-            report_error( SH_ERROR_NOT_PALETTED, __func__ );
+            report_error( SH_ERROR_NOT_PALETTED, __func__, hdr, hdr->type );
             break;
     }
 
     return 0;
 }
 
+// Generates the texture control word and the texture size bits of the tsp
+// word for a texture. This is where all the size and format checks happen.
+// Returns 1 on success or 0 on failure.
+static int make_texture_desc( shtexturedesc_t* desc, const char* fnname, const texture_t* tex )
+{
+    if ( !texture_words( tex, &desc->tsp, &desc->tcw ) )
+    {
+        report_error( SH_ERROR_TEXTURE_SIZE, fnname, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    return 1;
+}
+
+// Writes a texture descriptor into the words of a header. NULL clears the texture.
+static inline void apply_texture_desc( uint32* words, int tsp, int tcw, const shtexturedesc_t* desc )
+{
+    words[tsp] &= ~( TSP_TEXTURE_U_SIZE_MASK | TSP_TEXTURE_V_SIZE_MASK );
+    words[tsp] |= ( desc != NULL ? desc->tsp : 0 );
+    words[tcw] = ( desc != NULL ? desc->tcw : 0 );
+}
+
 // This method will do what's needed to set a texture. This involves generating
 // a texture control word and setting the texture size flags in the tsp word.
 // hdr: Pointer to header that is to be modified
@@ -745,164 +722,169 @@ int shPalette2( stripheader_t* hdr, uint32 index )
 // Returns 1 on success or 0 on failure.
 static int set_texture( stripheader_t* hdr, const char* fnname, int tsp, int tcw, uint32 allowed, const texture_t* tex )
 {
+    shtexturedesc_t desc;
+
+    STAT_ADD( setter_calls, 1 );
+    STAT_ADD( texture_binds, 1 );
+
     // Make sure this operation is allowed
     if ( !check_allowed( hdr->type, allowed ) )
     {
         //dbglog( DBG_DEBUG, "%u\n", hdr->type );
-        report_error( SH_ERROR_NOT_ALLOWED, fnname );
+        report_error( SH_ERROR_NOT_ALLOWED, fnname, hdr, hdr->type );
         return 0;
     }
 
-    // Clear texture size bits in tsp word
-    hdr->words[tsp] &= ~TSP_TEXTURE_U_SIZE_MASK;
-    hdr->words[tsp] &= ~TSP_TEXTURE_V_SIZE_MASK;
-
-    // Clear texture control word
-    hdr->words[tcw] = 0;
-
-    if ( tex != NULL )
+    // The texture is cleared even if the new one turns out to be invalid
+    if ( tex == NULL || !make_texture_desc( &desc, fnname, tex ) )
     {
-        uint32 tmp = 0;
-        int paletted = 0;
-
-        switch ( tex->width )
-        {
-            case 8:	tmp |= TSP_TEXTURE_U_SIZE_8;	break;
-            case 16:	tmp |= TSP_TEXTURE_U_SIZE_16;	break;
-            case 32:	tmp |= TSP_TEXTURE_U_SIZE_32;	break;
-            case 64:	tmp |= TSP_TEXTURE_U_SIZE_64;	break;
-            case 128:	tmp |= TSP_TEXTURE_U_SIZE_128;	break;
-            case 256:	tmp |= TSP_TEXTURE_U_SIZE_256;	break;
-            case 512:	tmp |= TSP_TEXTURE_U_SIZE_512;	break;
-            case 1024:	tmp |= TSP_TEXTURE_U_SIZE_1024;	break;
-            default:
-                report_error( SH_ERROR_TEXTURE_SIZE, fnname );
-                return 0;
-        }
-
-        switch ( tex->height )
-        {
-            case 8:	tmp |= TSP_TEXTURE_V_SIZE_8;	break;
-            case 16:	tmp |= TSP_TEXTURE_V_SIZE_16;	break;
-            case 32:	tmp |= TSP_TEXTURE_V_SIZE_32;	break;
-            case 64:	tmp |= TSP_TEXTURE_V_SIZE_64;	break;
-            case 128:	tmp |= TSP_TEXTURE_V_SIZE_128;	break;
-            case 256:	tmp |= TSP_TEXTURE_V_SIZE_256;	break;
-            case 512:	tmp |= TSP_TEXTURE_V_SIZE_512;	break;
-            case 1024:	tmp |= TSP_TEXTURE_V_SIZE_1024;	break;
-            default:
-                report_error( SH_ERROR_TEXTURE_SIZE, fnname );
-                return 0;
-        }
+        apply_texture_desc( hdr->words, tsp, tcw, NULL );
+        hdr->dirty = 1;
+        return ( tex == NULL );
+    }
 
-        // Set texture sizes in tsp word
-        hdr->words[tsp] |= tmp;
+    apply_texture_desc( hdr->words, tsp, tcw, &desc );
+    hdr->dirty = 1;
+    return 1;
+}
 
-        // Mipmap and compression flags
-        hdr->words[tcw] |= ( ( tex->flags & TEXFLAG_MIPMAPPED ) ? TCW_MIPMAP_ENABLED : TCW_MIPMAP_DISABLED );
-        hdr->words[tcw] |= ( ( tex->flags & TEXFLAG_COMPRESSED ) ? TCW_VQ_COMPRESSED_ENABLED : TCW_VQ_COMPRESSED_DISABLED );
+int shTexture( stripheader_t* hdr, const texture_t* tex )  { return set_texture( hdr, __func__, TSP0, TCW0, TYPES_TEXTURED,   tex ); }
+int shTexture2( stripheader_t* hdr, const texture_t* tex ) { return set_texture( hdr, __func__, TSP1, TCW1, TYPES_TEXTURED_2, tex ); }
 
-        // Format
-        switch ( tex->format )
-        {
-            case TEXFMT_RGB565:         hdr->words[tcw] |= TCW_PIXEL_FORMAT_RGB565;	paletted = 0;	break;
-            case TEXFMT_ARGB1555:	hdr->words[tcw] |= TCW_PIXEL_FORMAT_ARGB1555;	paletted = 0;	break;
-            case TEXFMT_ARGB4444:	hdr->words[tcw] |= TCW_PIXEL_FORMAT_ARGB4444;	paletted = 0;	break;
-            case TEXFMT_PAL4BPP:	hdr->words[tcw] |= TCW_PIXEL_FORMAT_PAL_4BPP;	paletted = 1;	break;
-            case TEXFMT_PAL8BPP:	hdr->words[tcw] |= TCW_PIXEL_FORMAT_PAL_8BPP;	paletted = 1;	break;
-        }
+int shTextureDesc( shtexturedesc_t* desc, const texture_t* tex )
+{
+    return make_texture_desc( desc, __func__, tex );
+}
 
-        if ( paletted )
-        {
-            // Paletted textures are assumed to be twiddled and doesn't allow stride.
-            // This is because these settings occupy the same bits as palette index.
-        }
-        else
-        {
-            // Twiddle and stride flags
-            hdr->words[tcw] |= ( ( tex->flags & TEXFLAG_TWIDDLED ) ? TCW_TWIDDLED_ENABLED : TCW_TWIDDLED_DISABLED );
-            hdr->words[tcw] |= TCW_STRIDE_DISABLED;
-        }
+// Same as set_texture, but with all the work already done.
+// Works on the words directly so compact headers can use it too.
+static inline int set_texture_desc( const void* obj, uint32 type, uint32* words, const char* fnname, int tsp, int tcw, uint32 allowed, const shtexturedesc_t* desc )
+{
+    STAT_ADD( setter_calls, 1 );
+    STAT_ADD( texture_binds, 1 );
 
-        // Texture address
-        hdr->words[tcw] |= TCW_TEXTURE_ADDRESS( tex->vram_ptr );
+    if ( !check_allowed( type, allowed ) )
+    {
+        report_error( SH_ERROR_NOT_ALLOWED, fnname, obj, type );
+        return 0;
     }
 
+    apply_texture_desc( words, tsp, tcw, desc );
     return 1;
 }
 
-int shTexture( stripheader_t* hdr, const texture_t* tex )  { return set_texture( hdr, __func__, TSP0, TCW0, TYPES_TEXTURED,   tex ); }
-int shTexture2( stripheader_t* hdr, const texture_t* tex ) { return set_texture( hdr, __func__, TSP1, TCW1, TYPES_TEXTURED_2, tex ); }
+int shTextureFromDesc( stripheader_t* hdr, const shtexturedesc_t* desc )
+{
+    hdr->dirty = 1;
+    return set_texture_desc( hdr, hdr->type, hdr->words, __func__, TSP0, TCW0, TYPES_TEXTURED, desc );
+}
+
+int shTextureFromDesc2( stripheader_t* hdr, const shtexturedesc_t* desc )
+{
+    hdr->dirty = 1;
+    return set_texture_desc( hdr, hdr->type, hdr->words, __func__, TSP1, TCW1, TYPES_TEXTURED_2, desc );
+}
 
 int shBaseColor( stripheader_t* hdr, float a, float r, float g, float b )
 {
+    STAT_ADD( setter_calls, 1 );
+
     if ( check_allowed( hdr->type, TYPES_INTENSITY | TYPES_SPRITE ) )
     {
         hdr->color0[0] = a;
         hdr->color0[1] = r;
         hdr->color0[2] = g;
         hdr->color0[3] = b;
+        hdr->dirty = 1;
         return 1;
     }
 
-    report_error( SH_ERROR_NOT_ALLOWED, __func__ );
+    report_error( SH_ERROR_NOT_ALLOWED, __func__, hdr, hdr->type );
     return 0;
 }
 
 int shBaseColor2( stripheader_t* hdr, float a, float r, float g, float b )
 {
+    STAT_ADD( setter_calls, 1 );
+
     if ( check_allowed( hdr->type, TYPES_INTENSITY & TYPES_POLYGON_2 ) )
     {
         hdr->color1[0] = a;
         hdr->color1[1] = r;
         hdr->color1[2] = g;
         hdr->color1[3] = b;
+        hdr->dirty = 1;
         return 1;
     }
 
-    report_error( SH_ERROR_NOT_ALLOWED, __func__ );
+    report_error( SH_ERROR_NOT_ALLOWED, __func__, hdr, hdr->type );
     return 0;
-}
-
+}
+
 int shSpriteColor( stripheader_t* hdr, uint8 *const color) {
+	STAT_ADD( setter_calls, 1 );
 	hdr->sprColor[0] = color[3];
 	hdr->sprColor[1] = color[0];
 	hdr->sprColor[2] = color[1];
 	hdr->sprColor[3] = color[2];	
+	hdr->dirty = 1;
 	return 1;
-}
+}
+
+int shSpriteColorf( stripheader_t* hdr, float a, float r, float g, float b )
+{
+    uint32 argb;
+
+    STAT_ADD( setter_calls, 1 );
+
+    if ( !check_allowed( hdr->type, TYPES_SPRITE ) )
+    {
+        report_error( SH_ERROR_NOT_ALLOWED, __func__, hdr, hdr->type );
+        return 0;
+    }
+
+    argb = shPackColor( a, r, g, b );
+    hdr->sprColor[0] = argb >> 24;
+    hdr->sprColor[1] = argb >> 16;
+    hdr->sprColor[2] = argb >> 8;
+    hdr->sprColor[3] = argb;
+    hdr->dirty = 1;
+    return 1;
+}
 
 int shOffsetColor( stripheader_t* hdr, float a, float r, float g, float b )
 {
-    if ( check_allowed( hdr->type, ( TYPES_INTENSITY | TYPES_SPRITE ) & TYPES_TEXTURED ) && !check_allowed( hdr->type, TYPES_POLYGON_2 ) )
+    STAT_ADD( setter_calls, 1 );
+
+    if ( check_allowed( hdr->type, ( TYPES_INTENSITY | TYPES_SPRITE ) & TYPES_TEXTURED & ~TYPES_POLYGON_2 ) )
     {
         hdr->color1[0] = a;
         hdr->color1[1] = r;
         hdr->color1[2] = g;
         hdr->color1[3] = b;
+        hdr->dirty = 1;
         return 1;
     }
 
-    report_error( SH_ERROR_NOT_ALLOWED, __func__ );
+    report_error( SH_ERROR_NOT_ALLOWED, __func__, hdr, hdr->type );
     return 0;
 }
 
 
 /***** Commit ****************************************************************/
 
-#define PREFETCH(addr) __asm__ __volatile__("pref @%0" : : "r" (addr))
-
+// Builds the block of words that's sent for a header.
 // TODO: Remove all 0 writes perhaps? Dunno if the pvr cares about those.
-int shCommit( stripheader_t* header, uint32* ptr )
+static int bake( const stripheader_t* header, shblock_t* block )
 {
-    int size_in_words = 0;
+    uint32* out = block->words;
+    int size_in_words = 8;
 
-    // Quit now if the header is invalid
-    if ( header->type > 17 )
-    {
-        report_error( SH_ERROR_INVALID_TYPE, __func__ );
-        return 0;
-    }
+    // These first four words are the same for all headers
+    out[0] = header->words[PCW];
+    out[1] = header->words[ISPTSP];
+    out[2] = header->words[TSP0];
+    out[3] = header->words[TCW0];
 
     switch ( header->type )
     {
@@ -913,21 +895,18 @@ int shCommit( stripheader_t* header, uint32* ptr )
         case 5:
         case 6:
         case 17:
-            ptr += 8;
-            *--ptr	= 0;
-            *--ptr	= 0;
-            *--ptr	= 0;
-            *--ptr	= 0;
-            size_in_words = 8;
+        default:
+            out[4] = 0;
+            out[5] = 0;
+            out[6] = 0;
+            out[7] = 0;
             break;
 
         case 2:
-            ptr += 8;
-            *(float*)--ptr = header->color0[3];	// Doesn't matter when using previous face color
-            *(float*)--ptr = header->color0[2];	// Doesn't matter when using previous face color
-            *(float*)--ptr = header->color0[1];	// Doesn't matter when using previous face color
-            *(float*)--ptr = header->color0[0];	// Doesn't matter when using previous face color
-            size_in_words = 8;
+            out[4] = float_bits( header->color0[0] );	// Doesn't matter when using previous face color
+            out[5] = float_bits( header->color0[1] );	// Doesn't matter when using previous face color
+            out[6] = float_bits( header->color0[2] );	// Doesn't matter when using previous face color
+            out[7] = float_bits( header->color0[3] );	// Doesn't matter when using previous face color
             break;
 
         case 7:
@@ -935,104 +914,455 @@ int shCommit( stripheader_t* header, uint32* ptr )
             if ( ( ( header->words[PCW] & PCW_COLOR_TYPE_MASK ) == PCW_COLOR_TYPE_INTENSITY ) &&
                     ( ( header->words[PCW] & PCW_OFFSET_COLOR_MASK ) == PCW_OFFSET_COLOR_ENABLE ) )
             {
-                ptr += 16;
-                *(float*)--ptr = header->color1[3];
-                *(float*)--ptr = header->color1[2];
-                *(float*)--ptr = header->color1[1];
-                *(float*)--ptr = header->color1[0];
-                *(float*)--ptr = header->color0[3];
-                *(float*)--ptr = header->color0[2];
-                *(float*)--ptr = header->color0[1];
-                *(float*)--ptr = header->color0[0];
-                PREFETCH( (void*)ptr );
-                *--ptr	= 0;
-                *--ptr	= 0;
-                *--ptr	= 0;
-                *--ptr	= 0;
+                out[4] = 0;
+                out[5] = 0;
+                out[6] = 0;
+                out[7] = 0;
+                out[8]  = float_bits( header->color0[0] );
+                out[9]  = float_bits( header->color0[1] );
+                out[10] = float_bits( header->color0[2] );
+                out[11] = float_bits( header->color0[3] );
+                out[12] = float_bits( header->color1[0] );
+                out[13] = float_bits( header->color1[1] );
+                out[14] = float_bits( header->color1[2] );
+                out[15] = float_bits( header->color1[3] );
                 size_in_words = 16;
             }
             else
             {
-                ptr += 8;
-                *(float*)--ptr	= header->color0[3];	// Doesn't matter when using previous face color
-                *(float*)--ptr	= header->color0[2];	// Doesn't matter when using previous face color
-                *(float*)--ptr	= header->color0[1];	// Doesn't matter when using previous face color
-                *(float*)--ptr	= header->color0[0];	// Doesn't matter when using previous face color
-                size_in_words = 8;
+                out[4] = float_bits( header->color0[0] );	// Doesn't matter when using previous face color
+                out[5] = float_bits( header->color0[1] );	// Doesn't matter when using previous face color
+                out[6] = float_bits( header->color0[2] );	// Doesn't matter when using previous face color
+                out[7] = float_bits( header->color0[3] );	// Doesn't matter when using previous face color
             }
             break;
 
         case 9:
         case 11:
         case 12:
-            ptr += 8;
-            *--ptr	= 0;
-            *--ptr	= 0;
-            *--ptr	= header->words[TCW1];
-            *--ptr	= header->words[TSP1];
-            size_in_words = 8;
+            out[4] = header->words[TSP1];
+            out[5] = header->words[TCW1];
+            out[6] = 0;
+            out[7] = 0;
             break;
 
         case 10:
         case 13:
         case 14:
+            out[4] = header->words[TSP1];
+            out[5] = header->words[TCW1];
+            out[6] = 0;
+            out[7] = 0;
+
             if ( ( header->words[PCW] & PCW_COLOR_TYPE_MASK ) == PCW_COLOR_TYPE_INTENSITY )
             {
-                ptr += 16;
-                *(float*)--ptr = header->color1[3];
-                *(float*)--ptr = header->color1[2];
-                *(float*)--ptr = header->color1[1];
-                *(float*)--ptr = header->color1[0];
-                *(float*)--ptr = header->color0[3];
-                *(float*)--ptr = header->color0[2];
-                *(float*)--ptr = header->color0[1];
-                *(float*)--ptr = header->color0[0];
-                PREFETCH( (void*)ptr );
-                *--ptr	= 0;
-                *--ptr	= 0;
-                *--ptr	= header->words[TCW1];
-                *--ptr	= header->words[TSP1];
+                out[8]  = float_bits( header->color0[0] );
+                out[9]  = float_bits( header->color0[1] );
+                out[10] = float_bits( header->color0[2] );
+                out[11] = float_bits( header->color0[3] );
+                out[12] = float_bits( header->color1[0] );
+                out[13] = float_bits( header->color1[1] );
+                out[14] = float_bits( header->color1[2] );
+                out[15] = float_bits( header->color1[3] );
                 size_in_words = 16;
             }
-            else
-            {
-                ptr += 8;
-                *--ptr	= 0;
-                *--ptr	= 0;
-                *--ptr	= header->words[TCW1];
-                *--ptr	= header->words[TSP1];
-                size_in_words = 8;
-            }
             break;
 
         case 15:
-            ptr += 8;
-            *--ptr	= 0;
-            *--ptr	= 0;
-            *--ptr	= 0;
-            //*--ptr	= PVR_PACK_COLOR( header->color0[0], header->color0[1], header->color0[2], header->color0[3] );
-            *--ptr =  (header->sprColor[0]<<24) | (header->sprColor[1]<<16) | (header->sprColor[2]<<8) | header->sprColor[3];   
-            size_in_words = 8;
+            //out[4] = PVR_PACK_COLOR( header->color0[0], header->color0[1], header->color0[2], header->color0[3] );
+            out[4] = ((uint32)header->sprColor[0]<<24) | (header->sprColor[1]<<16) | (header->sprColor[2]<<8) | header->sprColor[3];
+            out[5] = 0;
+            out[6] = 0;
+            out[7] = 0;
             break;
 
         case 16:
-            ptr += 8;
-            *--ptr	= 0;
-            *--ptr	= 0;
-            //*--ptr	= PVR_PACK_COLOR( header->color0[0], header->color0[1], header->color0[2], header->color0[3] );
-            //*--ptr	= PVR_PACK_COLOR( header->color0[0], header->color0[1], header->color0[2], header->color0[3] );
-            *--ptr =  (header->sprColor[0]<<24) | (header->sprColor[1]<<16) | (header->sprColor[2]<<8) | header->sprColor[3]; 
-            *--ptr =  (header->sprColor[0]<<24) | (header->sprColor[1]<<16) | (header->sprColor[2]<<8) | header->sprColor[3]; 
-            size_in_words = 8;
+            //out[4] = PVR_PACK_COLOR( header->color0[0], header->color0[1], header->color0[2], header->color0[3] );
+            //out[5] = PVR_PACK_COLOR( header->color0[0], header->color0[1], header->color0[2], header->color0[3] );
+            out[4] = ((uint32)header->sprColor[0]<<24) | (header->sprColor[1]<<16) | (header->sprColor[2]<<8) | header->sprColor[3];
+            out[5] = ((uint32)header->sprColor[0]<<24) | (header->sprColor[1]<<16) | (header->sprColor[2]<<8) | header->sprColor[3];
+            out[6] = 0;
+            out[7] = 0;
             break;
     }
 
-    // These last four words are the same for all headers
-    *--ptr	= header->words[TCW0];
-    *--ptr	= header->words[TSP0];
-    *--ptr	= header->words[ISPTSP];
-    *--ptr	= header->words[PCW];
+    block->size = size_in_words;
+    return size_in_words;
+}
+
+int shBake( const stripheader_t* header, shblock_t* block )
+{
+    // Quit now if the header is invalid
+    if ( !check_type( header->type ) )
+    {
+        report_error( SH_ERROR_INVALID_TYPE, __func__, header, header->type );
+        return 0;
+    }
+
+    return bake( header, block );
+}
+
+// Writes one 32-byte half of a block and flushes it
+static inline void commit_burst( uint32* ptr, const uint32* src )
+{
+    ptr[0] = src[0];
+    ptr[1] = src[1];
+    ptr[2] = src[2];
+    ptr[3] = src[3];
+    ptr[4] = src[4];
+    ptr[5] = src[5];
+    ptr[6] = src[6];
+    ptr[7] = src[7];
     PREFETCH( (void*)ptr );
+}
+
+// Sends a baked block
+static inline int commit_block( const shblock_t* block, uint32* ptr )
+{
+    // The halves are sent in order, so the pvr always sees the
+    // parameter control word first.
+    commit_burst( ptr, block->words );
+    if ( block->size == 16 )
+        commit_burst( ptr + 8, block->words + 8 );
+
+    STAT_ADD( list_words[( block->words[0] & PCW_LIST_MASK ) >> PCW_LIST_SHIFT], block->size );
+    STAT_ADD( headers_8, block->size == 8 );
+    STAT_ADD( headers_16, block->size == 16 );
+
+    return block->size;
+}
+
+int shCommit( stripheader_t* header, uint32* ptr )
+{
+    shblock_t block;
+    int size_in_words;
+#ifdef SH_STATS_TIMING
+    const uint64 start = SH_STATS_CYCLES();
+#endif
+
+    // Quit now if the header is invalid
+    if ( !check_type( header->type ) )
+    {
+        report_error( SH_ERROR_INVALID_TYPE, __func__, header, header->type );
+        return 0;
+    }
+
+    bake( header, &block );
+    size_in_words = commit_block( &block, ptr );
+
+    STAT_ADD( commits[header->type], 1 );
+#ifdef SH_STATS_TIMING
+    STAT_ADD( commit_cycles, SH_STATS_CYCLES() - start );
+#endif
+
+    return size_in_words;
+}
+
+int shCommitBlock( const shblock_t* block, uint32* ptr )
+{
+    int size_in_words;
+#ifdef SH_STATS_TIMING
+    const uint64 start = SH_STATS_CYCLES();
+#endif
+
+    size_in_words = commit_block( block, ptr );
+
+#ifdef SH_STATS_TIMING
+    STAT_ADD( commit_cycles, SH_STATS_CYCLES() - start );
+#endif
+
+    return size_in_words;
+}
+
+int shCommitCached( stripheader_t* header, shblock_t* block, uint32* ptr )
+{
+    int size_in_words;
+#ifdef SH_STATS_TIMING
+    const uint64 start = SH_STATS_CYCLES();
+#endif
+
+    // Quit now if the header is invalid
+    if ( !check_type( header->type ) )
+    {
+        report_error( SH_ERROR_INVALID_TYPE, __func__, header, header->type );
+        return 0;
+    }
+
+    // Only rebuild the block if something has changed since last time
+    if ( header->dirty || block->size == 0 )
+    {
+        bake( header, block );
+        header->dirty = 0;
+    }
+
+    size_in_words = commit_block( block, ptr );
+
+    STAT_ADD( commits[header->type], 1 );
+#ifdef SH_STATS_TIMING
+    STAT_ADD( commit_cycles, SH_STATS_CYCLES() - start );
+#endif
 
     return size_in_words;
 }
+
+
+/*
+===============================================================================
+
+COMPACT HEADERS
+
+===============================================================================
+*/
+
+// Returns 1 if <type> can be held by a compact header, otherwise reports why and returns 0.
+static inline int check_compact( const void* obj, uint32 type, const char* fnname )
+{
+    if ( !check_type( type ) )
+    {
+        report_error( SH_ERROR_INVALID_TYPE, fnname, obj, type );
+        return 0;
+    }
+
+    if ( !check_allowed( type, TYPES_COMPACT ) )
+    {
+        report_error( SH_ERROR_NOT_ALLOWED, fnname, obj, type );
+        return 0;
+    }
+
+    return 1;
+}
+
+int shCompactFromHeader( shcompact_t* c, const stripheader_t* hdr )
+{
+    int i;
+
+    if ( !check_compact( hdr, hdr->type, __func__ ) )
+        return 0;
+
+    c->type = hdr->type;
+    for ( i = 0; i < 6; i++ )
+        c->words[i] = hdr->words[i];
+    c->sprColor = ( (uint32)hdr->sprColor[0] << 24 ) | ( hdr->sprColor[1] << 16 ) | ( hdr->sprColor[2] << 8 ) | hdr->sprColor[3];
+
+    return 1;
+}
+
+int shCompactToHeader( stripheader_t* hdr, const shcompact_t* c )
+{
+    int i;
+
+    if ( !check_compact( c, c->type, __func__ ) )
+        return 0;
+
+    memset( hdr, 0, sizeof(stripheader_t) );
+
+    hdr->type = c->type;
+    for ( i = 0; i < 6; i++ )
+        hdr->words[i] = c->words[i];
+
+    hdr->sprColor[0] = c->sprColor >> 24;
+    hdr->sprColor[1] = c->sprColor >> 16;
+    hdr->sprColor[2] = c->sprColor >> 8;
+    hdr->sprColor[3] = c->sprColor;
+
+    hdr->color0[0] = hdr->color0[1] = hdr->color0[2] = hdr->color0[3] = 1.0f;
+    hdr->color1[0] = hdr->color1[1] = hdr->color1[2] = hdr->color1[3] = 1.0f;
+
+    hdr->dirty = 1;
+    return 1;
+}
+
+int shCompactSetState( shcompact_t* c, const SHSTATE* state )
+{
+    return check_compact( c, c->type, __func__ ) && apply_state( c, c->type, c->words, __func__, state );
+}
+
+int shCompactTextureFromDesc( shcompact_t* c, const shtexturedesc_t* desc )
+{
+    return check_compact( c, c->type, __func__ ) && set_texture_desc( c, c->type, c->words, __func__, TSP0, TCW0, TYPES_TEXTURED, desc );
+}
+
+int shCompactTextureFromDesc2( shcompact_t* c, const shtexturedesc_t* desc )
+{
+    return check_compact( c, c->type, __func__ ) && set_texture_desc( c, c->type, c->words, __func__, TSP1, TCW1, TYPES_TEXTURED_2, desc );
+}
+
+int shCompactSpriteColor( shcompact_t* c, uint32 argb )
+{
+    if ( !check_allowed( c->type, TYPES_SPRITE ) )
+    {
+        report_error( SH_ERROR_NOT_ALLOWED, __func__, c, c->type );
+        return 0;
+    }
+
+    c->sprColor = argb;
+    return 1;
+}
+
+int shCompactCommit( const shcompact_t* c, uint32* ptr )
+{
+    uint32 block[8];
+
+    if ( !check_compact( c, c->type, __func__ ) )
+        return 0;
+
+    // Same layout as bake() produces for these types
+    block[0] = c->words[PCW];
+    block[1] = c->words[ISPTSP];
+    block[2] = c->words[TSP0];
+    block[3] = c->words[TCW0];
+    block[4] = 0;
+    block[5] = 0;
+    block[6] = 0;
+    block[7] = 0;
+
+    switch ( c->type )
+    {
+        case 9:
+        case 11:
+        case 12:
+            block[4] = c->words[TSP1];
+            block[5] = c->words[TCW1];
+            break;
+
+        case 15:
+            block[4] = c->sprColor;
+            break;
+
+        case 16:
+            block[4] = c->sprColor;
+            block[5] = c->sprColor;
+            break;
+    }
+
+    commit_burst( ptr, block );
+
+    STAT_ADD( commits[c->type], 1 );
+    STAT_ADD( list_words[( c->words[PCW] & PCW_LIST_MASK ) >> PCW_LIST_SHIFT], 8 );
+    STAT_ADD( headers_8, 1 );
+    return 8;
+}
+
+
+/*
+===============================================================================
+
+CONTROL PARAMETERS
+
+===============================================================================
+*/
+
+int shTileClip( uint32* ptr, uint32 x_min, uint32 y_min, uint32 x_max, uint32 y_max )
+{
+    uint32 block[8];
+
+    if ( x_min > x_max || y_min > y_max || x_max > TILE_CLIP_X_MAX || y_max > TILE_CLIP_Y_MAX )
+    {
+        report_error( SH_ERROR_OUT_OF_RANGE, __func__, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    block[0] = PCW_TYPE_USER_TILE_CLIP;
+    block[1] = 0;
+    block[2] = 0;
+    block[3] = 0;
+    block[4] = x_min;
+    block[5] = y_min;
+    block[6] = x_max;
+    block[7] = y_max;
+
+    commit_burst( ptr, block );
+    return 8;
+}
+
+int shTileClipRect( uint32* ptr, uint32 x, uint32 y, uint32 width, uint32 height )
+{
+    uint32 x_last, y_last;
+
+    // An empty rectangle still covers the tile it starts in
+    if ( width == 0 )
+        width = 1;
+    if ( height == 0 )
+        height = 1;
+
+    // The last pixel, without wrapping around
+    x_last = ( width - 1 > 0xFFFFFFFF - x ? 0xFFFFFFFF : x + width - 1 );
+    y_last = ( height - 1 > 0xFFFFFFFF - y ? 0xFFFFFFFF : y + height - 1 );
+
+    // Rectangles running past the last tile are cut off there, one that
+    // starts past it is left to shTileClip to report
+    x_last = ( x_last / 32 > TILE_CLIP_X_MAX ? TILE_CLIP_X_MAX : x_last / 32 );
+    y_last = ( y_last / 32 > TILE_CLIP_Y_MAX ? TILE_CLIP_Y_MAX : y_last / 32 );
+
+    return shTileClip( ptr, x / 32, y / 32, x_last, y_last );
+}
+
+int shTileBounds( shtilebounds_t* bounds, const float* xy, uint32 stride, uint32 count, uint32 tiles_x, uint32 tiles_y )
+{
+    const uint8* v = (const uint8*)xy;
+    float x_min, y_min, x_max, y_max;
+    const float* p = xy;
+    uint32 i;
+
+    if ( count == 0 || tiles_x == 0 || tiles_y == 0 )
+        return 0;
+
+    // Vertices with a NaN coordinate are skipped, they'd compare false
+    // against everything and can't be converted to tiles
+    for ( i = 0; i < count; i++ )
+    {
+        p = (const float*)( v + i * stride );
+        if ( p[0] == p[0] && p[1] == p[1] )
+            break;
+    }
+
+    if ( i == count )
+        return 0;
+
+    x_min = x_max = p[0];
+    y_min = y_max = p[1];
+
+    for ( i++; i < count; i++ )
+    {
+        p = (const float*)( v + i * stride );
+        if ( !( p[0] == p[0] && p[1] == p[1] ) )
+            continue;
+
+        x_min = ( p[0] < x_min ? p[0] : x_min );
+        x_max = ( p[0] > x_max ? p[0] : x_max );
+        y_min = ( p[1] < y_min ? p[1] : y_min );
+        y_max = ( p[1] > y_max ? p[1] : y_max );
+    }
+
+    if ( x_max < 0.0f || y_max < 0.0f || x_min >= tiles_x * 32.0f || y_min >= tiles_y * 32.0f )
+        return 0;
+
+    bounds->x_min = ( x_min <= 0.0f ? 0 : (uint32)x_min / 32 );
+    bounds->y_min = ( y_min <= 0.0f ? 0 : (uint32)y_min / 32 );
+    bounds->x_max = ( x_max >= tiles_x * 32.0f ? tiles_x - 1 : (uint32)x_max / 32 );
+    bounds->y_max = ( y_max >= tiles_y * 32.0f ? tiles_y - 1 : (uint32)y_max / 32 );
+    return 1;
+}
+
+int shObjectListSet( uint32* ptr, pvr_list_t list, uint32 object_pointer, const shtilebounds_t* bounds )
+{
+    uint32 block[8];
+
+    if ( (uint32)list > PVR_LIST_PT_POLY )
+    {
+        report_error( SH_ERROR_INVALID_LIST, __func__, NULL, SH_ERROR_NO_TYPE );
+        return 0;
+    }
+
+    block[0] = PCW_TYPE_OBJECT_LIST_SET | ( (uint32)list << PCW_LIST_SHIFT );
+    block[1] = object_pointer;
+    block[2] = 0;
+    block[3] = 0;
+    block[4] = bounds->x_min;
+    block[5] = bounds->y_min;
+    block[6] = bounds->x_max;
+    block[7] = bounds->y_max;
+
+    commit_burst( ptr, block );
+    return 8;
+}
@@ -54,6 +54,9 @@
 #include <kos.h>
 #include "shtexture.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /***** Error handling *****/
 
@@ -66,16 +69,102 @@ typedef enum
     SH_ERROR_NOT_PALETTED,          // Trying to perform a palette operation when the current texture is not paletted
     SH_ERROR_PALETTE_OUT_OF_BOUNDS, // Palette index is out of bounds
     SH_ERROR_TEXTURE_SIZE,          // Invalid texture size
-    SH_ERROR_NOT_ALLOWED            // Operation is not allowed for this type
+    SH_ERROR_NOT_ALLOWED,           // Operation is not allowed for this type
+    SH_ERROR_INVALID_SIZE,          // Size isn't a whole number of 32-byte blocks
+    SH_ERROR_OUT_OF_RANGE,          // Index, range or count outside what's allowed
+    SH_ERROR_OVERFLOW,              // Output doesn't fit in the space given
+    SH_ERROR_INVALID_PARAMETER      // Parameter value isn't allowed here
 } SHERROR;
 
+#define SH_ERROR_COUNT	( SH_ERROR_INVALID_PARAMETER + 1 )
+
 // I came up with this since checking return values for every function sucks.
 // Use this to register an error handler function. This is called whenever
 // an error occurs, and one of the error codes above are passed. 
 // To remove the error handler, simply set this to NULL.
 // fname is the name of the function which the error occured in.
+// NOTE: If the library is built with SH_NO_VALIDATION defined, no checks are
+//       made and the handler is never called. Only use that for shipping
+//       builds where the code is known to be correct.
 void shErrorHandler( void (*hnd)(SHERROR, const char* fname) );
 
+// Deferred errors.
+// Instead of calling a handler from inside the failing function, errors can
+// be appended to a ring and looked at later, e.g. once per frame. Nothing
+// is ever waited for: when the ring is full, the error is dropped and
+// counted. A ring may be filled by one thread and drained by another, but
+// only one thread may fill it, so give each thread its own context and ring.
+typedef struct sherrorentry
+{
+    SHERROR		code;
+    const char*		fname;	// Function the error occured in
+    const void*		hdr;	// Header (or compact header) involved, NULL if none
+    uint32		type;	// Its type, or SH_ERROR_NO_TYPE
+} sherrorentry_t;
+
+#define SH_ERROR_NO_TYPE	0xffffffff
+
+typedef struct sherrorring
+{
+    sherrorentry_t*	entries;
+    uint32		capacity;	// A power of two
+    uint32		head;		// Only written by the thread reporting errors
+    uint32		tail;		// Only written by the thread draining them
+    uint32		overflow;	// Errors dropped because the ring was full
+} sherrorring_t;
+
+// Initializes an empty ring. entries must have room for capacity entries,
+// which must be a power of two. Any other capacity fails with
+// SH_ERROR_OUT_OF_RANGE and leaves a ring with no room, which counts every
+// error it's sent as an overflow.
+int shErrorRingInit( sherrorring_t* ring, sherrorentry_t* entries, uint32 capacity );
+
+// Sends errors to a ring instead of the handler. NULL goes back to the handler.
+void shErrorRing( sherrorring_t* ring );
+
+// Takes the oldest error from a ring. Returns 0 if it's empty.
+int shErrorRingPop( sherrorring_t* ring, sherrorentry_t* entry );
+
+// Contexts.
+// The handler above is shared by the whole program. Threads that build
+// headers independently of each other can each use their own context
+// instead. A context is made current for the calling thread only, and
+// while it is, errors on that thread go to the context's handler and are
+// recorded in the context. Every other function uses the current context,
+// so there's no need for context-taking variants of them.
+//
+// The current context is kept in thread local storage. Toolchains without
+// it can build the library with SH_NO_TLS, which leaves one current context
+// for the whole program. Only one context can then be current at a time,
+// so set the current one back to NULL before making another one current.
+typedef struct sh_context
+{
+    void	(*error_handler)(SHERROR, const char* fname);
+    SHERROR	last_error;	// Last error reported, SH_ERROR_OK if none
+    uint32	error_count;	// Number of errors reported
+    sherrorring_t*	error_ring;	// Deferred errors, used instead of the handler if set
+} sh_context_t;
+
+// Initializes a context with no handler and no errors.
+void shContextInit( sh_context_t* ctx );
+
+// Sets the error handler of a context. NULL removes it.
+void shContextErrorHandler( sh_context_t* ctx, void (*hnd)(SHERROR, const char* fname) );
+
+// Sends the errors of a context to a ring instead of its handler. NULL removes it.
+void shContextErrorRing( sh_context_t* ctx, sherrorring_t* ring );
+
+// Makes a context current for the calling thread.
+// Passing NULL goes back to the handler set with shErrorHandler.
+// Returns 0 with SH_NO_TLS if another context is current already.
+int shMakeCurrent( sh_context_t* ctx );
+
+// Returns the context current for the calling thread, or NULL if none.
+sh_context_t* shGetCurrentContext( void );
+
+// Returns the last error of a context and clears it.
+SHERROR shContextError( sh_context_t* ctx );
+
 
 /***** Capabilities for shEnable/shDisable *****/
 
@@ -130,7 +219,13 @@ typedef enum
     // Controls whether or not perform super-sampling of textures.
     // Valid for textured types.
     SH_TEX_SUPER_SAMPLING,
-    SH_TEX_SUPER_SAMPLING_2
+    SH_TEX_SUPER_SAMPLING_2,
+
+    // Controls whether or not the depth buffer is written.
+    // Turn it off for decals and overlays that shouldn't hide anything.
+    // Enabled by default.
+    // Valid for types 0-16.
+    SH_DEPTH_WRITE
 
 } SHCAPABILITY;
 
@@ -154,6 +249,39 @@ typedef enum
     SH_CULL_CCW			= 2
 } SHCULLMODE;
 
+// Depth compare
+// NOTE: Depth is 1/w, so GREATER means closer to the camera.
+typedef enum
+{
+    SH_DEPTH_NEVER		= 0,
+    SH_DEPTH_LESS		= 1,
+    SH_DEPTH_EQUAL		= 2,
+    SH_DEPTH_LESS_OR_EQUAL	= 3,
+    SH_DEPTH_GREATER		= 4,
+    SH_DEPTH_NOT_EQUAL		= 5,
+    SH_DEPTH_GREATER_OR_EQUAL	= 6,	// Default
+    SH_DEPTH_ALWAYS		= 7
+} SHDEPTHFUNC;
+
+// User tile clipping
+typedef enum
+{
+    SH_CLIP_DISABLE		= 0,
+    SH_CLIP_INSIDE		= 2,	// Only draw inside the clip area
+    SH_CLIP_OUTSIDE		= 3	// Only draw outside the clip area
+} SHUSERCLIP;
+
+// Strip length
+// Strips are split into groups of this many triangles by the TA, and each
+// group takes one entry in the object pointer blocks of every tile it touches.
+typedef enum
+{
+    SH_STRIP_LENGTH_1		= 0,
+    SH_STRIP_LENGTH_2		= 1,	// Default
+    SH_STRIP_LENGTH_4		= 2,
+    SH_STRIP_LENGTH_6		= 3
+} SHSTRIPLENGTH;
+
 // Mipmap adjustment
 typedef enum
 {
@@ -211,12 +339,22 @@ typedef struct stripheader
 {
     uint32	type;
     uint32	words[6];
-    uint32	unused;
+    uint32	dirty;		// Changed since it was last baked, see shCommitCached
     float	color0[4];
-    float	color1[4];
+    float	color1[4];
     uint8	sprColor[4];
 } stripheader_t;
 
+// Baked header block
+// The exact 8 or 16 words shCommit sends for a header. Materials that rarely
+// change can keep one of these next to their header, so the header only has
+// to be rebuilt after it has changed (see shCommitCached).
+typedef struct shblock
+{
+    uint32	size;		// Size in 32-bit words, 8 or 16. 0 if nothing has been baked.
+    uint32	words[16];
+} shblock_t;
+
 
 // Initializes a strip header of the given type.
 // See the table at the top of this file for an explanation of types.
@@ -233,6 +371,22 @@ int shDisable( stripheader_t* hdr, SHCAPABILITY cap );
 // Valid for all types.
 int shCullMode( stripheader_t* hdr, SHCULLMODE mode );
 
+// Set depth compare function.
+// Two-parameter types only have one depth test, shared by both volumes.
+// Valid for types 0-16.
+int shDepthFunc( stripheader_t* hdr, SHDEPTHFUNC func );
+
+// Set how this strip is clipped against the user clip area (see shTileClip).
+// Tiles on the wrong side of the area are skipped entirely by the hardware.
+// Valid for all types.
+int shUserClip( stripheader_t* hdr, SHUSERCLIP mode );
+
+// Set strip length.
+// Longer lengths take fewer object pointers for long strips, shorter
+// lengths give tighter bounds (and so fewer tiles) for each group.
+// Valid for types 0-16.
+int shStripLength( stripheader_t* hdr, SHSTRIPLENGTH length );
+
 // Set fog mode for this strip.
 // Use SH_FOG_* values.
 // Valid for types 0-16.
@@ -270,6 +424,69 @@ int shPalette2( stripheader_t* hdr, uint32 index );
 int shTexture( stripheader_t* hdr, const texture_t* tex );
 int shTexture2( stripheader_t* hdr, const texture_t* tex );
 
+// Precomputed texture state.
+// shTexture has to check the size and format of a texture every time it's
+// set. For textures that are swapped often, build a descriptor once using
+// shTextureDesc and set it with shTextureFromDesc instead.
+typedef struct shtexturedesc
+{
+    uint32	tsp;	// Texture size bits of the tsp word
+    uint32	tcw;	// Texture control word
+} shtexturedesc_t;
+
+// Builds a texture descriptor.
+// Fails with SH_ERROR_TEXTURE_SIZE if the texture size isn't a power of two in 8..1024.
+int shTextureDesc( shtexturedesc_t* desc, const texture_t* tex );
+
+// Set texture from a descriptor. Passing NULL clears the texture.
+// Valid for textured types.
+int shTextureFromDesc( stripheader_t* hdr, const shtexturedesc_t* desc );
+int shTextureFromDesc2( stripheader_t* hdr, const shtexturedesc_t* desc );
+
+// Bulk state.
+// Describes the state of a material so it can be set with a single call to
+// shSetState instead of one call per setting. Only the fields named in
+// "flags" are set. Capabilities are given as bitmasks of ( 1 << SH_* ) and
+// are left untouched unless they're in either mask.
+#define SH_STATE_BLEND			(1<<0)	// src, dst
+#define SH_STATE_BLEND_2		(1<<1)	// src2, dst2
+#define SH_STATE_FOG			(1<<2)	// fog
+#define SH_STATE_FOG_2			(1<<3)	// fog2
+#define SH_STATE_CULL			(1<<4)	// cull
+#define SH_STATE_FILTER			(1<<5)	// filter
+#define SH_STATE_FILTER_2		(1<<6)	// filter2
+#define SH_STATE_MIPMAP_ADJUST		(1<<7)	// mipmap
+#define SH_STATE_MIPMAP_ADJUST_2	(1<<8)	// mipmap2
+#define SH_STATE_DEPTH_FUNC		(1<<9)	// depth
+#define SH_STATE_USER_CLIP		(1<<10)	// clip
+#define SH_STATE_STRIP_LENGTH		(1<<11)	// strip
+
+typedef struct
+{
+    uint32		flags;
+    SHBLENDFUNC		src, dst;
+    SHBLENDFUNC		src2, dst2;
+    SHFOGMODE		fog, fog2;
+    SHCULLMODE		cull;
+    SHDEPTHFUNC		depth;
+    SHUSERCLIP		clip;
+    SHSTRIPLENGTH	strip;
+    SHTEXTUREFILTER	filter, filter2;
+    SHMIPMAPADJUST	mipmap, mipmap2;
+    uint32		enable;		// Capabilities to enable
+    uint32		disable;	// Capabilities to disable
+} SHSTATE;
+
+// Applies a bulk state to a header.
+// Everything is validated against the header type up front. If any part of
+// the state isn't valid for it, the header is left unchanged.
+int shSetState( stripheader_t* hdr, const SHSTATE* state );
+
+// Builds the masks shSetState would use for a header of the given type.
+// Each word i becomes ( words[i] & ~clear[i] ) | set[i]. Useful for
+// applying the same state to many headers.
+int shStateMasks( uint32 type, const SHSTATE* state, uint32 clear[6], uint32 set[6] );
+
 // Set modifier instruction.
 // ONLY valid for type 17.
 int shModifierInstruction( stripheader_t* hdr, SHMODIFIERINSTRUCTION instr );
@@ -280,19 +497,130 @@ int shBaseColor( stripheader_t* hdr, float a, float r, float g, float b );
 int shBaseColor2( stripheader_t* hdr, float a, float r, float g, float b );
 int shSpriteColor( stripheader_t* hdr, uint8 *const color);
 
+// Set sprite color from floats (0..1), packed with shPackColor.
+// Valid for sprites.
+int shSpriteColorf( stripheader_t* hdr, float a, float r, float g, float b );
+
 // Set offset color.
 // Valid for textured intensity color polygons and textured sprites.
 // NOTE: NOT valid for two-parameter polygons.
 int shOffsetColor( stripheader_t* hdr, float a, float r, float g, float b );
 
+// Builds the block of words shCommit would send for a header.
+// Returns its size in 32-bit words (8 or 16).
+int shBake( const stripheader_t* hdr, shblock_t* block );
+
 // Copies the finished structure of a strip header to the given pointer
 // using store queues and returns number of copied 32-bit words.
 int shCommit( stripheader_t* hdr, uint32* ptr );
 
+// Copies a baked block to the given pointer using store queues and
+// returns number of copied 32-bit words.
+int shCommitBlock( const shblock_t* block, uint32* ptr );
+
+// Same as shCommit, but keeps the baked header in block and only rebakes it
+// if the header has changed since the last call, or if block is empty.
+// Start with a zeroed block. A header only remembers whether it has changed,
+// not which block it was baked into, so use one block per header.
+int shCommitCached( stripheader_t* hdr, shblock_t* block, uint32* ptr );
+
+/***** Control parameters *****/
+
+// Sets the user clip area for the following strips in the current list,
+// in 32x32 pixel tiles. The max coordinates are inclusive.
+// Writes 8 words to ptr using store queues and returns 8.
+// X tiles go up to 63 and Y tiles up to 15. Coordinates past that, or a
+// min past its max, fail with SH_ERROR_OUT_OF_RANGE and nothing is written.
+int shTileClip( uint32* ptr, uint32 x_min, uint32 y_min, uint32 x_max, uint32 y_max );
+
+// Same as shTileClip, but takes a rectangle in pixels. The area is grown
+// to cover every tile the rectangle touches, and cut off at the last tile.
+int shTileClipRect( uint32* ptr, uint32 x, uint32 y, uint32 width, uint32 height );
+
+// Rectangle of 32x32 pixel tiles, max coordinates inclusive
+typedef struct shtilebounds
+{
+    uint32	x_min, y_min;
+    uint32	x_max, y_max;
+} shtilebounds_t;
+
+// Computes the tiles covered by count screen space vertices.
+// xy points to the x coordinate of the first vertex, y must follow it,
+// and stride is the size of a vertex in bytes (e.g. sizeof(shvertexpacked_t)).
+// The bounds are clamped to tiles_x by tiles_y tiles (20x15 for 640x480).
+// This doesn't depend on the hardware, so it can be used by tools to
+// precompute bounds for static geometry.
+// Vertices with a NaN coordinate are skipped.
+// Returns 0 if count is 0 or everything is off screen.
+int shTileBounds( shtilebounds_t* bounds, const float* xy, uint32 stride, uint32 count, uint32 tiles_x, uint32 tiles_y );
+
+// Sends an object list set, which adds an object that has already been
+// stored by the TA to the object lists of the given tiles without binning
+// it again. object_pointer is the object's address in the parameter buffer.
+// Writes 8 words to ptr using store queues and returns 8.
+// A list past PVR_LIST_PT_POLY fails with SH_ERROR_INVALID_LIST and nothing is written.
+int shObjectListSet( uint32* ptr, pvr_list_t list, uint32 object_pointer, const shtilebounds_t* bounds );
+
+/***** Compact headers *****/
+
+// Compact strip header
+// Half the size of stripheader_t, for types that never keep colors in the
+// header: everything except 2, 7, 8, 10, 13 and 14. Compact headers are
+// always sent as 8 words and have no baked block, the words are copied
+// as they are. Use these for large arrays of materials.
+typedef struct shcompact
+{
+    uint32	type;
+    uint32	words[6];
+    uint32	sprColor;	// Packed ARGB, only used by sprites
+} shcompact_t;
+
+// Converts a header to a compact header and back.
+// All compact header functions fail with SH_ERROR_NOT_ALLOWED for intensity types.
+int shCompactFromHeader( shcompact_t* c, const stripheader_t* hdr );
+int shCompactToHeader( stripheader_t* hdr, const shcompact_t* c );
+
+// Same as shSetState, shTextureFromDesc and shSpriteColor for compact headers.
+int shCompactSetState( shcompact_t* c, const SHSTATE* state );
+int shCompactTextureFromDesc( shcompact_t* c, const shtexturedesc_t* desc );
+int shCompactTextureFromDesc2( shcompact_t* c, const shtexturedesc_t* desc );
+int shCompactSpriteColor( shcompact_t* c, uint32 argb );
+
+// Same as shCommit for compact headers. Always copies 8 words.
+int shCompactCommit( const shcompact_t* c, uint32* ptr );
+
+/***** Statistics *****/
+
+// Counters for what the library has done since the last shResetStats.
+// These are only updated when the library is built with SH_STATS defined,
+// otherwise they stay at 0 and cost nothing. SH_STATS_TIMING also counts
+// the cycles spent in shCommit (rdtsc on x86 hosts, performance counter 0
+// on the Dreamcast, which the program has to start).
+// NOTE: The counters are shared by all threads. Each one is updated
+// atomically, but shGetStats and shResetStats don't stop other threads,
+// so a snapshot taken while they're committing isn't consistent.
+typedef struct shstats
+{
+    uint32	commits[18];		// Headers committed, per type (not counting shCommitBlock)
+    uint32	list_words[8];		// Header words committed, per list (indexed by the PCW list field)
+    uint32	headers_8;		// 8-word headers committed
+    uint32	headers_16;		// 16-word headers committed
+    uint32	texture_binds;		// Textures set through shTexture*/shTextureFromDesc*/shMatPoolTexture*
+    uint32	setter_calls;		// Calls to functions that change a header
+    uint32	errors[SH_ERROR_COUNT];	// Errors reported, per code
+    uint64	commit_cycles;		// Cycles spent in shCommit
+} shstats_t;
+
+void shGetStats( shstats_t* stats );
+void shResetStats( void );
+
 // TODO: Missing functionality
-//int shDepthFunc();
 //int shTexEnv();
 //int shFlipUV();
 //int shClampUV();
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // __STRIPHEADER_H__
@@ -0,0 +1,337 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Compile-time specialized strip headers for C++.
+
+ sh::StripHeader<Type, List> holds the same words as stripheader_t, but the
+ header type and list are template parameters. Everything the C functions
+ check at runtime is checked by the compiler instead: calling a setter that
+ isn't valid for the header type doesn't compile, and valid ones inline to a
+ mask and an or. Error handlers are never called.
+
+ Only the texture and palette setters can still fail, as they depend on the
+ texture given. They return false in that case, and like shTexture, a
+ texture that fails to set leaves the header without a texture.
+
+ The capability table and the texture encoding are the same ones the C
+ functions use (see shdefs.h). None of the register macros from shdefs.h
+ are left defined after including this file.
+
+ Requires C++17.
+*/
+
+#ifndef __STRIPHEADER_HPP__
+#define __STRIPHEADER_HPP__
+
+#include "stripheader.h"
+#include "shdefs.h"
+#include "shcolor.h"
+
+namespace sh
+{
+
+// Compile-time properties of a header type
+template<uint32 Type>
+struct TypeInfo
+{
+    static_assert( Type <= 17, "The strip header type must be 0..17" );
+
+    static constexpr uint32	bit		= BIT(Type);
+    static constexpr bool	polygon		= ( TYPES_POLYGON & bit ) != 0;
+    static constexpr bool	sprite		= ( TYPES_SPRITE & bit ) != 0;
+    static constexpr bool	modifier	= ( TYPES_MODIFIER & bit ) != 0;
+    static constexpr bool	textured	= ( TYPES_TEXTURED & bit ) != 0;
+    static constexpr bool	twoParam	= ( TYPES_POLYGON_2 & bit ) != 0;
+    static constexpr bool	intensity	= ( TYPES_INTENSITY & bit ) != 0;
+    static constexpr uint32	pcw		= detail::default_pcw[Type];
+};
+
+// Float to raw bits, for writing colors into the word stream
+static inline uint32 floatBits( float f )
+{
+    uint32 u;
+    __builtin_memcpy( &u, &f, sizeof(u) );
+    return u;
+}
+
+template<uint32 Type, pvr_list_t List>
+class StripHeader
+{
+    using Info = TypeInfo<Type>;
+
+    static_assert( List <= PVR_LIST_PT_POLY, "Invalid list" );
+    static_assert( Info::modifier == ( List == PVR_LIST_OP_MOD || List == PVR_LIST_TR_MOD ),
+                   "Modifiers need a modifier list and every other type a polygon list" );
+
+    static constexpr uint32 default_tsp = Info::modifier ? 0 : ( ( List > PVR_LIST_OP_MOD ) ? detail::default_tsp_alpha : detail::default_tsp_noalpha );
+
+    // Sets a field in one of the words, if the header type allows it
+    template<uint32 Allowed, int Word, uint32 Mask, uint32 Shift>
+    void set( uint32 value )
+    {
+        static_assert( ( Allowed & Info::bit ) != 0, "Operation is not allowed for this header type" );
+        words[Word] = ( words[Word] & ~Mask ) | ( ( value << Shift ) & Mask );
+    }
+
+    template<uint32 Allowed, int Tsp, int Tcw>
+    bool setTexture( const texture_t* tex )
+    {
+        static_assert( ( Allowed & Info::bit ) != 0, "Operation is not allowed for this header type" );
+
+        uint32 tsp = 0, tcw = 0;
+
+        // The texture is cleared even if the new one turns out to be invalid
+        const bool ok = ( tex == nullptr || detail::texture_words( tex, &tsp, &tcw ) );
+        if ( !ok )
+            tsp = tcw = 0;
+
+        words[Tsp] = ( words[Tsp] & ~( TSP_TEXTURE_U_SIZE_MASK | TSP_TEXTURE_V_SIZE_MASK ) ) | tsp;
+        words[Tcw] = tcw;
+        return ok;
+    }
+
+    template<uint32 Allowed, int Tcw>
+    bool setPalette( uint32 index )
+    {
+        static_assert( ( Allowed & Info::bit ) != 0, "Operation is not allowed for this header type" );
+
+        switch ( words[Tcw] & TCW_PIXEL_FORMAT_MASK )
+        {
+            case TCW_PIXEL_FORMAT_PAL_4BPP:
+                if ( index >= 64 )
+                    return false;
+                set<Allowed, Tcw, TCW_PALETTE_INDEX_4BPP_MASK, TCW_PALETTE_INDEX_4BPP_SHIFT>( index );
+                return true;
+
+            case TCW_PIXEL_FORMAT_PAL_8BPP:
+                if ( index >= 4 )
+                    return false;
+                set<Allowed, Tcw, TCW_PALETTE_INDEX_8BPP_MASK, TCW_PALETTE_INDEX_8BPP_SHIFT>( index );
+                return true;
+        }
+
+        return false;
+    }
+
+    // Writes one 32-byte half of the header and flushes it
+    static inline void burst( uint32* ptr, uint32 w0, uint32 w1, uint32 w2, uint32 w3,
+                              uint32 w4, uint32 w5, uint32 w6, uint32 w7 )
+    {
+        ptr[0] = w0; ptr[1] = w1; ptr[2] = w2; ptr[3] = w3;
+        ptr[4] = w4; ptr[5] = w5; ptr[6] = w6; ptr[7] = w7;
+        PREFETCH( (void*)ptr );
+    }
+
+public:
+    static constexpr uint32	type = Type;
+    static constexpr pvr_list_t	list = List;
+
+    uint32	words[6];
+    float	color0[4];
+    float	color1[4];
+    uint32	sprColor;	// Packed ARGB
+
+    // Same as shInit. Textures that fail to set are left cleared.
+    explicit StripHeader( const texture_t* tex0 = nullptr, const texture_t* tex1 = nullptr )
+        : words{ Info::pcw | ( List << PCW_LIST_SHIFT ),
+                 Info::modifier ? detail::default_isptsp_mod : detail::default_isptsp,
+                 default_tsp, 0,
+                 Info::twoParam ? default_tsp : 0, 0 },
+          color0{ 1.0f, 1.0f, 1.0f, 1.0f },
+          color1{ 1.0f, 1.0f, 1.0f, 1.0f },
+          sprColor( 0xFFFFFFFF )
+    {
+        if constexpr ( Info::textured )
+        {
+            texture( tex0 );
+            if constexpr ( Info::twoParam )
+                texture2( tex1 );
+        }
+    }
+
+    template<SHCAPABILITY Cap>
+    void enable( bool on = true )
+    {
+        constexpr detail::capability_t ci = detail::capabilities[Cap];
+        static_assert( ( ci.allowed_types & Info::bit ) != 0, "Capability is not valid for this header type" );
+        words[ci.word] = ( words[ci.word] & ~ci.bitmask ) | ( on ? ci.tval : ci.fval );
+    }
+
+    template<SHCAPABILITY Cap>
+    void disable() { enable<Cap>( false ); }
+
+    void cullMode( SHCULLMODE mode )		{ set<TYPES_ALL,        ISPTSP, ISP_TSP_CULL_MODE_MASK,  ISP_TSP_CULL_MODE_SHIFT>( mode ); }
+    void depthFunc( SHDEPTHFUNC func )		{ set<TYPES_POLYSPRITE, ISPTSP, ISP_TSP_DEPTH_COMPARE_MASK, ISP_TSP_DEPTH_COMPARE_SHIFT>( func ); }
+    void userClip( SHUSERCLIP mode )		{ set<TYPES_ALL,        PCW,    PCW_USER_CLIP_MASK,      PCW_USER_CLIP_SHIFT>( mode ); }
+    void stripLength( SHSTRIPLENGTH length )	{ set<TYPES_POLYSPRITE, PCW,    PCW_STRIP_LENGTH_MASK,   PCW_STRIP_LENGTH_SHIFT>( length ); }
+    void fogMode( SHFOGMODE mode )		{ set<TYPES_POLYSPRITE, TSP0,   TSP_FOG_MODE_MASK,       TSP_FOG_MODE_SHIFT>( mode ); }
+    void fogMode2( SHFOGMODE mode )		{ set<TYPES_POLYGON_2,  TSP1,   TSP_FOG_MODE_MASK,       TSP_FOG_MODE_SHIFT>( mode ); }
+    void mipmapAdjust( SHMIPMAPADJUST adj )	{ set<TYPES_TEXTURED,   TSP0,   TSP_MIPMAP_ADJUST_MASK,  TSP_MIPMAP_ADJUST_SHIFT>( adj ); }
+    void mipmapAdjust2( SHMIPMAPADJUST adj )	{ set<TYPES_TEXTURED_2, TSP1,   TSP_MIPMAP_ADJUST_MASK,  TSP_MIPMAP_ADJUST_SHIFT>( adj ); }
+    void textureFilter( SHTEXTUREFILTER f )	{ set<TYPES_TEXTURED,   TSP0,   TSP_TEXTURE_FILTER_MASK, TSP_TEXTURE_FILTER_SHIFT>( f ); }
+    void textureFilter2( SHTEXTUREFILTER f )	{ set<TYPES_TEXTURED_2, TSP1,   TSP_TEXTURE_FILTER_MASK, TSP_TEXTURE_FILTER_SHIFT>( f ); }
+
+    void blendFunc( SHBLENDFUNC src, SHBLENDFUNC dst )
+    {
+        set<TYPES_POLYSPRITE, TSP0, TSP_SRC_ALPHA_INSTR_MASK | TSP_DST_ALPHA_INSTR_MASK, TSP_DST_ALPHA_INSTR_SHIFT>( ( src << 3 ) | dst );
+    }
+
+    void blendFunc2( SHBLENDFUNC src, SHBLENDFUNC dst )
+    {
+        set<TYPES_POLYGON_2, TSP1, TSP_SRC_ALPHA_INSTR_MASK | TSP_DST_ALPHA_INSTR_MASK, TSP_DST_ALPHA_INSTR_SHIFT>( ( src << 3 ) | dst );
+    }
+
+    void modifierInstruction( SHMODIFIERINSTRUCTION instr )
+    {
+        set<TYPES_MODIFIER, PCW, PCW_MODIFIER_TRIANGLE_MASK, PCW_MODIFIER_TRIANGLE_SHIFT>( instr != SH_MODIFIER_NORMAL );
+        set<TYPES_MODIFIER, ISPTSP, ISP_TSP_VOLUME_INSTRUCTION_MASK, ISP_TSP_VOLUME_INSTRUCTION_SHIFT>( instr );
+    }
+
+    bool texture( const texture_t* tex )	{ return setTexture<TYPES_TEXTURED,   TSP0, TCW0>( tex ); }
+    bool texture2( const texture_t* tex )	{ return setTexture<TYPES_TEXTURED_2, TSP1, TCW1>( tex ); }
+    bool palette( uint32 index )		{ return setPalette<TYPES_TEXTURED,   TCW0>( index ); }
+    bool palette2( uint32 index )		{ return setPalette<TYPES_TEXTURED_2, TCW1>( index ); }
+
+    void baseColor( float a, float r, float g, float b )
+    {
+        static_assert( ( ( TYPES_INTENSITY | TYPES_SPRITE ) & Info::bit ) != 0, "Operation is not allowed for this header type" );
+        color0[0] = a; color0[1] = r; color0[2] = g; color0[3] = b;
+    }
+
+    void baseColor2( float a, float r, float g, float b )
+    {
+        static_assert( ( ( TYPES_INTENSITY & TYPES_POLYGON_2 ) & Info::bit ) != 0, "Operation is not allowed for this header type" );
+        color1[0] = a; color1[1] = r; color1[2] = g; color1[3] = b;
+    }
+
+    void offsetColor( float a, float r, float g, float b )
+    {
+        static_assert( ( ( ( TYPES_INTENSITY | TYPES_SPRITE ) & TYPES_TEXTURED & ~TYPES_POLYGON_2 ) & Info::bit ) != 0,
+                       "Operation is not allowed for this header type" );
+        color1[0] = a; color1[1] = r; color1[2] = g; color1[3] = b;
+    }
+
+    // Packed ARGB color for sprites
+    void spriteColor( uint32 argb )
+    {
+        static_assert( Info::sprite, "Operation is only allowed for sprites" );
+        sprColor = argb;
+    }
+
+    void spriteColor( float a, float r, float g, float b )
+    {
+        static_assert( Info::sprite, "Operation is only allowed for sprites" );
+        sprColor = shPackColor( a, r, g, b );
+    }
+
+    // Writes the header to ptr using store queues, in the same format as
+    // shCommit, and returns the number of 32-bit words written.
+    int commit( uint32* ptr ) const
+    {
+        if constexpr ( Type == 2 )
+        {
+            burst( ptr, words[PCW], words[ISPTSP], words[TSP0], words[TCW0],
+                   floatBits( color0[0] ), floatBits( color0[1] ), floatBits( color0[2] ), floatBits( color0[3] ) );
+            return 8;
+        }
+        else if constexpr ( Type == 7 || Type == 8 )
+        {
+            if ( ( words[PCW] & ( PCW_COLOR_TYPE_MASK | PCW_OFFSET_COLOR_MASK ) ) == ( PCW_COLOR_TYPE_INTENSITY | PCW_OFFSET_COLOR_ENABLE ) )
+            {
+                burst( ptr, words[PCW], words[ISPTSP], words[TSP0], words[TCW0], 0, 0, 0, 0 );
+                burst( ptr + 8, floatBits( color0[0] ), floatBits( color0[1] ), floatBits( color0[2] ), floatBits( color0[3] ),
+                       floatBits( color1[0] ), floatBits( color1[1] ), floatBits( color1[2] ), floatBits( color1[3] ) );
+                return 16;
+            }
+
+            burst( ptr, words[PCW], words[ISPTSP], words[TSP0], words[TCW0],
+                   floatBits( color0[0] ), floatBits( color0[1] ), floatBits( color0[2] ), floatBits( color0[3] ) );
+            return 8;
+        }
+        else if constexpr ( Info::twoParam )
+        {
+            burst( ptr, words[PCW], words[ISPTSP], words[TSP0], words[TCW0], words[TSP1], words[TCW1], 0, 0 );
+
+            if constexpr ( Info::intensity )
+            {
+                if ( ( words[PCW] & PCW_COLOR_TYPE_MASK ) == PCW_COLOR_TYPE_INTENSITY )
+                {
+                    burst( ptr + 8, floatBits( color0[0] ), floatBits( color0[1] ), floatBits( color0[2] ), floatBits( color0[3] ),
+                           floatBits( color1[0] ), floatBits( color1[1] ), floatBits( color1[2] ), floatBits( color1[3] ) );
+                    return 16;
+                }
+            }
+
+            return 8;
+        }
+        else if constexpr ( Type == 15 )
+        {
+            burst( ptr, words[PCW], words[ISPTSP], words[TSP0], words[TCW0], sprColor, 0, 0, 0 );
+            return 8;
+        }
+        else if constexpr ( Type == 16 )
+        {
+            burst( ptr, words[PCW], words[ISPTSP], words[TSP0], words[TCW0], sprColor, sprColor, 0, 0 );
+            return 8;
+        }
+        else
+        {
+            burst( ptr, words[PCW], words[ISPTSP], words[TSP0], words[TCW0], 0, 0, 0, 0 );
+            return 8;
+        }
+    }
+
+    // Copies this header into a C strip header, for use with the rest of the library
+    void toStripHeader( stripheader_t* hdr ) const
+    {
+        hdr->type = Type;
+        for ( int i = 0; i < 6; i++ )
+            hdr->words[i] = words[i];
+        for ( int i = 0; i < 4; i++ )
+        {
+            hdr->color0[i] = color0[i];
+            hdr->color1[i] = color1[i];
+        }
+        hdr->sprColor[0] = sprColor >> 24;
+        hdr->sprColor[1] = sprColor >> 16;
+        hdr->sprColor[2] = sprColor >> 8;
+        hdr->sprColor[3] = sprColor;
+        hdr->dirty = 1;
+    }
+};
+
+// Makes a context current for the calling thread until the end of the scope.
+// With SH_NO_TLS, scopes for different contexts can't be nested.
+class ContextScope
+{
+public:
+    explicit ContextScope( sh_context_t* ctx ) : previous( shGetCurrentContext() ) { shMakeCurrent( ctx ); }
+    ~ContextScope() { shMakeCurrent( previous ); }
+
+    ContextScope( const ContextScope& ) = delete;
+    ContextScope& operator=( const ContextScope& ) = delete;
+
+private:
+    sh_context_t* previous;
+};
+
+} // namespace sh
+
+// Everything above is expanded already, so the register macros can go
+#include "shundef.h"
+
+#endif // __STRIPHEADER_HPP__
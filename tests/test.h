@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+/*
+ Minimal checks for the host tests.
+
+ CHECK( cond ) and CHECK_EQ( a, b ) print the failing line and carry on,
+ testResult() returns the exit code for main.
+*/
+
+#ifndef __TEST_H__
+#define __TEST_H__
+
+#include <stdio.h>
+
+static int test_failures = 0;
+
+#define CHECK( cond ) \
+    do { if ( !( cond ) ) { fprintf( stderr, "%s:%d: CHECK( %s ) failed\n", __FILE__, __LINE__, #cond ); test_failures++; } } while ( 0 )
+
+#define CHECK_EQ( a, b ) \
+    do { unsigned long long _a = (unsigned long long)( a ), _b = (unsigned long long)( b ); \
+         if ( _a != _b ) { fprintf( stderr, "%s:%d: %s == %s failed (0x%llx != 0x%llx)\n", __FILE__, __LINE__, #a, #b, _a, _b ); test_failures++; } } while ( 0 )
+
+static inline int testResult( const char* name )
+{
+    if ( test_failures != 0 )
+        fprintf( stderr, "%s: %d check(s) failed\n", name, test_failures );
+    else
+        printf( "%s: ok\n", name );
+
+    return test_failures != 0;
+}
+
+#endif // __TEST_H__
@@ -0,0 +1,214 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks that command buffer frames wrap around the ring, that writes past
+// the end of a segment are dropped and counted, and that the lists handed
+// back when a frame ends point at what was written.
+
+#include <string.h>
+#include "shcmdbuf.h"
+#include "shdefs.h"
+#include "test.h"
+
+#define ARENA_WORDS	64
+
+static uint32 arena[ARENA_WORDS] __attribute__((aligned(32)));
+
+static void sizes( uint32 list_size[SH_CMDBUF_LISTS], uint32 op, uint32 tr )
+{
+    memset( list_size, 0, SH_CMDBUF_LISTS * sizeof(uint32) );
+    list_size[PVR_LIST_OP_POLY] = op;
+    list_size[PVR_LIST_TR_POLY] = tr;
+}
+
+static void fill( uint32* words, uint32 count, uint32 tag )
+{
+    uint32 i;
+
+    for ( i = 0; i < count; i++ )
+        words[i] = tag + i;
+}
+
+static void test_overflow( void )
+{
+    uint32 list_size[SH_CMDBUF_LISTS];
+    uint32 words[16];
+    stripheader_t hdr;
+    shcmdframe_t frame;
+    shcmdbuf_t cb;
+    int i;
+
+    shCmdBufInit( &cb, arena, sizeof(arena) );
+    CHECK_EQ( cb.size, ARENA_WORDS );
+
+    // 32 bytes of OP and 32 of TR
+    sizes( list_size, 32, 32 );
+    CHECK( shCmdBufBeginFrame( &cb, list_size ) );
+
+    // 5 words fit, the next 4 don't and are dropped, the last 3 fill it up
+    fill( words, 16, 0x100 );
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_OP_POLY, words, 5 ), 5 );
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_OP_POLY, words + 5, 4 ), 0 );
+    CHECK_EQ( cb.lists[PVR_LIST_OP_POLY].overflow, 4 );
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_OP_POLY, words + 5, 3 ), 3 );
+    CHECK( shCmdBufAlloc( &cb, PVR_LIST_OP_POLY, 1 ) == NULL );
+    CHECK_EQ( cb.lists[PVR_LIST_OP_POLY].overflow, 5 );
+
+    // One header fits in the TR segment, the second is dropped
+    shInit( &hdr, 0, PVR_LIST_TR_POLY, NULL, NULL );
+    CHECK_EQ( shCmdBufCommit( &cb, &hdr ), 8 );
+    CHECK_EQ( shCmdBufCommit( &cb, &hdr ), 0 );
+    CHECK_EQ( cb.lists[PVR_LIST_TR_POLY].overflow, 8 );
+
+    // Lists without a segment drop everything, and there's no sixth list
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_PT_POLY, words, 1 ), 0 );
+    CHECK_EQ( cb.lists[PVR_LIST_PT_POLY].overflow, 1 );
+    CHECK( shCmdBufAlloc( &cb, (pvr_list_t)SH_CMDBUF_LISTS, 1 ) == NULL );
+
+    shCmdBufEndFrame( &cb, &frame );
+
+    // Segments are laid out in list order, empty ones have no size
+    CHECK( frame.list_start[PVR_LIST_OP_POLY] == arena );
+    CHECK_EQ( frame.list_size[PVR_LIST_OP_POLY], 32 );
+    CHECK( frame.list_start[PVR_LIST_OP_MOD] == arena + 8 );
+    CHECK_EQ( frame.list_size[PVR_LIST_OP_MOD], 0 );
+    CHECK( frame.list_start[PVR_LIST_TR_POLY] == arena + 8 );
+    CHECK_EQ( frame.list_size[PVR_LIST_TR_POLY], 32 );
+    CHECK_EQ( frame.list_size[PVR_LIST_TR_MOD], 0 );
+    CHECK_EQ( frame.list_size[PVR_LIST_PT_POLY], 0 );
+    CHECK_EQ( frame.begin, 0 );
+    CHECK_EQ( frame.end, 16 );
+
+    // Only what fit was written
+    for ( i = 0; i < 8; i++ )
+        CHECK_EQ( arena[i], 0x100 + i );
+    CHECK_EQ( arena[8], hdr.words[PCW] );
+
+    // The high water marks count what was used, not what was dropped
+    CHECK_EQ( cb.lists[PVR_LIST_OP_POLY].high_water, 8 );
+    CHECK_EQ( cb.lists[PVR_LIST_TR_POLY].high_water, 8 );
+    CHECK_EQ( cb.lists[PVR_LIST_PT_POLY].high_water, 0 );
+    CHECK_EQ( cb.high_water, 16 );
+
+    // Nothing can be written once the frame has ended
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_OP_POLY, words, 1 ), 0 );
+
+    shCmdBufRelease( &cb, &frame );
+    CHECK_EQ( cb.in_flight, 0 );
+}
+
+static void test_wrap( void )
+{
+    uint32 list_size[SH_CMDBUF_LISTS];
+    shcmdframe_t a, b, c, d, e;
+    uint32 words[24];
+    shcmdbuf_t cb;
+
+    fill( words, 24, 0x200 );
+    shCmdBufInit( &cb, arena, sizeof(arena) );
+
+    // A frame bigger than the arena never fits
+    sizes( list_size, ARENA_WORDS * 4, 32 );
+    CHECK( !shCmdBufBeginFrame( &cb, list_size ) );
+
+    // A: words 0-15, rounded up from 33 bytes
+    sizes( list_size, 33, 0 );
+    CHECK( shCmdBufBeginFrame( &cb, list_size ) );
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_OP_POLY, words, 3 ), 3 );
+    shCmdBufEndFrame( &cb, &a );
+    CHECK_EQ( a.begin, 0 );
+    CHECK_EQ( a.end, 16 );
+    CHECK_EQ( a.list_size[PVR_LIST_OP_POLY], 12 );
+
+    // B: words 16-31
+    sizes( list_size, 0, 64 );
+    CHECK( shCmdBufBeginFrame( &cb, list_size ) );
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_TR_POLY, words, 10 ), 10 );
+    shCmdBufEndFrame( &cb, &b );
+    CHECK( b.list_start[PVR_LIST_TR_POLY] == arena + 16 );
+    CHECK_EQ( b.list_size[PVR_LIST_TR_POLY], 40 );
+
+    // C: words 32-55, leaving 8 words at the end
+    sizes( list_size, 96, 0 );
+    CHECK( shCmdBufBeginFrame( &cb, list_size ) );
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_OP_POLY, words, 24 ), 24 );
+    shCmdBufEndFrame( &cb, &c );
+    CHECK_EQ( c.begin, 32 );
+    CHECK_EQ( c.end, 56 );
+    CHECK_EQ( cb.in_flight, 3 );
+
+    // 16 words don't fit at the end, and A is still in flight
+    sizes( list_size, 64, 0 );
+    CHECK( !shCmdBufBeginFrame( &cb, list_size ) );
+
+    // Once A is released, D wraps around to the beginning
+    shCmdBufRelease( &cb, &a );
+    CHECK( shCmdBufBeginFrame( &cb, list_size ) );
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_OP_POLY, words + 8, 16 ), 16 );
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_OP_POLY, words, 1 ), 0 );
+    shCmdBufEndFrame( &cb, &d );
+    CHECK( d.list_start[PVR_LIST_OP_POLY] == arena );
+    CHECK_EQ( d.list_size[PVR_LIST_OP_POLY], 64 );
+    CHECK_EQ( d.begin, 0 );
+    CHECK_EQ( d.end, 16 );
+    CHECK_EQ( arena[0], 0x208 );
+    CHECK_EQ( arena[15], 0x217 );
+
+    // B and C weren't touched by the wrapped frame
+    CHECK_EQ( arena[16], 0x200 );
+    CHECK_EQ( arena[32], 0x200 );
+
+    // The head has caught up with the tail, so the ring is full
+    sizes( list_size, 32, 0 );
+    CHECK( !shCmdBufBeginFrame( &cb, list_size ) );
+
+    // Releasing B frees the room between D and C
+    shCmdBufRelease( &cb, &b );
+    sizes( list_size, 32, 32 );
+    CHECK( shCmdBufBeginFrame( &cb, list_size ) );
+    CHECK_EQ( shCmdBufWrite( &cb, PVR_LIST_TR_POLY, words, 9 ), 0 );
+    shCmdBufEndFrame( &cb, &e );
+    CHECK_EQ( e.begin, 16 );
+    CHECK_EQ( e.end, 32 );
+    CHECK( e.list_start[PVR_LIST_TR_POLY] == arena + 24 );
+    CHECK_EQ( e.list_size[PVR_LIST_TR_POLY], 0 );
+
+    // Overflow and high water marks carry over between frames
+    CHECK_EQ( cb.lists[PVR_LIST_OP_POLY].overflow, 1 );
+    CHECK_EQ( cb.lists[PVR_LIST_TR_POLY].overflow, 9 );
+    CHECK_EQ( cb.lists[PVR_LIST_OP_POLY].high_water, 24 );
+    CHECK_EQ( cb.lists[PVR_LIST_TR_POLY].high_water, 10 );
+    CHECK_EQ( cb.high_water, 24 );
+
+    // With everything released, the next frame starts over at the beginning
+    shCmdBufRelease( &cb, &c );
+    shCmdBufRelease( &cb, &d );
+    shCmdBufRelease( &cb, &e );
+    CHECK_EQ( cb.in_flight, 0 );
+    sizes( list_size, ARENA_WORDS * 4, 0 );
+    CHECK( shCmdBufBeginFrame( &cb, list_size ) );
+    shCmdBufEndFrame( &cb, &a );
+    CHECK_EQ( a.begin, 0 );
+    CHECK_EQ( a.end, ARENA_WORDS );
+}
+
+int main( void )
+{
+    test_overflow();
+    test_wrap();
+
+    return testResult( "test_cmdbuf" );
+}
@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks that the batch color packers give the same results as shPackColor,
+// including for NaN, infinities and out of range values.
+//
+// Built twice: test_color uses the library as built (SSE2 or NEON on most
+// hosts) and test_color_scalar builds shcolor.c with the SIMD paths off.
+
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include "shcolor.h"
+#include "test.h"
+
+#define MAX_COLORS	1024
+
+static float argb[MAX_COLORS * 4];
+static uint32 packed[MAX_COLORS];
+static uint32 strided[MAX_COLORS * 3];
+
+// Values near every rounding boundary, the special values and some noise
+static uint32 fill_values( void )
+{
+    static const float specials[] =
+    {
+        NAN, -NAN, INFINITY, -INFINITY, 0.0f, -0.0f, 1.0f, -1.0f, 2.0f, 0.5f,
+        1e30f, -1e30f, FLT_MIN, -FLT_MIN, FLT_MIN / 4.0f, FLT_MAX, -FLT_MAX,
+        1.0f + FLT_EPSILON, 1.0f - FLT_EPSILON / 2.0f,
+    };
+    uint32 n = 0, seed = 12345, i;
+    int k;
+
+    for ( i = 0; i < sizeof(specials) / sizeof(specials[0]); i++ )
+        argb[n++] = specials[i];
+
+    for ( k = 0; k < 255; k++ )
+    {
+        const float edge = ( k + 0.5f ) / 255.0f;
+
+        argb[n++] = nextafterf( edge, 0.0f );
+        argb[n++] = edge;
+        argb[n++] = nextafterf( edge, 1.0f );
+    }
+
+    while ( n < MAX_COLORS * 4 - 5 )
+    {
+        seed = seed * 1664525u + 1013904223u;
+        argb[n++] = (float)( seed >> 8 ) / (float)( 1 << 24 ) * 2.0f - 0.5f;
+    }
+
+    // Not a multiple of 4 colors, so the tail loops run too
+    return n / 4;
+}
+
+int main( void )
+{
+    const uint32 count = fill_values();
+    uint32 i;
+
+    CHECK( count % 4 != 0 );
+
+    CHECK_EQ( shPackComponent( NAN ), 0 );
+    CHECK_EQ( shPackComponent( -NAN ), 0 );
+    CHECK_EQ( shPackComponent( INFINITY ), 255 );
+    CHECK_EQ( shPackComponent( -INFINITY ), 0 );
+    CHECK_EQ( shPackColor( NAN, 1.0f, 0.5f, -1.0f ), 0x00FF8000 );
+
+    memset( packed, 0, sizeof(packed) );
+    shPackColors( packed, argb, count );
+    for ( i = 0; i < count; i++ )
+        CHECK_EQ( packed[i], shPackColor( argb[i * 4], argb[i * 4 + 1], argb[i * 4 + 2], argb[i * 4 + 3] ) );
+
+    // Every third word, the others must be left alone
+    memset( strided, 0xAB, sizeof(strided) );
+    shPackColorsStrided( strided, 12, argb, count );
+    for ( i = 0; i < count; i++ )
+    {
+        CHECK_EQ( strided[i * 3], packed[i] );
+        CHECK_EQ( strided[i * 3 + 1], 0xABABABAB );
+        CHECK_EQ( strided[i * 3 + 2], 0xABABABAB );
+    }
+
+    return testResult( "test_color" );
+}
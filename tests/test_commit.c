@@ -0,0 +1,288 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks the baked commit path against the layout shCommit had before
+// headers were baked, for every type, and that shCommitCached only reuses
+// a block until a setter changes the header.
+//
+// Built against its own copy of the library with SH_FLUSH_HOOK, so the
+// order the halves of a block are flushed in can be seen.
+
+#include <string.h>
+#include "stripheader.h"
+#include "shdefs.h"
+#include "test.h"
+
+static uint8 vram[8192] __attribute__((aligned(32)));
+static const texture_t tex0 = { 256, 256, TEXFMT_RGB565, TEXFLAG_TWIDDLED, vram };
+static const texture_t tex1 = { 64, 32, TEXFMT_ARGB4444, TEXFLAG_MIPMAPPED, vram + 4096 };
+
+static uint32 out[16] __attribute__((aligned(32)));
+static uint32 expected[16];
+
+static void* flushes[4];
+static int flush_count;
+
+void test_flush( void* addr )
+{
+    if ( flush_count < 4 )
+        flushes[flush_count] = addr;
+    flush_count++;
+}
+
+// Setters that don't apply to a type are expected to fail here
+static void ignore_error( SHERROR err, const char* fnname )
+{
+    (void)err;
+    (void)fnname;
+}
+
+static uint32 bits( float f )
+{
+    uint32 u;
+
+    memcpy( &u, &f, 4 );
+    return u;
+}
+
+// The words shCommit wrote before blocks were baked, read straight from
+// the header
+static int baseline( const stripheader_t* h, uint32* w )
+{
+    const uint32 pcw = h->words[0];
+    const int intensity = ( pcw & PCW_COLOR_TYPE_MASK ) == PCW_COLOR_TYPE_INTENSITY;
+    const int offset = ( pcw & PCW_OFFSET_COLOR_MASK ) == PCW_OFFSET_COLOR_ENABLE;
+    const uint32 spr = ( (uint32)h->sprColor[0] << 24 ) | ( h->sprColor[1] << 16 ) | ( h->sprColor[2] << 8 ) | h->sprColor[3];
+    int size = 8, i;
+
+    memset( w, 0, 16 * 4 );
+    for ( i = 0; i < 4; i++ )
+        w[i] = h->words[i];
+
+    switch ( h->type )
+    {
+        case 2:
+            for ( i = 0; i < 4; i++ )
+                w[4 + i] = bits( h->color0[i] );
+            break;
+
+        case 7:
+        case 8:
+            if ( intensity && offset )
+            {
+                for ( i = 0; i < 4; i++ )
+                {
+                    w[8 + i] = bits( h->color0[i] );
+                    w[12 + i] = bits( h->color1[i] );
+                }
+                size = 16;
+            }
+            else
+            {
+                for ( i = 0; i < 4; i++ )
+                    w[4 + i] = bits( h->color0[i] );
+            }
+            break;
+
+        case 9:
+        case 11:
+        case 12:
+            w[4] = h->words[4];
+            w[5] = h->words[5];
+            break;
+
+        case 10:
+        case 13:
+        case 14:
+            w[4] = h->words[4];
+            w[5] = h->words[5];
+            if ( intensity )
+            {
+                for ( i = 0; i < 4; i++ )
+                {
+                    w[8 + i] = bits( h->color0[i] );
+                    w[12 + i] = bits( h->color1[i] );
+                }
+                size = 16;
+            }
+            break;
+
+        case 15:
+            w[4] = spr;
+            break;
+
+        case 16:
+            w[4] = spr;
+            w[5] = spr;
+            break;
+    }
+
+    return size;
+}
+
+static void init( stripheader_t* hdr, uint32 type )
+{
+    shInit( hdr, type, type == 17 ? PVR_LIST_OP_MOD : PVR_LIST_TR_POLY, &tex0, &tex1 );
+}
+
+// Commits a header and checks it against the baseline, and that a block
+// is flushed half by half from the start
+static void check_commit( stripheader_t* hdr )
+{
+    const int size = baseline( hdr, expected );
+    int i;
+
+    memset( out, 0xAA, sizeof(out) );
+    flush_count = 0;
+
+    CHECK_EQ( shCommit( hdr, out ), size );
+    CHECK( memcmp( out, expected, size * 4 ) == 0 );
+    if ( size == 8 )
+        CHECK_EQ( out[8], 0xAAAAAAAA );
+
+    CHECK_EQ( flush_count, size / 8 );
+    for ( i = 0; i < flush_count && i < 4; i++ )
+        CHECK( flushes[i] == out + i * 8 );
+}
+
+static void test_layout( void )
+{
+    stripheader_t hdr;
+    uint32 type;
+    uint8 rgba[4] = { 0x10, 0x20, 0x30, 0x40 };
+
+    for ( type = 0; type < 18; type++ )
+    {
+        init( &hdr, type );
+        check_commit( &hdr );
+
+        // Colors, where the type takes them
+        shBaseColor( &hdr, 0.25f, 0.5f, 0.75f, 1.0f );
+        shBaseColor2( &hdr, 0.125f, 0.375f, 0.625f, 0.875f );
+        shSpriteColor( &hdr, rgba );
+        check_commit( &hdr );
+
+        // Offset color makes the textured intensity types 16 words
+        shEnable( &hdr, SH_OFFSET_COLOR );
+        shOffsetColor( &hdr, 0.5f, 0.25f, 0.125f, 0.0625f );
+        check_commit( &hdr );
+
+        // Previous face color
+        shEnable( &hdr, SH_USE_PREVIOUS_COLOR );
+        check_commit( &hdr );
+    }
+
+    // The 16-word headers, named so a missing one shows up
+    init( &hdr, 7 );
+    shEnable( &hdr, SH_OFFSET_COLOR );
+    CHECK_EQ( shCommit( &hdr, out ), 16 );
+
+    for ( type = 10; type <= 14; type++ )
+    {
+        if ( type == 11 || type == 12 )
+            continue;
+        init( &hdr, type );
+        CHECK_EQ( shCommit( &hdr, out ), 16 );
+    }
+}
+
+// Commits through the cache and checks the block is the same as a fresh
+// commit of the header
+static void check_cached( stripheader_t* hdr, shblock_t* block )
+{
+    stripheader_t copy = *hdr;
+    const int size = shCommit( &copy, expected );
+
+    CHECK_EQ( shCommitCached( hdr, block, out ), size );
+    CHECK( memcmp( out, expected, size * 4 ) == 0 );
+    CHECK_EQ( hdr->dirty, 0 );
+}
+
+static void test_cached( void )
+{
+    static const uint8 rgba[4] = { 1, 2, 3, 4 };
+    shtexturedesc_t desc;
+    shblock_t block;
+    stripheader_t hdr;
+    SHSTATE state;
+    uint32 before;
+
+    memset( &block, 0, sizeof(block) );
+    CHECK( shTextureDesc( &desc, &tex1 ) );
+
+    // Type 14 has both textures and both colors
+    init( &hdr, 14 );
+    CHECK_EQ( hdr.dirty, 1 );
+    check_cached( &hdr, &block );
+
+    // Without a setter the block is reused as it is
+    before = hdr.words[0];
+    hdr.words[0] ^= 1;
+    CHECK_EQ( shCommitCached( &hdr, &block, out ), 16 );
+    CHECK_EQ( out[0], before );
+    hdr.words[0] ^= 1;
+
+    // Every kind of setter marks the header for a rebake
+    CHECK( shEnable( &hdr, SH_ALPHA ) );
+    check_cached( &hdr, &block );
+    CHECK( shBlendFunc( &hdr, SH_BLEND_SRC_ALPHA, SH_BLEND_ONE ) );
+    check_cached( &hdr, &block );
+    CHECK( shTexture( &hdr, &tex1 ) );
+    check_cached( &hdr, &block );
+    CHECK( shTextureFromDesc2( &hdr, &desc ) );
+    check_cached( &hdr, &block );
+    CHECK( shBaseColor( &hdr, 0.1f, 0.2f, 0.3f, 0.4f ) );
+    check_cached( &hdr, &block );
+    CHECK( shBaseColor2( &hdr, 0.5f, 0.6f, 0.7f, 0.8f ) );
+    check_cached( &hdr, &block );
+
+    memset( &state, 0, sizeof(state) );
+    state.flags = SH_STATE_CULL | SH_STATE_DEPTH_FUNC;
+    state.cull = SH_CULL_CW;
+    state.depth = SH_DEPTH_LESS;
+    CHECK( shSetState( &hdr, &state ) );
+    check_cached( &hdr, &block );
+
+    // Offset color on a single volume textured intensity type
+    init( &hdr, 8 );
+    check_cached( &hdr, &block );
+    CHECK( shEnable( &hdr, SH_OFFSET_COLOR ) );
+    check_cached( &hdr, &block );
+    CHECK( shOffsetColor( &hdr, 0.9f, 0.8f, 0.7f, 0.6f ) );
+    check_cached( &hdr, &block );
+
+    // Sprite color
+    init( &hdr, 16 );
+    check_cached( &hdr, &block );
+    CHECK( shSpriteColor( &hdr, (uint8*)rgba ) );
+    check_cached( &hdr, &block );
+    CHECK( shSpriteColorf( &hdr, 1.0f, 0.0f, 0.5f, 0.0f ) );
+    check_cached( &hdr, &block );
+
+    // A block that was never baked is baked even if the header is clean
+    memset( &block, 0, sizeof(block) );
+    check_cached( &hdr, &block );
+}
+
+int main( void )
+{
+    shErrorHandler( ignore_error );
+
+    test_layout();
+    test_cached();
+
+    return testResult( "test_commit" );
+}
@@ -0,0 +1,225 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Contexts on several threads at once.
+//
+// Every thread builds and commits the same headers into its own buffer
+// with its own context current, and makes one invalid call per round. The
+// output must match a single threaded run, and every error must end up in
+// the context of the thread that made it, never in another thread's or in
+// the global handler.
+//
+// Built twice: test_context as is, and test_context_notls against a
+// library built with SH_NO_TLS, where only one context can be current.
+
+#include <string.h>
+#include "stripheader.h"
+#include "test.h"
+
+#ifndef SH_NO_TLS
+#include <pthread.h>
+#endif
+
+#define THREADS		8
+#define ROUNDS		2000
+#define MAX_WORDS	( 18 * 16 )
+
+static int global_errors = 0;
+
+static void global_handler( SHERROR err, const char* fnname )
+{
+    (void)err;
+    (void)fnname;
+    __atomic_add_fetch( &global_errors, 1, __ATOMIC_RELAXED );
+}
+
+// One header of every type, with some state that depends on the round.
+// Returns the number of words written.
+static int build( uint32* out, uint32 round, stripheader_t* bad )
+{
+    stripheader_t hdr;
+    int n = 0;
+    uint32 type;
+
+    for ( type = 0; type < 18; type++ )
+    {
+        if ( type == 17 )
+        {
+            shInit( &hdr, type, PVR_LIST_OP_MOD, NULL, NULL );
+            shCullMode( &hdr, ( round & 1 ) ? SH_CULL_CW : SH_CULL_NONE );
+        }
+        else
+        {
+            shInit( &hdr, type, ( round & 2 ) ? PVR_LIST_TR_POLY : PVR_LIST_OP_POLY, NULL, NULL );
+            shDepthFunc( &hdr, (SHDEPTHFUNC)( round & 7 ) );
+            shBlendFunc( &hdr, SH_BLEND_SRC_ALPHA, SH_BLEND_INVERSE_SRC_ALPHA );
+            shUserClip( &hdr, ( round & 4 ) ? SH_CLIP_INSIDE : SH_CLIP_DISABLE );
+        }
+
+        n += shCommit( &hdr, out + n );
+    }
+
+    // Not a header type
+    shInit( bad, 18 + round % 100, PVR_LIST_OP_POLY, NULL, NULL );
+    return n;
+}
+
+#ifndef SH_NO_TLS
+
+static uint32 reference[8][MAX_WORDS];
+static int reference_words[8];
+
+typedef struct
+{
+    sh_context_t	ctx;
+    sherrorring_t	ring;
+    sherrorentry_t	entries[4];
+    stripheader_t	bad;
+    uint32		out[MAX_WORDS] __attribute__((aligned(32)));
+    int			mismatches;	// Rounds that didn't match the reference
+    int			misplaced;	// Errors that weren't this thread's
+    int			errors;		// Errors taken from the ring
+} worker_t;
+
+static worker_t workers[THREADS];
+
+static void* run_worker( void* p )
+{
+    worker_t* w = (worker_t*)p;
+    sherrorentry_t e;
+    uint32 round;
+
+    shMakeCurrent( &w->ctx );
+
+    for ( round = 0; round < ROUNDS; round++ )
+    {
+        const int n = build( w->out, round, &w->bad );
+
+        if ( n != reference_words[round & 7] || memcmp( w->out, reference[round & 7], n * 4 ) != 0 )
+            w->mismatches++;
+
+        while ( shErrorRingPop( &w->ring, &e ) )
+        {
+            if ( e.code != SH_ERROR_INVALID_TYPE || e.hdr != &w->bad || e.type != 18 + round % 100 )
+                w->misplaced++;
+            w->errors++;
+        }
+    }
+
+    shMakeCurrent( NULL );
+    return NULL;
+}
+
+static void test_threads( void )
+{
+    static uint32 out[MAX_WORDS] __attribute__((aligned(32)));
+    pthread_t threads[THREADS];
+    stripheader_t bad;
+    sh_context_t ctx;
+    uint32 round;
+    int i;
+
+    // Reference output for each kind of round, in a context of its own
+    shContextInit( &ctx );
+    CHECK( shMakeCurrent( &ctx ) );
+
+    for ( round = 0; round < 8; round++ )
+    {
+        reference_words[round] = build( out, round, &bad );
+        memcpy( reference[round], out, sizeof(out) );
+    }
+
+    CHECK_EQ( ctx.error_count, 8 );
+    CHECK_EQ( shContextError( &ctx ), SH_ERROR_INVALID_TYPE );
+    shMakeCurrent( NULL );
+
+    for ( i = 0; i < THREADS; i++ )
+    {
+        worker_t* w = &workers[i];
+
+        shContextInit( &w->ctx );
+        shErrorRingInit( &w->ring, w->entries, 4 );
+        shContextErrorRing( &w->ctx, &w->ring );
+        CHECK_EQ( pthread_create( &threads[i], NULL, run_worker, w ), 0 );
+    }
+
+    for ( i = 0; i < THREADS; i++ )
+    {
+        const worker_t* w = &workers[i];
+
+        pthread_join( threads[i], NULL );
+        CHECK_EQ( w->mismatches, 0 );
+        CHECK_EQ( w->misplaced, 0 );
+        CHECK_EQ( w->errors, ROUNDS );
+        CHECK_EQ( w->ctx.error_count, ROUNDS );
+        CHECK_EQ( w->ring.overflow, 0 );
+    }
+
+    CHECK_EQ( shGetCurrentContext(), NULL );
+    CHECK_EQ( global_errors, 0 );
+
+    // Without a current context errors go to the global handler again
+    shInit( &bad, 99, PVR_LIST_OP_POLY, NULL, NULL );
+    CHECK_EQ( global_errors, 1 );
+}
+
+#else
+
+static void test_single_current( void )
+{
+    static uint32 out[MAX_WORDS] __attribute__((aligned(32)));
+    stripheader_t bad;
+    sh_context_t a, b;
+
+    shContextInit( &a );
+    shContextInit( &b );
+
+    CHECK( shMakeCurrent( &a ) );
+    CHECK( shMakeCurrent( &a ) );
+
+    // b can't take over while a is current, and the refusal is an error of a
+    CHECK( !shMakeCurrent( &b ) );
+    CHECK_EQ( shGetCurrentContext(), &a );
+    CHECK_EQ( shContextError( &a ), SH_ERROR_NOT_ALLOWED );
+
+    build( out, 0, &bad );
+    CHECK_EQ( a.error_count, 2 );
+    CHECK_EQ( b.error_count, 0 );
+
+    CHECK( shMakeCurrent( NULL ) );
+    CHECK( shMakeCurrent( &b ) );
+    build( out, 0, &bad );
+    CHECK_EQ( b.error_count, 1 );
+    CHECK( shMakeCurrent( NULL ) );
+}
+
+#endif
+
+int main( void )
+{
+    shErrorHandler( global_handler );
+
+#ifndef SH_NO_TLS
+    test_threads();
+
+    return testResult( "test_context" );
+#else
+    test_single_current();
+    CHECK_EQ( global_errors, 0 );
+
+    return testResult( "test_context_notls" );
+#endif
+}
@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks that stripheader.hpp builds the same headers as the C functions,
+// and that it doesn't leak the shdefs.h macros.
+
+#include "stripheader.hpp"
+#include "shdefs_leak_check.h"
+
+#include <string.h>
+#include <utility>
+
+#include "test.h"
+
+static uint8 vram[1 << 16] __attribute__((aligned(32)));
+
+static const texture_t tex_rgb   = { 256, 256, TEXFMT_RGB565,   TEXFLAG_TWIDDLED,  vram };
+static const texture_t tex_pal   = { 64,  32,  TEXFMT_PAL8BPP,  TEXFLAG_MIPMAPPED, vram + 4096 };
+static const texture_t tex_wide  = { 2048, 8,  TEXFMT_RGB565,   0,                 vram };	// Too wide
+
+static int errors = 0;
+static void count_error( SHERROR, const char* ) { errors++; }
+
+// An opaque or translucent list that the type can go in
+template<uint32 Type>
+static constexpr pvr_list_t listFor( bool translucent )
+{
+    if ( sh::TypeInfo<Type>::modifier )
+        return translucent ? PVR_LIST_TR_MOD : PVR_LIST_OP_MOD;
+    return translucent ? PVR_LIST_TR_POLY : PVR_LIST_OP_POLY;
+}
+
+// Commits both headers and compares the output
+template<uint32 Type, pvr_list_t List>
+static void checkSame( const sh::StripHeader<Type, List>& a, stripheader_t* b )
+{
+    uint32 x[16] = { 0 }, y[16] = { 0 };
+    int n = a.commit( x );
+    int m = shCommit( b, y );
+
+    CHECK_EQ( n, m );
+    for ( int i = 0; i < m; i++ )
+        CHECK_EQ( x[i], y[i] );
+}
+
+template<uint32 Type, pvr_list_t List>
+static void checkInit()
+{
+    const texture_t* tex = sh::TypeInfo<Type>::textured ? &tex_rgb : nullptr;
+    const texture_t* tex2 = sh::TypeInfo<Type>::twoParam ? &tex_pal : nullptr;
+    sh::StripHeader<Type, List> a( tex, tex2 );
+    stripheader_t b;
+
+    CHECK( shInit( &b, Type, List, tex, tex2 ) );
+    checkSame( a, &b );
+}
+
+// Enables and disables one capability, if the type allows it
+template<uint32 Type, SHCAPABILITY Cap>
+static void checkCapability()
+{
+    if constexpr ( ( sh::detail::capabilities[Cap].allowed_types & sh::TypeInfo<Type>::bit ) != 0 )
+    {
+        sh::StripHeader<Type, listFor<Type>( false )> a;
+        stripheader_t b;
+        shInit( &b, Type, listFor<Type>( false ), NULL, NULL );
+
+        a.template enable<Cap>();
+        CHECK( shEnable( &b, Cap ) );
+        checkSame( a, &b );
+
+        a.template disable<Cap>();
+        CHECK( shDisable( &b, Cap ) );
+        checkSame( a, &b );
+    }
+}
+
+template<uint32 Type, size_t... Caps>
+static void checkCapabilities( std::index_sequence<Caps...> )
+{
+    ( checkCapability<Type, (SHCAPABILITY)Caps>(), ... );
+}
+
+template<uint32... Types>
+static void checkAllTypes()
+{
+    ( checkInit<Types, listFor<Types>( false )>(), ... );
+    ( checkInit<Types, listFor<Types>( true )>(), ... );
+    ( checkCapabilities<Types>( std::make_index_sequence<SH_DEPTH_WRITE + 1>() ), ... );
+}
+
+// A texture that fails to set clears the old one, in both layers
+static void checkInvalidTexture()
+{
+    sh::StripHeader<11, PVR_LIST_OP_POLY> a( &tex_rgb, &tex_pal );
+    stripheader_t b;
+    shInit( &b, 11, PVR_LIST_OP_POLY, &tex_rgb, &tex_pal );
+
+    errors = 0;
+    CHECK( !a.texture( &tex_wide ) );
+    CHECK( !shTexture( &b, &tex_wide ) );
+    CHECK_EQ( errors, 1 );
+    CHECK_EQ( a.words[3], 0 );
+    checkSame( a, &b );
+
+    CHECK( !a.texture2( &tex_wide ) );
+    CHECK( !shTexture2( &b, &tex_wide ) );
+    CHECK_EQ( a.words[5], 0 );
+    checkSame( a, &b );
+
+    CHECK( a.texture( &tex_pal ) );
+    CHECK( shTexture( &b, &tex_pal ) );
+    CHECK( a.texture( nullptr ) );
+    CHECK( shTexture( &b, NULL ) );
+    checkSame( a, &b );
+}
+
+int main()
+{
+    shErrorHandler( count_error );
+
+    checkAllTypes<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17>();
+    checkInvalidTexture();
+
+    return testResult( "test_cpp" );
+}
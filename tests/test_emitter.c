@@ -0,0 +1,217 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks which headers the emitter sends and which it elides, per list,
+// the strip lengths it picks for strips, and its counters.
+
+#include <string.h>
+#include "shemitter.h"
+#include "shdefs.h"
+#include "test.h"
+
+static uint32 out[16] __attribute__((aligned(32)));
+
+// Emits a header and returns the words written, checking that an elided
+// header leaves the output alone
+static int emit( shemitter_t* em, stripheader_t* hdr )
+{
+    int n;
+
+    memset( out, 0xAA, sizeof(out) );
+    n = shEmit( em, hdr, out );
+    if ( n == 0 )
+        CHECK_EQ( out[0], 0xAAAAAAAA );
+
+    return n;
+}
+
+static void test_elision( void )
+{
+    stripheader_t a, b, a_tr, mod;
+    shemitter_t em;
+
+    shEmitterInit( &em );
+    shInit( &a, 0, PVR_LIST_OP_POLY, NULL, NULL );
+    shInit( &b, 0, PVR_LIST_OP_POLY, NULL, NULL );
+    shBlendFunc( &b, SH_BLEND_ONE, SH_BLEND_ONE );
+    shInit( &a_tr, 0, PVR_LIST_TR_POLY, NULL, NULL );
+    shInit( &mod, 17, PVR_LIST_OP_MOD, NULL, NULL );
+
+    // The same header twice in a row is only sent once
+    CHECK_EQ( emit( &em, &a ), 8 );
+    CHECK_EQ( out[0], a.words[PCW] );
+    CHECK_EQ( emit( &em, &a ), 0 );
+
+    // A different header is sent, and so is the first one after it
+    CHECK_EQ( emit( &em, &b ), 8 );
+    CHECK_EQ( emit( &em, &a ), 8 );
+
+    // Lists are tracked apart: sending to another list doesn't make the
+    // next header in the first one look new
+    CHECK_EQ( emit( &em, &a_tr ), 8 );
+    CHECK_EQ( emit( &em, &a ), 0 );
+    CHECK_EQ( emit( &em, &a_tr ), 0 );
+
+    // Modifier headers are never elided
+    CHECK_EQ( emit( &em, &mod ), 8 );
+    CHECK_EQ( emit( &em, &mod ), 8 );
+    CHECK_EQ( emit( &em, &mod ), 8 );
+
+    CHECK_EQ( em.headers_emitted, 7 );
+    CHECK_EQ( em.headers_elided, 3 );
+    CHECK_EQ( em.bytes_emitted, 7 * 32 );
+    CHECK_EQ( em.bytes_elided, 3 * 32 );
+
+    // Resetting one list only forgets that list
+    shEmitterResetList( &em, PVR_LIST_OP_POLY );
+    CHECK_EQ( emit( &em, &a ), 8 );
+    CHECK_EQ( emit( &em, &a_tr ), 0 );
+
+    // Lists past the tracked ones are ignored
+    shEmitterResetList( &em, 7 );
+    CHECK_EQ( emit( &em, &a ), 0 );
+
+    // Resetting the emitter forgets every list, but keeps the counters
+    shEmitterReset( &em );
+    CHECK_EQ( emit( &em, &a ), 8 );
+    CHECK_EQ( emit( &em, &a_tr ), 8 );
+    CHECK_EQ( em.headers_emitted, 10 );
+    CHECK_EQ( em.headers_elided, 5 );
+
+    shEmitterResetStats( &em );
+    CHECK_EQ( em.headers_emitted, 0 );
+    CHECK_EQ( em.headers_elided, 0 );
+    CHECK_EQ( em.bytes_emitted, 0 );
+    CHECK_EQ( em.bytes_elided, 0 );
+    CHECK_EQ( emit( &em, &a ), 0 );
+}
+
+// Headers that differ only in their second half, or in size
+static void test_block_compare( void )
+{
+    stripheader_t a, b;
+    shemitter_t em;
+
+    shEmitterInit( &em );
+
+    // Two volume intensity headers are 16 words, and the colors are in
+    // the second half
+    shInit( &a, 10, PVR_LIST_OP_POLY, NULL, NULL );
+    b = a;
+    shBaseColor2( &b, 0.5f, 0.5f, 0.5f, 0.5f );
+
+    CHECK_EQ( emit( &em, &a ), 16 );
+    CHECK_EQ( emit( &em, &a ), 0 );
+    CHECK_EQ( emit( &em, &b ), 16 );
+    CHECK_EQ( em.bytes_emitted, 2 * 64 );
+    CHECK_EQ( em.bytes_elided, 64 );
+
+    // The same header words, but 8 words long with previous face color
+    shEnable( &b, SH_USE_PREVIOUS_COLOR );
+    CHECK_EQ( emit( &em, &b ), 8 );
+    CHECK_EQ( emit( &em, &a ), 16 );
+}
+
+static uint32 strip_length( const stripheader_t* hdr )
+{
+    return ( hdr->words[PCW] & PCW_STRIP_LENGTH_MASK ) >> PCW_STRIP_LENGTH_SHIFT;
+}
+
+static void test_strip_length( void )
+{
+    // Strips of 1 triangle after one of 6, and the average and strip length
+    // each one leaves behind
+    static const uint32 avg[] = { 96, 76, 61, 49, 40, 34, 29 };
+    static const uint32 length[] =
+    {
+        SH_STRIP_LENGTH_6, SH_STRIP_LENGTH_4, SH_STRIP_LENGTH_2, SH_STRIP_LENGTH_2,
+        SH_STRIP_LENGTH_2, SH_STRIP_LENGTH_2, SH_STRIP_LENGTH_1
+    };
+    stripheader_t hdr[2], sprite;
+    shemitter_t em;
+    uint32 slot, i;
+
+    shEmitterInit( &em );
+    shInit( &hdr[0], 0, PVR_LIST_OP_POLY, NULL, NULL );
+    shInit( &hdr[1], 0, PVR_LIST_OP_POLY, NULL, NULL );
+    shInit( &sprite, 15, PVR_LIST_OP_POLY, NULL, NULL );
+
+    // Off by default: the strip length is left alone, but counted
+    CHECK_EQ( shEmitStrip( &em, &hdr[0], out, 8 ), 8 );
+    CHECK_EQ( strip_length( &hdr[0] ), SH_STRIP_LENGTH_2 );
+    CHECK_EQ( em.strips, 1 );
+    CHECK_EQ( em.strip_triangles, 6 );
+    CHECK_EQ( em.strip_pointers, 3 );
+
+    shEmitterResetStats( &em );
+    shEmitterAutoStripLength( &em, 1 );
+    slot = ( (uintptr_t)&hdr[0] / sizeof(stripheader_t) ) % SH_EMITTER_STRIP_SLOTS;
+
+    // The first strip sets the average, later ones move a quarter of the
+    // way towards their length
+    for ( i = 0; i < 7; i++ )
+    {
+        memset( out, 0xAA, sizeof(out) );
+        shEmitStrip( &em, &hdr[0], out, i == 0 ? 8 : 3 );
+        CHECK_EQ( em.strip_slots[slot].avg, avg[i] );
+        CHECK_EQ( strip_length( &hdr[0] ), length[i] );
+        CHECK_EQ( em.strip_pointers, i + 1 );
+
+        // A header is only sent again when its strip length changed
+        if ( i == 0 || length[i] != length[i - 1] )
+            CHECK_EQ( ( out[0] & PCW_STRIP_LENGTH_MASK ) >> PCW_STRIP_LENGTH_SHIFT, length[i] );
+        else
+            CHECK_EQ( out[0], 0xAAAAAAAA );
+    }
+
+    CHECK_EQ( em.strips, 7 );
+    CHECK_EQ( em.strip_triangles, 12 );
+
+    // Long strips are split into groups of the chosen length
+    shEmitterResetStats( &em );
+    shEmitStrip( &em, &hdr[1], out, 15 );
+    CHECK_EQ( strip_length( &hdr[1] ), SH_STRIP_LENGTH_6 );
+    CHECK_EQ( em.strip_pointers, 3 );
+    shEmitStrip( &em, &hdr[1], out, 15 );
+    CHECK_EQ( em.strip_pointers, 6 );
+
+    // Each header has a slot of its own
+    CHECK_EQ( strip_length( &hdr[0] ), SH_STRIP_LENGTH_1 );
+    CHECK_EQ( em.strip_slots[slot].avg, 29 );
+    shEmitStrip( &em, &hdr[0], out, 7 );
+    CHECK_EQ( em.strip_slots[slot].avg, ( 29 * 3 + ( 5 << 4 ) ) / 4 );
+    CHECK_EQ( strip_length( &hdr[0] ), SH_STRIP_LENGTH_2 );
+    CHECK_EQ( em.strip_pointers, 6 + 3 );
+
+    // Strips without triangles and sprites aren't counted or changed
+    shEmitterResetStats( &em );
+    shEmitStrip( &em, &hdr[0], out, 2 );
+    shEmitStrip( &em, &sprite, out, 4 );
+    CHECK_EQ( strip_length( &hdr[0] ), SH_STRIP_LENGTH_2 );
+    CHECK_EQ( strip_length( &sprite ), SH_STRIP_LENGTH_2 );
+    CHECK_EQ( em.strips, 0 );
+    CHECK_EQ( em.strip_triangles, 0 );
+    CHECK_EQ( em.strip_pointers, 0 );
+}
+
+int main( void )
+{
+    test_elision();
+    test_block_compare();
+    test_strip_length();
+
+    return testResult( "test_emitter" );
+}
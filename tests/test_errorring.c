@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks the deferred error ring on its own: errors come out in the order
+// they were reported, a full ring counts what it drops, and a ring with a
+// capacity that isn't a power of two is rejected and has no room.
+
+#include <string.h>
+#include "stripheader.h"
+#include "test.h"
+
+#define CAPACITY	4
+
+static sherrorentry_t entries[CAPACITY];
+static stripheader_t hdr;
+static SHERROR last_error;
+
+static void handler( SHERROR err, const char* fnname )
+{
+    (void)fnname;
+    last_error = err;
+}
+
+// Reports an invalid type error tagged with the type
+static void report( uint32 type )
+{
+    CHECK( !shInit( &hdr, type, PVR_LIST_OP_POLY, NULL, NULL ) );
+}
+
+static void check_pop( sherrorring_t* ring, uint32 type )
+{
+    sherrorentry_t e;
+
+    memset( &e, 0, sizeof(e) );
+    CHECK( shErrorRingPop( ring, &e ) );
+    CHECK_EQ( e.code, SH_ERROR_INVALID_TYPE );
+    CHECK( strcmp( e.fname, "shInit" ) == 0 );
+    CHECK( e.hdr == &hdr );
+    CHECK_EQ( e.type, type );
+}
+
+static void test_fifo( void )
+{
+    sherrorring_t ring;
+    sherrorentry_t e;
+    uint32 i;
+
+    CHECK( shErrorRingInit( &ring, entries, CAPACITY ) );
+    shErrorRing( &ring );
+    CHECK( !shErrorRingPop( &ring, &e ) );
+
+    // Two more than there's room for
+    for ( i = 0; i < CAPACITY + 2; i++ )
+        report( 100 + i );
+    CHECK_EQ( ring.overflow, 2 );
+
+    // The oldest ones were kept, the newest dropped
+    for ( i = 0; i < CAPACITY; i++ )
+        check_pop( &ring, 100 + i );
+    CHECK( !shErrorRingPop( &ring, &e ) );
+
+    // Partly drained rings wrap around and keep their order
+    report( 200 );
+    report( 201 );
+    report( 202 );
+    check_pop( &ring, 200 );
+    check_pop( &ring, 201 );
+    report( 203 );
+    report( 204 );
+    report( 205 );
+    report( 206 );
+    CHECK_EQ( ring.overflow, 3 );
+    check_pop( &ring, 202 );
+    check_pop( &ring, 203 );
+    check_pop( &ring, 204 );
+    check_pop( &ring, 205 );
+    CHECK( !shErrorRingPop( &ring, &e ) );
+
+    // The handler isn't called while a ring is set
+    CHECK_EQ( last_error, SH_ERROR_OK );
+    shErrorRing( NULL );
+}
+
+static void test_capacity( void )
+{
+    static const uint32 bad[] = { 0, 3, 6, 12, 0x80000001 };
+    sherrorring_t ring;
+    sherrorentry_t e;
+    uint32 i;
+
+    for ( i = 0; i < sizeof(bad) / sizeof(bad[0]); i++ )
+    {
+        last_error = SH_ERROR_OK;
+        CHECK( !shErrorRingInit( &ring, entries, bad[i] ) );
+        CHECK_EQ( last_error, SH_ERROR_OUT_OF_RANGE );
+        CHECK_EQ( ring.capacity, 0 );
+    }
+
+    // Everything sent to a ring without room is counted as dropped, and
+    // it never has anything to take
+    last_error = SH_ERROR_OK;
+    shErrorRing( &ring );
+    report( 300 );
+    report( 301 );
+    CHECK_EQ( ring.overflow, 2 );
+    CHECK( !shErrorRingPop( &ring, &e ) );
+
+    // Including the error from initializing it while it's in use
+    CHECK( !shErrorRingInit( &ring, entries, 5 ) );
+    CHECK_EQ( ring.overflow, 1 );
+    CHECK( !shErrorRingPop( &ring, &e ) );
+
+    // A good capacity makes it usable again
+    CHECK( shErrorRingInit( &ring, entries, 1 ) );
+    report( 302 );
+    report( 303 );
+    CHECK_EQ( ring.overflow, 1 );
+    check_pop( &ring, 302 );
+    CHECK( !shErrorRingPop( &ring, &e ) );
+
+    shErrorRing( NULL );
+    CHECK_EQ( last_error, SH_ERROR_OK );
+}
+
+int main( void )
+{
+    shErrorHandler( handler );
+
+    test_fifo();
+    test_capacity();
+
+    return testResult( "test_errorring" );
+}
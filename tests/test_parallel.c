@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks the argument checks of the parallel job split and merge, and
+// that the merge puts chunks in chunk order whoever built them.
+
+#include <string.h>
+#include "shparallel.h"
+#include "test.h"
+
+#define OBJECTS		10
+#define CHUNK_SIZE	3
+
+static uint32 mem[2][256] __attribute__((aligned(32)));
+static uint32 merged[256] __attribute__((aligned(32)));
+static shchunk_t chunks[OBJECTS];
+static SHERROR last_error;
+
+static void handler( SHERROR err, const char* fnname )
+{
+    (void)fnname;
+    last_error = err;
+}
+
+static void test_chunk_size( void )
+{
+    shparallel_t par;
+
+    CHECK_EQ( shParallelChunkCount( 10, 3 ), 4 );
+    CHECK_EQ( shParallelChunkCount( 9, 3 ), 3 );
+    CHECK_EQ( shParallelChunkCount( 0, 3 ), 0 );
+    CHECK_EQ( shParallelChunkCount( 0xFFFFFFFF, 0x80000000 ), 2 );
+
+    last_error = SH_ERROR_OK;
+    CHECK_EQ( shParallelChunkCount( 10, 0 ), 0 );
+    CHECK_EQ( last_error, SH_ERROR_OUT_OF_RANGE );
+
+    // A job with a zero chunk size has no chunks to hand out
+    last_error = SH_ERROR_OK;
+    CHECK( !shParallelInit( &par, chunks, OBJECTS, 0 ) );
+    CHECK_EQ( last_error, SH_ERROR_OUT_OF_RANGE );
+    CHECK_EQ( par.chunk_count, 0 );
+}
+
+// Two workers take turns, so every other chunk is in the other buffer
+static void test_merge( void )
+{
+    const uint32 list_size[SH_CMDBUF_LISTS] = { sizeof(mem[0]) };
+    shcmdbuf_t cb[2];
+    shworker_t w[2];
+    shparallel_t par;
+    uint32 first, count, block[8], i, k = 0;
+    int words;
+
+    CHECK( shParallelInit( &par, chunks, OBJECTS, CHUNK_SIZE ) );
+
+    for ( i = 0; i < 2; i++ )
+    {
+        shCmdBufInit( &cb[i], mem[i], sizeof(mem[i]) );
+        CHECK( shCmdBufBeginFrame( &cb[i], list_size ) );
+        shParallelWorkerInit( &w[i], &par, &cb[i], NULL );
+    }
+
+    // One block per object, tagged with the object index
+    while ( shParallelNext( &w[k & 1], &first, &count ) )
+    {
+        for ( i = 0; i < count; i++ )
+        {
+            memset( block, 0, sizeof(block) );
+            block[0] = first + i;
+            shCmdBufWrite( &cb[k & 1], PVR_LIST_OP_POLY, block, 8 );
+        }
+        k++;
+    }
+
+    // Both workers have to finish their last chunk
+    CHECK( !shParallelNext( &w[0], &first, &count ) );
+    CHECK( !shParallelNext( &w[1], &first, &count ) );
+
+    words = shParallelMerge( &par, PVR_LIST_OP_POLY, merged );
+    CHECK_EQ( words, OBJECTS * 8 );
+    for ( i = 0; i < OBJECTS; i++ )
+        CHECK_EQ( merged[i * 8], i );
+
+    // A chunk that isn't whole blocks is refused, and nothing is written
+    par.chunks[1].size[PVR_LIST_OP_POLY] -= 3;
+    memset( merged, 0, sizeof(merged) );
+    last_error = SH_ERROR_OK;
+    CHECK_EQ( shParallelMerge( &par, PVR_LIST_OP_POLY, merged ), 0 );
+    CHECK_EQ( last_error, SH_ERROR_INVALID_SIZE );
+    CHECK_EQ( merged[0], 0 );
+    CHECK_EQ( merged[8], 0 );
+}
+
+int main( void )
+{
+    shErrorHandler( handler );
+
+    test_chunk_size();
+    test_merge();
+
+    return testResult( "test_parallel" );
+}
@@ -0,0 +1,224 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks the order shQueueFlush sends entries in. Every entry has one
+// vertex block tagged with its number, so the order can be read back from
+// the output.
+
+#include <stdint.h>
+#include <string.h>
+#include "shqueue.h"
+#include "shdefs.h"
+#include "test.h"
+
+#define MAX_ENTRIES	16
+
+static shqueue_entry_t entries[MAX_ENTRIES];
+static shqueue_entry_t scratch[MAX_ENTRIES];
+static uint32 verts[MAX_ENTRIES][8];
+static uint32 out[MAX_ENTRIES * 16] __attribute__((aligned(32)));
+static SHERROR last_error;
+
+static void handler( SHERROR err, const char* fnname )
+{
+    (void)fnname;
+    last_error = err;
+}
+
+// Textures are only ever addressed, so any address in video memory does
+static texture_t texture_at( uint32 address )
+{
+    texture_t tex = { 64, 64, TEXFMT_RGB565, TEXFLAG_TWIDDLED, (void*)(uintptr_t)address };
+    return tex;
+}
+
+static void push( shqueue_t* q, stripheader_t* hdr, uint32 tag )
+{
+    memset( verts[tag], 0, 32 );
+    verts[tag][0] = PCW_TYPE_VERTEX | PCW_END_OF_STRIP;
+    verts[tag][1] = tag;
+    CHECK( shQueuePush( q, hdr, verts[tag], 8 ) );
+}
+
+// Flushes the queue and reads back the tags of the vertex blocks in the
+// order they were sent. Returns the number of headers sent.
+static int flush( shqueue_t* q, uint32* order, uint32 expected )
+{
+    shemitter_t em;
+    uint32 n = 0;
+    int words, i, headers = 0;
+
+    shEmitterInit( &em );
+    words = shQueueFlush( q, &em, out );
+    CHECK_EQ( q->count, 0 );
+
+    for ( i = 0; i < words; i += 8 )
+    {
+        if ( ( out[i] & PCW_TYPE_MASK ) == PCW_TYPE_VERTEX )
+        {
+            if ( n < MAX_ENTRIES )
+                order[n] = out[i + 1];
+            n++;
+        }
+        else
+        {
+            headers++;
+        }
+    }
+
+    CHECK_EQ( n, expected );
+    return headers;
+}
+
+static void check_order( const uint32* order, const uint32* expected, uint32 count )
+{
+    uint32 i;
+
+    for ( i = 0; i < count; i++ )
+        CHECK_EQ( order[i], expected[i] );
+}
+
+static void init( stripheader_t* hdr, pvr_list_t list, const texture_t* tex, SHBLENDFUNC src, SHDEPTHFUNC depth )
+{
+    shInit( hdr, 3, list, tex, NULL );
+    shBlendFunc( hdr, src, SH_BLEND_ZERO );
+    shDepthFunc( hdr, depth );
+}
+
+// Opaque and punch-through entries sort by texture, then TSP, then ISP.
+// The source blend is in the top bits of the TSP word and the depth
+// compare in the top bits of the ISP/TSP word, so higher values of either
+// sort later.
+static void test_sort( void )
+{
+    static const uint32 expected[] = { 3, 5, 2, 1, 4, 0, 6 };
+    static const uint32 stable[] = { 0, 2, 3, 1 };
+    const texture_t low = texture_at( 0x10000 ), high = texture_at( 0x20000 );
+    stripheader_t hdr[7];
+    uint32 order[MAX_ENTRIES];
+    shqueue_t q;
+    int i;
+
+    init( &hdr[0], PVR_LIST_OP_POLY, &high, SH_BLEND_ONE,       SH_DEPTH_LESS );
+    init( &hdr[1], PVR_LIST_OP_POLY, &low,  SH_BLEND_DST_ALPHA, SH_DEPTH_LESS );
+    init( &hdr[2], PVR_LIST_OP_POLY, &low,  SH_BLEND_ONE,       SH_DEPTH_GREATER );
+    init( &hdr[3], PVR_LIST_OP_POLY, &low,  SH_BLEND_ONE,       SH_DEPTH_LESS );
+    init( &hdr[4], PVR_LIST_OP_POLY, &high, SH_BLEND_ZERO,      SH_DEPTH_ALWAYS );
+    init( &hdr[5], PVR_LIST_OP_POLY, &low,  SH_BLEND_ONE,       SH_DEPTH_LESS );	// Same as 3
+    init( &hdr[6], PVR_LIST_PT_POLY, &low,  SH_BLEND_ZERO,      SH_DEPTH_NEVER );
+
+    shQueueInit( &q, entries, scratch, MAX_ENTRIES );
+    for ( i = 0; i < 7; i++ )
+        push( &q, &hdr[i], i );
+
+    // 3 and 5 share one header
+    CHECK_EQ( flush( &q, order, 7 ), 6 );
+    check_order( order, expected, 7 );
+
+    // Equal keys keep the order they were pushed in, both ways round
+    push( &q, &hdr[5], 0 );
+    push( &q, &hdr[0], 1 );
+    push( &q, &hdr[3], 2 );
+    push( &q, &hdr[5], 3 );
+
+    CHECK_EQ( flush( &q, order, 4 ), 2 );
+    check_order( order, stable, 4 );
+}
+
+// Translucent and modifier entries are only grouped by list
+static void test_push_order( void )
+{
+    static const uint32 expected[] = { 2, 4, 0, 1, 3 };
+    const texture_t low = texture_at( 0x10000 ), high = texture_at( 0x20000 );
+    stripheader_t hdr[5];
+    uint32 order[MAX_ENTRIES];
+    shqueue_t q;
+    int i;
+
+    init( &hdr[0], PVR_LIST_TR_POLY, &high, SH_BLEND_SRC_ALPHA, SH_DEPTH_ALWAYS );
+    init( &hdr[1], PVR_LIST_TR_POLY, &low,  SH_BLEND_ZERO,      SH_DEPTH_NEVER );
+    shInit( &hdr[2], 17, PVR_LIST_OP_MOD, NULL, NULL );
+    shModifierInstruction( &hdr[2], SH_MODIFIER_INSIDE_LAST );
+    init( &hdr[3], PVR_LIST_TR_POLY, &high, SH_BLEND_ONE,       SH_DEPTH_LESS );
+    shInit( &hdr[4], 17, PVR_LIST_OP_MOD, NULL, NULL );
+
+    shQueueInit( &q, entries, scratch, MAX_ENTRIES );
+    for ( i = 0; i < 5; i++ )
+        push( &q, &hdr[i], i );
+
+    CHECK_EQ( flush( &q, order, 5 ), 5 );
+    check_order( order, expected, 5 );
+}
+
+// Entries sort by the state their header has when the queue is flushed
+static void test_changed_header( void )
+{
+    static const uint32 expected[] = { 0, 1 };
+    const texture_t lowest = texture_at( 0x8000 ), low = texture_at( 0x10000 ), high = texture_at( 0x20000 );
+    stripheader_t a, b;
+    uint32 order[MAX_ENTRIES];
+    shqueue_t q;
+
+    init( &a, PVR_LIST_OP_POLY, &high, SH_BLEND_ONE, SH_DEPTH_LESS );
+    init( &b, PVR_LIST_OP_POLY, &low, SH_BLEND_ONE, SH_DEPTH_LESS );
+
+    shQueueInit( &q, entries, scratch, MAX_ENTRIES );
+    push( &q, &a, 0 );
+    push( &q, &b, 1 );
+
+    // a would go last with the texture it was pushed with
+    shTexture( &a, &lowest );
+
+    CHECK_EQ( flush( &q, order, 2 ), 2 );
+    check_order( order, expected, 2 );
+
+    // And it's sent with the new texture
+    CHECK_EQ( out[3], a.words[TCW0] );
+}
+
+static void test_invalid_size( void )
+{
+    stripheader_t hdr;
+    shqueue_t q;
+
+    shInit( &hdr, 0, PVR_LIST_OP_POLY, NULL, NULL );
+    shQueueInit( &q, entries, scratch, 2 );
+
+    last_error = SH_ERROR_OK;
+    CHECK( !shQueuePush( &q, &hdr, verts[0], 12 ) );
+    CHECK_EQ( last_error, SH_ERROR_INVALID_SIZE );
+    CHECK_EQ( q.count, 0 );
+
+    // A full queue refuses pushes without an error
+    CHECK( shQueuePush( &q, &hdr, verts[0], 8 ) );
+    CHECK( shQueuePush( &q, &hdr, verts[1], 8 ) );
+    last_error = SH_ERROR_OK;
+    CHECK( !shQueuePush( &q, &hdr, verts[0], 8 ) );
+    CHECK_EQ( last_error, SH_ERROR_OK );
+    CHECK_EQ( q.count, 2 );
+}
+
+int main( void )
+{
+    shErrorHandler( handler );
+
+    test_sort();
+    test_push_order();
+    test_changed_header();
+    test_invalid_size();
+
+    return testResult( "test_queue" );
+}
@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks that shRingInit and shRingPush refuse what they can't handle,
+// and that blocks come out of the ring in the order they went in while a
+// producer and a consumer thread run at the same time.
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "shring.h"
+#include "test.h"
+
+#define CAPACITY	16
+#define PIECES		200000
+
+static uint32 mem[CAPACITY * 8] __attribute__((aligned(32)));
+static shring_t ring;
+static SHERROR last_error;
+
+static void handler( SHERROR err, const char* fnname )
+{
+    (void)fnname;
+    last_error = err;
+}
+
+static void test_init( void )
+{
+    static const uint32 bad[] = { 0, 3, 12, 17, 0x80000001 };
+    uint32 words[8] = { 0 };
+    uint32 i;
+
+    for ( i = 0; i < sizeof(bad) / sizeof(bad[0]); i++ )
+    {
+        last_error = SH_ERROR_OK;
+        CHECK( !shRingInit( &ring, mem, bad[i] ) );
+        CHECK_EQ( last_error, SH_ERROR_OUT_OF_RANGE );
+
+        // Nothing fits in a ring that failed to initialize
+        CHECK_EQ( shRingPush( &ring, words, 8 ), 0 );
+        CHECK_EQ( shRingPending( &ring ), 0 );
+    }
+
+    CHECK( shRingInit( &ring, mem, 1 ) );
+    CHECK( shRingInit( &ring, mem, CAPACITY ) );
+}
+
+static void test_push( void )
+{
+    static uint32 words[( CAPACITY + 1 ) * 8];
+    static uint32 out[( CAPACITY + 1 ) * 8];
+    stripheader_t hdr;
+    uint32 i;
+
+    for ( i = 0; i < sizeof(words) / 4; i++ )
+        words[i] = i;
+
+    shRingInit( &ring, mem, CAPACITY );
+
+    // Partial blocks are refused, not cut short
+    last_error = SH_ERROR_OK;
+    CHECK_EQ( shRingPush( &ring, words, 12 ), 0 );
+    CHECK_EQ( last_error, SH_ERROR_INVALID_SIZE );
+    CHECK_EQ( shRingPush( &ring, words, 7 ), 0 );
+    CHECK_EQ( shRingPending( &ring ), 0 );
+
+    // Headers go in whole, and report their size like shCommit
+    shInit( &hdr, 0, PVR_LIST_OP_POLY, NULL, NULL );
+    CHECK_EQ( shRingCommit( &ring, &hdr ), 8 );
+    shInit( &hdr, 10, PVR_LIST_OP_POLY, NULL, NULL );
+    CHECK_EQ( shRingCommit( &ring, &hdr ), 16 );
+    CHECK_EQ( shRingPending( &ring ), 24 );
+    CHECK_EQ( shRingDrain( &ring, out, sizeof(out) / 4 ), 24 );
+
+    // A push that doesn't fit is refused whole and counted
+    CHECK_EQ( shRingPush( &ring, words, ( CAPACITY + 1 ) * 8 ), 0 );
+    CHECK_EQ( ring.full, 1 );
+    CHECK_EQ( shRingPush( &ring, words, CAPACITY * 8 ), CAPACITY * 8 );
+    CHECK_EQ( shRingPush( &ring, words, 8 ), 0 );
+    CHECK_EQ( ring.full, 2 );
+
+    // Draining rounds down to whole blocks
+    CHECK_EQ( shRingDrain( &ring, out, 15 ), 8 );
+    CHECK_EQ( shRingDrain( &ring, out + 8, sizeof(out) / 4 ), ( CAPACITY - 1 ) * 8 );
+    CHECK( memcmp( out, words, CAPACITY * 32 ) == 0 );
+}
+
+// Pushes pieces of 1 to 4 blocks. Every block carries its piece number,
+// its place in the piece and the piece size.
+static void* produce( void* p )
+{
+    uint32 words[4 * 8];
+    uint32 n, i, size;
+
+    (void)p;
+
+    for ( n = 0; n < PIECES; n++ )
+    {
+        size = 1 + ( n * 7 ) % 4;
+
+        for ( i = 0; i < size; i++ )
+        {
+            memset( &words[i * 8], 0, 32 );
+            words[i * 8 + 0] = n;
+            words[i * 8 + 1] = i;
+            words[i * 8 + 2] = size;
+        }
+
+        while ( shRingPush( &ring, words, size * 8 ) == 0 )
+            sched_yield();
+    }
+
+    return NULL;
+}
+
+static void test_order( void )
+{
+    uint32 out[5 * 8];
+    uint32 piece = 0, part = 0, bad = 0;
+    pthread_t producer;
+    int words, i;
+
+    shRingInit( &ring, mem, CAPACITY );
+    CHECK_EQ( pthread_create( &producer, NULL, produce, NULL ), 0 );
+
+    // Drain in odd amounts so pieces are split across drains
+    while ( piece < PIECES )
+    {
+        words = shRingDrain( &ring, out, 5 * 8 );
+        if ( words == 0 )
+            sched_yield();
+
+        for ( i = 0; i < words; i += 8 )
+        {
+            const uint32 size = 1 + ( piece * 7 ) % 4;
+
+            if ( out[i] != piece || out[i + 1] != part || out[i + 2] != size )
+                bad++;
+
+            if ( ++part == size )
+            {
+                part = 0;
+                piece++;
+            }
+        }
+    }
+
+    pthread_join( producer, NULL );
+    CHECK_EQ( bad, 0 );
+    CHECK_EQ( shRingPending( &ring ), 0 );
+}
+
+int main( void )
+{
+    shErrorHandler( handler );
+
+    test_init();
+    test_push();
+    test_order();
+
+    return testResult( "test_ring" );
+}
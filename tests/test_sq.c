@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks the host recorder of the store queue writer: bursts are flushed in
+// order, alternating between the two store queues, and only when complete.
+
+#include <string.h>
+#include "shsq.h"
+#include "test.h"
+
+#define MAX_WORDS	256
+
+static uint32 dest[MAX_WORDS] __attribute__((aligned(32)));
+static uint32 expected[MAX_WORDS];
+static uint32 record[MAX_WORDS / 8 + 1];
+
+static void test_bursts( void )
+{
+    // Runs that start and end anywhere in a burst
+    static const int runs[] = { 1, 7, 9, 17 };
+    stripheader_t hdr8, hdr16;
+    uint32 words[32];
+    uint32 n = 0, bursts, i;
+    shsq_t sq;
+    int r;
+
+    shInit( &hdr8, 0, PVR_LIST_OP_POLY, NULL, NULL );
+    shInit( &hdr16, 10, PVR_LIST_OP_POLY, NULL, NULL );
+
+    memset( dest, 0xAA, sizeof(dest) );
+    memset( record, 0xBB, sizeof(record) );
+    shSqInit( &sq, dest );
+    shSqRecord( &sq, record, MAX_WORDS / 8 );
+
+    for ( r = 0; r < 4; r++ )
+    {
+        for ( i = 0; i < (uint32)runs[r]; i++ )
+            words[i] = 0x1000 * ( r + 1 ) + i;
+
+        shSqWrite( &sq, words, runs[r] );
+        memcpy( &expected[n], words, runs[r] * 4 );
+        n += runs[r];
+
+        // Nothing is flushed before a burst is complete
+        CHECK_EQ( sq.flushes, n / 8 );
+        CHECK_EQ( sq.fill, n % 8 );
+
+        // Headers in between, starting mid-burst
+        CHECK_EQ( shSqCommit( &sq, r & 1 ? &hdr16 : &hdr8 ), r & 1 ? 16 : 8 );
+        CHECK_EQ( shCommit( r & 1 ? &hdr16 : &hdr8, &expected[n] ), r & 1 ? 16 : 8 );
+        n += ( r & 1 ? 16 : 8 );
+        CHECK_EQ( sq.flushes, n / 8 );
+    }
+
+    // 34 words of runs and 48 of headers leave a partial burst
+    CHECK_EQ( n, 82 );
+    CHECK_EQ( sq.fill, 2 );
+
+    shSqFinish( &sq );
+    bursts = ( n + 7 ) / 8;
+    CHECK_EQ( sq.flushes, bursts );
+    CHECK_EQ( sq.fill, 0 );
+
+    // Finishing again with nothing pending doesn't flush anything
+    shSqFinish( &sq );
+    CHECK_EQ( sq.flushes, bursts );
+
+    // The words, zero padding in the last burst, and nothing after it
+    CHECK( memcmp( dest, expected, n * 4 ) == 0 );
+    for ( i = n; i < bursts * 8; i++ )
+        CHECK_EQ( dest[i], 0 );
+    CHECK_EQ( dest[bursts * 8], 0xAAAAAAAA );
+
+    // Every burst in order, and bit 5 of the address alternates the queue
+    for ( i = 0; i < bursts; i++ )
+    {
+        CHECK_EQ( record[i], i * 8 );
+        CHECK_EQ( ( ( record[i] * 4 ) >> 5 ) & 1, i & 1 );
+    }
+    CHECK_EQ( record[bursts], 0xBBBBBBBB );
+}
+
+// The record stops at its size, the flushes are still counted
+static void test_record_size( void )
+{
+    uint32 words[40];
+    shsq_t sq;
+
+    memset( words, 0, sizeof(words) );
+    memset( record, 0xBB, sizeof(record) );
+    shSqInit( &sq, dest );
+    shSqRecord( &sq, record, 3 );
+
+    shSqWrite( &sq, words, 40 );
+    CHECK_EQ( sq.flushes, 5 );
+    CHECK_EQ( record[0], 0 );
+    CHECK_EQ( record[1], 8 );
+    CHECK_EQ( record[2], 16 );
+    CHECK_EQ( record[3], 0xBBBBBBBB );
+
+    // Without a record nothing is logged
+    memset( record, 0xBB, sizeof(record) );
+    shSqInit( &sq, dest );
+    shSqWrite( &sq, words, 16 );
+    CHECK_EQ( sq.flushes, 2 );
+    CHECK_EQ( record[0], 0xBBBBBBBB );
+}
+
+int main( void )
+{
+    test_bursts();
+    test_record_size();
+
+    return testResult( "test_sq" );
+}
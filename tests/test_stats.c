@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks the SH_STATS counters, including the ones counted outside of
+// stripheader.c, and that no counts are lost when several threads commit
+// at once. Built against its own copy of the library with SH_STATS_TIMING
+// defined.
+
+#include <pthread.h>
+#include <string.h>
+#include "stripheader.h"
+#include "shmatpool.h"
+#include "test.h"
+
+static uint8 vram[4096] __attribute__((aligned(32)));
+static const texture_t tex = { 64, 64, TEXFMT_RGB565, TEXFLAG_TWIDDLED, vram };
+static uint32 out[16] __attribute__((aligned(32)));
+
+static void test_commits( void )
+{
+    // Every list the PCW list field can name, including the punch-through one
+    static const pvr_list_t lists[] = { PVR_LIST_OP_POLY, PVR_LIST_TR_POLY, PVR_LIST_PT_POLY };
+    stripheader_t hdr;
+    shstats_t stats;
+    uint32 i;
+
+    shResetStats();
+
+    for ( i = 0; i < sizeof(lists) / sizeof(lists[0]); i++ )
+    {
+        shInit( &hdr, 0, lists[i], NULL, NULL );
+        CHECK_EQ( shCommit( &hdr, out ), 8 );
+    }
+
+    shInit( &hdr, 17, PVR_LIST_TR_MOD, NULL, NULL );
+    shCommit( &hdr, out );
+
+    // Two volumes with intensity colors take 16 words
+    shInit( &hdr, 10, PVR_LIST_OP_POLY, NULL, NULL );
+    CHECK_EQ( shCommit( &hdr, out ), 16 );
+
+    shGetStats( &stats );
+    CHECK_EQ( stats.commits[0], 3 );
+    CHECK_EQ( stats.commits[10], 1 );
+    CHECK_EQ( stats.commits[17], 1 );
+    CHECK_EQ( stats.list_words[PVR_LIST_OP_POLY], 24 );
+    CHECK_EQ( stats.list_words[PVR_LIST_TR_POLY], 8 );
+    CHECK_EQ( stats.list_words[PVR_LIST_PT_POLY], 8 );
+    CHECK_EQ( stats.list_words[PVR_LIST_TR_MOD], 8 );
+    CHECK_EQ( stats.headers_8, 4 );
+    CHECK_EQ( stats.headers_16, 1 );
+    CHECK( stats.commit_cycles > 0 );
+}
+
+static void test_texture_binds( void )
+{
+    static uint8 mem[4096] __attribute__((aligned(32)));
+    shtexturedesc_t desc;
+    stripheader_t hdr;
+    shcompact_t c;
+    shmatpool_t pool;
+    shstats_t stats;
+    uint32 i;
+
+    CHECK( shMatPoolSize( 8 ) <= sizeof(mem) );
+    shMatPoolInit( &pool, mem, 8 );
+    shInit( &hdr, 3, PVR_LIST_OP_POLY, &tex, NULL );
+    shCompactFromHeader( &c, &hdr );
+    for ( i = 0; i < 8; i++ )
+        shMatPoolAdd( &pool, &c );
+
+    CHECK( shTextureDesc( &desc, &tex ) );
+
+    shResetStats();
+    CHECK( shTexture( &hdr, &tex ) );
+    CHECK( shTextureFromDesc( &hdr, &desc ) );
+    CHECK( shMatPoolTexture( &pool, 2, 5, &desc ) );
+
+    // Failed calls don't count as binds, but their errors do
+    CHECK( !shMatPoolTexture( &pool, 6, 5, &desc ) );
+
+    shGetStats( &stats );
+    CHECK_EQ( stats.texture_binds, 7 );
+    CHECK_EQ( stats.setter_calls, 3 );
+    CHECK_EQ( stats.errors[SH_ERROR_OUT_OF_RANGE], 1 );
+}
+
+#define THREADS		4
+#define COMMITS		20000
+
+static void* commit_worker( void* arg )
+{
+    static uint32 buffers[THREADS][16] __attribute__((aligned(32)));
+    uint32* const ptr = buffers[(uintptr_t)arg];
+    stripheader_t hdr;
+    uint32 i;
+
+    shInit( &hdr, 0, PVR_LIST_TR_POLY, NULL, NULL );
+    for ( i = 0; i < COMMITS; i++ )
+        shCommit( &hdr, ptr );
+
+    return NULL;
+}
+
+static void test_threads( void )
+{
+    pthread_t threads[THREADS];
+    shstats_t stats;
+    uintptr_t i;
+
+    shResetStats();
+
+    for ( i = 0; i < THREADS; i++ )
+        CHECK_EQ( pthread_create( &threads[i], NULL, commit_worker, (void*)i ), 0 );
+    for ( i = 0; i < THREADS; i++ )
+        pthread_join( threads[i], NULL );
+
+    shGetStats( &stats );
+    CHECK_EQ( stats.commits[0], THREADS * COMMITS );
+    CHECK_EQ( stats.list_words[PVR_LIST_TR_POLY], THREADS * COMMITS * 8 );
+    CHECK_EQ( stats.headers_8, THREADS * COMMITS );
+    CHECK_EQ( stats.setter_calls, 0 );
+}
+
+int main( void )
+{
+    test_commits();
+    test_texture_binds();
+    test_threads();
+
+    return testResult( "test_stats" );
+}
@@ -0,0 +1,292 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Decodes the user tile clip parameters written by shTileClip and
+// shTileClipRect, the clip mode shUserClip puts in the PCW, and object
+// list sets with the bounds from shTileBounds.
+
+#include <string.h>
+#include "stripheader.h"
+#include "shdefs.h"
+#include "test.h"
+
+static uint32 words[16] __attribute__((aligned(32)));
+static SHERROR last_error;
+
+static void handler( SHERROR err, const char* fnname )
+{
+    (void)fnname;
+    last_error = err;
+}
+
+// Checks that nothing was written and the range was reported
+static void check_rejected( int written )
+{
+    CHECK_EQ( written, 0 );
+    CHECK_EQ( last_error, SH_ERROR_OUT_OF_RANGE );
+    CHECK_EQ( words[0], 0xEFEFEFEF );
+    CHECK_EQ( words[8], 0xDEADBEEF );
+    last_error = SH_ERROR_OK;
+}
+
+// Checks one tile clip block: the PCW type, three unused words and the area
+static void check_clip( int written, uint32 x_min, uint32 y_min, uint32 x_max, uint32 y_max )
+{
+    CHECK_EQ( written, 8 );
+    CHECK_EQ( words[0] & PCW_TYPE_MASK, PCW_TYPE_USER_TILE_CLIP );
+    CHECK_EQ( words[0] & ~PCW_TYPE_MASK, 0 );
+    CHECK_EQ( words[1], 0 );
+    CHECK_EQ( words[2], 0 );
+    CHECK_EQ( words[3], 0 );
+    CHECK_EQ( words[4], x_min );
+    CHECK_EQ( words[5], y_min );
+    CHECK_EQ( words[6], x_max );
+    CHECK_EQ( words[7], y_max );
+
+    // Nothing past the block
+    CHECK_EQ( words[8], 0xDEADBEEF );
+}
+
+static int clip( uint32 x_min, uint32 y_min, uint32 x_max, uint32 y_max )
+{
+    memset( words, 0xEF, sizeof(words) );
+    words[8] = 0xDEADBEEF;
+    return shTileClip( words, x_min, y_min, x_max, y_max );
+}
+
+static int clip_rect( uint32 x, uint32 y, uint32 width, uint32 height )
+{
+    memset( words, 0xEF, sizeof(words) );
+    words[8] = 0xDEADBEEF;
+    return shTileClipRect( words, x, y, width, height );
+}
+
+static void test_tile_clip( void )
+{
+    check_clip( clip( 0, 0, 19, 14 ), 0, 0, 19, 14 );
+    check_clip( clip( 3, 5, 3, 5 ), 3, 5, 3, 5 );
+
+    // The largest coordinates the fields hold
+    check_clip( clip( 0, 0, 63, 15 ), 0, 0, 63, 15 );
+
+    // Past the fields, or min past max
+    check_rejected( clip( 0, 0, 64, 14 ) );
+    check_rejected( clip( 0, 0, 19, 16 ) );
+    check_rejected( clip( 64, 0, 64, 14 ) );
+    check_rejected( clip( 0, 0, 0xFFFFFFFF, 0xFFFFFFFF ) );
+    check_rejected( clip( 5, 0, 4, 14 ) );
+    check_rejected( clip( 0, 5, 19, 4 ) );
+    CHECK_EQ( last_error, SH_ERROR_OK );
+}
+
+static void test_tile_clip_rect( void )
+{
+    // Full 640x480 screen
+    check_clip( clip_rect( 0, 0, 640, 480 ), 0, 0, 19, 14 );
+
+    // Tile aligned right half of the screen
+    check_clip( clip_rect( 320, 0, 320, 480 ), 10, 0, 19, 14 );
+
+    // Unaligned edges grow to cover the tiles they touch
+    check_clip( clip_rect( 31, 33, 2, 31 ), 0, 1, 1, 1 );
+    check_clip( clip_rect( 100, 200, 1, 1 ), 3, 6, 3, 6 );
+
+    // An empty rectangle covers the tile it starts in
+    check_clip( clip_rect( 64, 96, 0, 0 ), 2, 3, 2, 3 );
+
+    // Rectangles running past the last tile are cut off, even when the
+    // far edge doesn't fit in 32 bits
+    check_clip( clip_rect( 0, 0, 0xFFFFFFFF, 0xFFFFFFFF ), 0, 0, 63, 15 );
+    check_clip( clip_rect( 1000, 100, 0xFFFFFFFF, 0x80000000 ), 31, 3, 63, 15 );
+    check_clip( clip_rect( 2047, 511, 2, 2 ), 63, 15, 63, 15 );
+    check_clip( clip_rect( 0, 0, 4096, 1024 ), 0, 0, 63, 15 );
+
+    // Rectangles starting past the last tile are rejected
+    check_rejected( clip_rect( 2048, 0, 32, 32 ) );
+    check_rejected( clip_rect( 0, 512, 32, 32 ) );
+    check_rejected( clip_rect( 0xFFFFFFF0, 0xFFFFFFF0, 0x20, 0x20 ) );
+}
+
+static uint32 committed_clip( const stripheader_t* hdr )
+{
+    stripheader_t copy = *hdr;
+
+    memset( words, 0, sizeof(words) );
+    shCommit( &copy, words );
+    return words[0] & PCW_USER_CLIP_MASK;
+}
+
+static void test_user_clip( void )
+{
+    static const SHUSERCLIP modes[] = { SH_CLIP_INSIDE, SH_CLIP_OUTSIDE, SH_CLIP_DISABLE };
+    stripheader_t hdr;
+    SHSTATE state;
+    uint32 i;
+
+    memset( &state, 0, sizeof(state) );
+    state.flags = SH_STATE_USER_CLIP;
+
+    shInit( &hdr, 0, PVR_LIST_OP_POLY, NULL, NULL );
+    CHECK_EQ( committed_clip( &hdr ), PCW_USER_CLIP_DISABLE );
+
+    for ( i = 0; i < sizeof(modes) / sizeof(modes[0]); i++ )
+    {
+        const uint32 list = words[0] & PCW_LIST_MASK;
+
+        CHECK( shUserClip( &hdr, modes[i] ) );
+        CHECK_EQ( committed_clip( &hdr ), (uint32)modes[i] << PCW_USER_CLIP_SHIFT );
+
+        // The rest of the PCW is left alone
+        CHECK_EQ( words[0] & PCW_TYPE_MASK, PCW_TYPE_POLYGON );
+        CHECK_EQ( words[0] & PCW_LIST_MASK, list );
+
+        state.clip = modes[( i + 1 ) % 3];
+        CHECK( shSetState( &hdr, &state ) );
+        CHECK_EQ( committed_clip( &hdr ), (uint32)state.clip << PCW_USER_CLIP_SHIFT );
+    }
+
+    // Modifier volumes are clipped too
+    shInit( &hdr, 17, PVR_LIST_OP_MOD, NULL, NULL );
+    CHECK( shUserClip( &hdr, SH_CLIP_OUTSIDE ) );
+    CHECK_EQ( committed_clip( &hdr ), PCW_USER_CLIP_OUTSIDE );
+    CHECK_EQ( words[0] & PCW_TYPE_MASK, PCW_TYPE_MODIFIER );
+}
+
+static int bounds_of( shtilebounds_t* b, const float* xy, uint32 count )
+{
+    memset( b, 0xEE, sizeof(*b) );
+    return shTileBounds( b, xy, 2 * sizeof(float), count, 20, 15 );
+}
+
+static void check_bounds( const shtilebounds_t* b, uint32 x_min, uint32 y_min, uint32 x_max, uint32 y_max )
+{
+    CHECK_EQ( b->x_min, x_min );
+    CHECK_EQ( b->y_min, y_min );
+    CHECK_EQ( b->x_max, x_max );
+    CHECK_EQ( b->y_max, y_max );
+}
+
+static void test_tile_bounds( void )
+{
+    static const float inside[] = { 40, 70, 100, 35, 63, 95 };
+    static const float left_top[] = { -500, -10, 31, 33 };
+    static const float right_bottom[] = { 600, 470, 9000, 1e30f };
+    static const float off_left[] = { -100, 10, -0.5f, 400 };
+    static const float off_right[] = { 640, 10, 700, 400 };
+    static const float off_top[] = { 10, -40, 300, -1 };
+    static const float off_bottom[] = { 10, 480, 300, 500 };
+    const float nan = __builtin_nanf( "" );
+    const float with_nan[] = { nan, 100, 50, nan, 200, 300, 70, 40, nan, nan };
+    const float all_nan[] = { nan, 0, 0, nan };
+    shtilebounds_t b;
+
+    // Vertices 32 or more pixels apart cover the tiles between them
+    CHECK( bounds_of( &b, inside, 3 ) );
+    check_bounds( &b, 1, 1, 3, 2 );
+
+    // Clamped at each edge
+    CHECK( bounds_of( &b, left_top, 2 ) );
+    check_bounds( &b, 0, 0, 0, 1 );
+    CHECK( bounds_of( &b, right_bottom, 2 ) );
+    check_bounds( &b, 18, 14, 19, 14 );
+
+    // Fully off screen on each side, or nothing at all
+    CHECK( !bounds_of( &b, off_left, 2 ) );
+    CHECK( !bounds_of( &b, off_right, 2 ) );
+    CHECK( !bounds_of( &b, off_top, 2 ) );
+    CHECK( !bounds_of( &b, off_bottom, 2 ) );
+    CHECK( !bounds_of( &b, inside, 0 ) );
+    CHECK( !shTileBounds( &b, inside, 8, 3, 0, 15 ) );
+
+    // Vertices with a NaN are skipped, even the first one
+    CHECK( bounds_of( &b, with_nan, 5 ) );
+    check_bounds( &b, 2, 1, 6, 9 );
+    CHECK( !bounds_of( &b, all_nan, 2 ) );
+}
+
+// Vertices spread out in a larger structure, and a smaller screen
+static void test_tile_bounds_stride( void )
+{
+    static const float verts[3][5] =
+    {
+        { 64, 64, 1, 2, 3 },
+        { 300, 20, -1000, -1000, -1000 },
+        { 150, 250, 1000, 1000, 1000 }
+    };
+    shtilebounds_t b;
+
+    memset( &b, 0xEE, sizeof(b) );
+    CHECK( shTileBounds( &b, verts[0], sizeof(verts[0]), 3, 20, 15 ) );
+    check_bounds( &b, 2, 0, 9, 7 );
+
+    // Clamped to the smaller screen
+    memset( &b, 0xEE, sizeof(b) );
+    CHECK( shTileBounds( &b, verts[0], sizeof(verts[0]), 2, 8, 4 ) );
+    check_bounds( &b, 2, 0, 7, 2 );
+}
+
+static void test_object_list_set( void )
+{
+    static const pvr_list_t lists[] = { PVR_LIST_OP_POLY, PVR_LIST_OP_MOD, PVR_LIST_TR_POLY, PVR_LIST_TR_MOD, PVR_LIST_PT_POLY };
+    shtilebounds_t b;
+    uint32 i;
+
+    b.x_min = 3;
+    b.y_min = 4;
+    b.x_max = 17;
+    b.y_max = 12;
+
+    for ( i = 0; i < sizeof(lists) / sizeof(lists[0]); i++ )
+    {
+        memset( words, 0xEF, sizeof(words) );
+        words[8] = 0xDEADBEEF;
+
+        CHECK_EQ( shObjectListSet( words, lists[i], 0x1234560 + i, &b ), 8 );
+        CHECK_EQ( words[0] & PCW_TYPE_MASK, PCW_TYPE_OBJECT_LIST_SET );
+        CHECK_EQ( ( words[0] & PCW_LIST_MASK ) >> PCW_LIST_SHIFT, lists[i] );
+        CHECK_EQ( words[0] & ~( PCW_TYPE_MASK | PCW_LIST_MASK ), 0 );
+        CHECK_EQ( words[1], 0x1234560 + i );
+        CHECK_EQ( words[2], 0 );
+        CHECK_EQ( words[3], 0 );
+        CHECK_EQ( words[4], 3 );
+        CHECK_EQ( words[5], 4 );
+        CHECK_EQ( words[6], 17 );
+        CHECK_EQ( words[7], 12 );
+        CHECK_EQ( words[8], 0xDEADBEEF );
+    }
+
+    // Lists that don't fit in the PCW field are rejected
+    memset( words, 0xEF, sizeof(words) );
+    CHECK_EQ( shObjectListSet( words, (pvr_list_t)5, 0, &b ), 0 );
+    CHECK_EQ( last_error, SH_ERROR_INVALID_LIST );
+    CHECK_EQ( shObjectListSet( words, (pvr_list_t)0x100, 0, &b ), 0 );
+    CHECK_EQ( words[0], 0xEFEFEFEF );
+    last_error = SH_ERROR_OK;
+}
+
+int main( void )
+{
+    shErrorHandler( handler );
+
+    test_tile_clip();
+    test_tile_clip_rect();
+    test_user_clip();
+    test_tile_bounds();
+    test_tile_bounds_stride();
+    test_object_list_set();
+
+    return testResult( "test_tileclip" );
+}
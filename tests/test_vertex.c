@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks that every vertex writer accepts exactly the types of its color
+// class, and reports the others without writing anything.
+
+#include <string.h>
+#include "shvertex.h"
+#include "test.h"
+
+static uint32 out[64] __attribute__((aligned(32)));
+static SHERROR last_error;
+static uint32 errors;
+
+static void handler( SHERROR err, const char* fnname )
+{
+    (void)fnname;
+    last_error = err;
+    errors++;
+}
+
+static shvertexpacked_t packed[2];
+static shvertexfloat_t floats[2];
+static shvertexintensity_t intensity[2];
+static shvertexpacked2_t packed2[2];
+static shvertexintensity2_t intensity2[2];
+static shsprite_t sprites[2];
+
+// Calls writer w for a type, returning the words written
+static int write_vertices( int w, uint32 type )
+{
+    switch ( w )
+    {
+        case 0:		return shVertexPacked( out, type, &packed[0], 1 );
+        case 1:		return shVertexFloat( out, type, &floats[0], 1 );
+        case 2:		return shVertexIntensity( out, type, &intensity[0], 1 );
+        case 3:		return shVertexPacked2( out, type, &packed2[0], 1 );
+        case 4:		return shVertexIntensity2( out, type, &intensity2[0], 1 );
+        case 5:		return shSprite( out, type, &sprites[0] );
+        case 6:		return shStripPacked( out, type, packed, 2 );
+        case 7:		return shStripFloat( out, type, floats, 2 );
+        case 8:		return shStripIntensity( out, type, intensity, 2 );
+        case 9:		return shStripPacked2( out, type, packed2, 2 );
+        case 10:	return shStripIntensity2( out, type, intensity2, 2 );
+        case 11:	return shSprites( out, type, sprites, 2 );
+    }
+
+    return -1;
+}
+
+static void test_types( void )
+{
+    // Types taken by each writer, single and strip writers alike
+    static const uint32 classes[6] =
+    {
+        ( 1 << 0 ) | ( 1 << 3 ) | ( 1 << 4 ),
+        ( 1 << 1 ) | ( 1 << 5 ) | ( 1 << 6 ),
+        ( 1 << 2 ) | ( 1 << 7 ) | ( 1 << 8 ),
+        ( 1 << 9 ) | ( 1 << 11 ) | ( 1 << 12 ),
+        ( 1 << 10 ) | ( 1 << 13 ) | ( 1 << 14 ),
+        ( 1 << 15 ) | ( 1 << 16 ),
+    };
+    uint32 type;
+    int w, n;
+
+    for ( w = 0; w < 12; w++ )
+    for ( type = 0; type < 19; type++ )
+    {
+        const int allowed = ( classes[w % 6] >> type ) & 1;
+
+        memset( out, 0xAA, sizeof(out) );
+        errors = 0;
+        last_error = SH_ERROR_OK;
+
+        n = write_vertices( w, type );
+
+        if ( allowed )
+        {
+            CHECK( n > 0 );
+            CHECK_EQ( errors, 0 );
+        }
+        else
+        {
+            CHECK_EQ( n, 0 );
+            CHECK_EQ( errors, 1 );
+            CHECK_EQ( last_error, SH_ERROR_NOT_ALLOWED );
+            CHECK_EQ( out[0], 0xAAAAAAAA );
+        }
+    }
+}
+
+int main( void )
+{
+    shErrorHandler( handler );
+
+    test_types();
+
+    return testResult( "test_vertex" );
+}
@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////
+//      _____ _____ __    _____ _____    ___   ___       //
+//     |   __|  |  |  |  |     | __  |  |_  | |   |      //
+//     |__   |     |  |__|-   -| __ -|  |  _|_| | |      //
+//     |_____|__|__|_____|_____|_____|  |___|_|___|      //
+//                                                       //
+///////////////////////////////////////////////////////////
+// Strip header library 2.0                              //
+//                                                       //
+// This library is used to generate and update strip     //
+// headers for use with the SEGA Dreamcast hardware in   //
+// an OpenGL-like manner.                                //
+//                                                       //
+// Author: Anton Norgren (Tvspelsfreak) (2011)           //
+///////////////////////////////////////////////////////////
+
+// Checks where the volume builder puts its headers: one normal header before
+// all triangles but the last, and the last header right before the final
+// triangle of every volume.
+
+#include <string.h>
+#include "shvolume.h"
+#include "shdefs.h"
+#include "test.h"
+
+#define MAX_WORDS	512
+#define NORMAL		-1
+#define LAST		-2
+
+static uint32 out[MAX_WORDS] __attribute__((aligned(32)));
+static int tokens[MAX_WORDS / 8];
+static SHERROR last_error;
+
+static void handler( SHERROR err, const char* fnname )
+{
+    (void)fnname;
+    last_error = err;
+}
+
+// Triangles are tagged with their number in ax
+static void make_triangles( shmodtriangle_t* t, int count, int first )
+{
+    int i;
+
+    memset( t, 0, count * sizeof(*t) );
+    for ( i = 0; i < count; i++ )
+        t[i].ax = (float)( first + i );
+}
+
+// Reads back the output as a list of headers (NORMAL or LAST) and triangle
+// tags. Checks the instruction of every last header.
+static int parse( const uint32* end, uint32 instr )
+{
+    const uint32* p = out;
+    int n = 0;
+    float f;
+
+    while ( p < end )
+    {
+        if ( ( p[PCW] & PCW_TYPE_MASK ) == PCW_TYPE_VERTEX )
+        {
+            memcpy( &f, &p[1], sizeof(f) );
+            tokens[n++] = (int)f;
+            p += 16;
+        }
+        else if ( p[PCW] & PCW_MODIFIER_TRIANGLE_LAST )
+        {
+            CHECK_EQ( p[ISPTSP] >> ISP_TSP_VOLUME_INSTRUCTION_SHIFT, instr );
+            tokens[n++] = LAST;
+            p += 8;
+        }
+        else
+        {
+            CHECK_EQ( p[ISPTSP] >> ISP_TSP_VOLUME_INSTRUCTION_SHIFT, SH_MODIFIER_NORMAL );
+            tokens[n++] = NORMAL;
+            p += 8;
+        }
+    }
+
+    CHECK( p == end );
+    return n;
+}
+
+static void check_tokens( int n, const int* expected, int expected_count )
+{
+    int i;
+
+    CHECK_EQ( n, expected_count );
+    for ( i = 0; i < n && i < expected_count; i++ )
+        CHECK_EQ( tokens[i], expected[i] );
+}
+
+static void test_triangles( void )
+{
+    // Volumes of 3, 1, 1 and 2 triangles back to back
+    static const int counts[] = { 3, 1, 1, 2 };
+    static const int expected[] =
+    {
+        NORMAL, 0, 1, LAST, 2,
+        LAST, 3,
+        LAST, 4,
+        NORMAL, 5, LAST, 6
+    };
+    shmodtriangle_t t[7];
+    shvolumebuilder_t vb;
+    int i, first = 0, words = 0;
+
+    make_triangles( t, 7, 0 );
+    CHECK( shVolumeBegin( &vb, out, PVR_LIST_OP_MOD, SH_MODIFIER_INSIDE_LAST ) );
+
+    for ( i = 0; i < 4; i++ )
+    {
+        words += shVolumeTriangles( &vb, &t[first], counts[i] );
+        first += counts[i];
+    }
+
+    // Empty volumes write nothing
+    CHECK_EQ( shVolumeTriangles( &vb, t, 0 ), 0 );
+
+    CHECK( shVolumeEnd( &vb ) == out + words );
+    CHECK_EQ( words, 6 * 8 + 7 * 16 );
+    check_tokens( parse( shVolumeEnd( &vb ), SH_MODIFIER_INSIDE_LAST ), expected, 13 );
+
+    CHECK_EQ( vb.volumes, 4 );
+    CHECK_EQ( vb.triangles, 7 );
+    CHECK_EQ( vb.headers, 6 );
+}
+
+static void test_indexed( void )
+{
+    // Three vertices are enough, the tag is the index of the first one
+    static const float xyz[] = { 0, 0, 0, 1, 0, 0, 2, 0, 0, 3, 0, 0 };
+    static const uint16 indices[] = { 0, 1, 2, 1, 2, 3, 2, 3, 0, 3, 0, 1 };
+    static const int expected[] =
+    {
+        LAST, 0,
+        NORMAL, 0, 1, 2, LAST, 3,
+        LAST, 2
+    };
+    shvolumebuilder_t vb;
+
+    CHECK( shVolumeBegin( &vb, out, PVR_LIST_TR_MOD, SH_MODIFIER_OUTSIDE_LAST ) );
+    CHECK_EQ( shVolumeIndexed( &vb, xyz, indices, 1 ), 8 + 16 );
+    CHECK_EQ( shVolumeIndexed( &vb, xyz, indices, 4 ), 16 + 4 * 16 );
+    CHECK_EQ( shVolumeIndexed( &vb, xyz, &indices[6], 1 ), 8 + 16 );
+    CHECK_EQ( shVolumeIndexed( &vb, xyz, indices, 0 ), 0 );
+
+    check_tokens( parse( shVolumeEnd( &vb ), SH_MODIFIER_OUTSIDE_LAST ), expected, 10 );
+
+    CHECK_EQ( vb.volumes, 3 );
+    CHECK_EQ( vb.triangles, 6 );
+    CHECK_EQ( vb.headers, 4 );
+}
+
+static void test_instruction( void )
+{
+    shvolumebuilder_t vb;
+    shmodtriangle_t t;
+    shblock_t block;
+
+    shErrorHandler( handler );
+
+    // The last header can't use the normal instruction
+    last_error = SH_ERROR_OK;
+    CHECK( !shVolumeBegin( &vb, out, PVR_LIST_OP_MOD, SH_MODIFIER_NORMAL ) );
+    CHECK_EQ( last_error, SH_ERROR_INVALID_PARAMETER );
+
+    CHECK( shVolumeBegin( &vb, out, PVR_LIST_OP_MOD, SH_MODIFIER_INSIDE_LAST ) );
+    block = vb.last_block;
+
+    // A rejected instruction leaves the last header as it was
+    last_error = SH_ERROR_OK;
+    CHECK( !shVolumeInstruction( &vb, SH_MODIFIER_NORMAL ) );
+    CHECK_EQ( last_error, SH_ERROR_INVALID_PARAMETER );
+    CHECK( memcmp( &block, &vb.last_block, sizeof(block) ) == 0 );
+
+    // Switching between volumes only changes the following ones
+    make_triangles( &t, 1, 0 );
+    shVolumeTriangles( &vb, &t, 1 );
+    CHECK( shVolumeInstruction( &vb, SH_MODIFIER_OUTSIDE_LAST ) );
+    shVolumeTriangles( &vb, &t, 1 );
+    CHECK_EQ( out[ISPTSP] >> ISP_TSP_VOLUME_INSTRUCTION_SHIFT, SH_MODIFIER_INSIDE_LAST );
+    CHECK_EQ( out[24 + ISPTSP] >> ISP_TSP_VOLUME_INSTRUCTION_SHIFT, SH_MODIFIER_OUTSIDE_LAST );
+}
+
+int main( void )
+{
+    test_triangles();
+    test_indexed();
+    test_instruction();
+
+    return testResult( "test_volume" );
+}